@@ -0,0 +1,52 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Minimal timing for the benchmark executables: run a body for a fixed
+// number of iterations a few times and report the best time per iteration,
+// which is the least disturbed by the scheduler
+namespace htk::bench {
+
+    // Keeps a result alive so the compiler can't drop the work behind it
+    template <typename T>
+    inline void keep(const T& value) {
+#ifdef _MSC_VER
+        static const void* volatile sink;
+        sink = &value;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+
+    template <typename Body>
+    double nanosPerIteration(uint64_t iterations, Body&& body, int repeats = 5) {
+        double best = 0.0;
+        for (int r = 0; r < repeats; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < iterations; ++i) {
+                body(i);
+            }
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            const double perIteration = elapsed.count() / static_cast<double>(iterations);
+            if (r == 0 || perIteration < best) {
+                best = perIteration;
+            }
+        }
+        return best;
+    }
+
+    inline void report(const char* name, double nanos) {
+        std::printf("%-40s %9.1f ns\n", name, nanos);
+    }
+
+} // namespace htk::bench
+
+#endif // BENCH_H
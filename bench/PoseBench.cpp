@@ -0,0 +1,331 @@
+// htk-pose-bench: per-frame cost of the quaternion pose pipeline (Pose,
+// PoseFusion) against the per-axis Euler code it replaced, stage by stage
+// for a two-camera setup, then whole frames for one and two cameras. The
+// Euler reference is reproduced here as it was, measuring angles from rays
+// the way the tracker does now.
+
+#include "Bench.h"
+
+#include "core/Pose.h"
+#include "core/PoseFusion.h"
+#include "core/TrackingData.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using htk::core::CameraEstimate;
+using htk::core::Pose;
+using htk::core::PoseFusion;
+using htk::core::TrackingData;
+
+namespace {
+
+constexpr uint64_t kIterations = 2000000;
+constexpr size_t kSamples = 1024;  // Power of two
+constexpr float kBlend = 0.5f;
+constexpr float kTravel = 0.02f;
+constexpr float kDegToRad = 3.14159265359f / 180.0f;
+
+// Second camera mounted off to the side, looking slightly down
+constexpr float kMountYaw = 30.0f;
+constexpr float kMountPitch = -10.0f;
+
+// What the tracker measures per camera: the face ray's slopes and the
+// eye vector. Both pipelines start here, as the tracker does: per-axis
+// code needs the angles (atan, as WebcamTracker computed them), the
+// quaternion pipeline builds its rotation straight from the directions.
+struct Measurement {
+    Eigen::Vector2f yaw, pitch, roll;
+    Eigen::Vector3f translation;
+    float confidence;
+};
+
+// Euler reference
+
+TrackingData eulerMeasure(const Measurement& m) {
+    TrackingData data;
+    data.yaw   = std::atan(m.yaw.y()) / kDegToRad;
+    data.pitch = std::atan(m.pitch.y()) / kDegToRad;
+    data.roll  = std::atan2(m.roll.y(), m.roll.x()) / kDegToRad;
+    data.x = m.translation.x();
+    data.y = m.translation.y();
+    data.z = m.translation.z();
+    data.confidence = m.confidence;
+    data.isValid = true;
+    return data;
+}
+
+void eulerSmooth(TrackingData& pose, const TrackingData& detected) {
+    pose.yaw   = pose.yaw   * kBlend + detected.yaw   * (1.0f - kBlend);
+    pose.pitch = pose.pitch * kBlend + detected.pitch * (1.0f - kBlend);
+    pose.roll  = pose.roll  * kBlend + detected.roll  * (1.0f - kBlend);
+    pose.x     = pose.x     * kBlend + detected.x     * (1.0f - kBlend);
+    pose.y     = pose.y     * kBlend + detected.y     * (1.0f - kBlend);
+    pose.z     = pose.z     * kBlend + detected.z     * (1.0f - kBlend);
+}
+
+void eulerCoast(TrackingData& pose, const TrackingData& detected, const float velocity[6]) {
+    pose.yaw   = detected.yaw   + velocity[0] * kTravel;
+    pose.pitch = detected.pitch + velocity[1] * kTravel;
+    pose.roll  = detected.roll  + velocity[2] * kTravel;
+    pose.x     = detected.x     + velocity[3] * kTravel;
+    pose.y     = detected.y     + velocity[4] * kTravel;
+    pose.z     = detected.z     + velocity[5] * kTravel;
+}
+
+TrackingData eulerToPrimaryFrame(const TrackingData& data, float mountYaw, float mountPitch) {
+    TrackingData result = data;
+    if (mountYaw == 0.0f && mountPitch == 0.0f) {
+        return result;
+    }
+
+    result.yaw   += mountYaw;
+    result.pitch += mountPitch;
+
+    const float cy = std::cos(mountYaw * kDegToRad);
+    const float sy = std::sin(mountYaw * kDegToRad);
+    const float x  =  cy * result.x + sy * result.z;
+    const float z1 = -sy * result.x + cy * result.z;
+
+    const float cp = std::cos(mountPitch * kDegToRad);
+    const float sp = std::sin(mountPitch * kDegToRad);
+    result.x = x;
+    result.y = cp * result.y - sp * z1;
+    result.z = sp * result.y + cp * z1;
+    return result;
+}
+
+TrackingData eulerFuse(const TrackingData* data, const float* mountYaw, const float* mountPitch, size_t count) {
+    // The mounts are runtime settings in the tracker: don't let the
+    // compiler fold their cos/sin into constants here
+    htk::bench::keep(mountYaw);
+    htk::bench::keep(mountPitch);
+
+    TrackingData result;
+    float totalWeight = 0.0f;
+    float sum[6] = {0, 0, 0, 0, 0, 0};
+
+    for (size_t i = 0; i < count; ++i) {
+        if (!data[i].isValid || data[i].confidence <= 0.0f) {
+            continue;
+        }
+        const TrackingData primary = eulerToPrimaryFrame(data[i], mountYaw[i], mountPitch[i]);
+        const float w = data[i].confidence;
+        sum[0] += w * primary.yaw;
+        sum[1] += w * primary.pitch;
+        sum[2] += w * primary.roll;
+        sum[3] += w * primary.x;
+        sum[4] += w * primary.y;
+        sum[5] += w * primary.z;
+        totalWeight += w;
+    }
+
+    const float inv = 1.0f / totalWeight;
+    result.yaw   = sum[0] * inv;
+    result.pitch = sum[1] * inv;
+    result.roll  = sum[2] * inv;
+    result.x     = sum[3] * inv;
+    result.y     = sum[4] * inv;
+    result.z     = sum[5] * inv;
+    result.isValid = true;
+    return result;
+}
+
+TrackingData eulerCenter(const TrackingData& data, const TrackingData& center) {
+    TrackingData result = data;
+    result.yaw   -= center.yaw;
+    result.pitch -= center.pitch;
+    result.roll  -= center.roll;
+    result.x     -= center.x;
+    result.y     -= center.y;
+    result.z     -= center.z;
+    return result;
+}
+
+// Quaternion pipeline, as WebcamTracker and HeadTracker run it
+
+void poseSmooth(Pose& pose, const Measurement& detected) {
+    const Eigen::Quaternionf rotation = htk::core::rotationFromDirections(detected.yaw, detected.pitch, detected.roll);
+    pose.rotation = htk::core::blendRotation(pose.rotation, rotation, 1.0f - kBlend);
+    pose.translation += (1.0f - kBlend) * (detected.translation - pose.translation);
+}
+
+void poseCoast(Pose& pose, const Pose& detected, const Eigen::Vector3f& angular, const Eigen::Vector3f& linear) {
+    pose.rotation    = htk::core::multiply(htk::core::rotationStep(angular * kTravel), detected.rotation);
+    pose.translation = detected.translation + linear * kTravel;
+}
+
+Pose poseCenter(const Pose& pose, const Pose& center) {
+    Pose result = pose;
+    result.rotation    = htk::core::multiply(center.rotation.conjugate(), pose.rotation);
+    result.translation = pose.translation - center.translation;
+    return result;
+}
+
+// Detections for both cameras, moving through large combined angles
+std::vector<TrackingData> makeSamples(float phase) {
+    std::vector<TrackingData> samples(kSamples);
+    for (size_t i = 0; i < kSamples; ++i) {
+        const float t = static_cast<float>(i) * 0.05f + phase;
+        TrackingData& data = samples[i];
+        data.yaw   = 60.0f * std::sin(t);
+        data.pitch = 30.0f * std::sin(0.7f * t);
+        data.roll  = 15.0f * std::sin(1.3f * t);
+        data.x = 40.0f * std::sin(0.5f * t);
+        data.y = 20.0f * std::cos(0.4f * t);
+        data.z = 600.0f + 50.0f * std::sin(0.3f * t);
+        data.confidence = 0.6f + 0.3f * std::sin(0.9f * t) * std::sin(0.9f * t);
+        data.isValid = true;
+    }
+    return samples;
+}
+
+std::vector<Measurement> makeMeasurements(const std::vector<TrackingData>& samples) {
+    std::vector<Measurement> measurements(samples.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const TrackingData& data = samples[i];
+        Measurement& m = measurements[i];
+        m.yaw   = Eigen::Vector2f(1.0f, std::tan(data.yaw * kDegToRad));
+        m.pitch = Eigen::Vector2f(1.0f, std::tan(data.pitch * kDegToRad));
+        m.roll  = 40.0f * Eigen::Vector2f(std::cos(data.roll * kDegToRad), std::sin(data.roll * kDegToRad));
+        m.translation = Eigen::Vector3f(data.x, data.y, data.z);
+        m.confidence = data.confidence;
+    }
+    return measurements;
+}
+
+} // namespace
+
+int main() {
+    const std::vector<TrackingData> samples[2] = {makeSamples(0.0f), makeSamples(0.4f)};
+    const std::vector<Measurement> measured[2] = {makeMeasurements(samples[0]), makeMeasurements(samples[1])};
+    const float mountYaw[2] = {0.0f, kMountYaw};
+    const float mountPitch[2] = {0.0f, kMountPitch};
+    const float velocity[6] = {20.0f, -10.0f, 5.0f, 30.0f, -15.0f, 8.0f};
+
+    TrackingData eulerCenterPose = samples[0][7];
+    const Pose poseCenterPose = Pose::fromTrackingData(eulerCenterPose);
+    const Eigen::Vector3f angular(0.3f, -0.2f, 0.1f);
+    const Eigen::Vector3f linear(30.0f, -15.0f, 8.0f);
+
+    PoseFusion fusion;
+    CameraEstimate mounted[2];
+    for (int c = 0; c < 2; ++c) {
+        mounted[c].setMount(mountYaw[c], mountPitch[c]);
+    }
+
+    std::printf("%-40s %12s\n", "Stage (2 cameras)", "Time/frame");
+
+    // Smoothing
+    {
+        TrackingData euler[2];
+        Pose pose[2];
+        const double eulerNs = htk::bench::nanosPerIteration(kIterations, [&](uint64_t i) {
+            for (int c = 0; c < 2; ++c) {
+                eulerSmooth(euler[c], eulerMeasure(measured[c][i & (kSamples - 1)]));
+            }
+            htk::bench::keep(euler);
+        });
+        const double poseNs = htk::bench::nanosPerIteration(kIterations, [&](uint64_t i) {
+            for (int c = 0; c < 2; ++c) {
+                poseSmooth(pose[c], measured[c][i & (kSamples - 1)]);
+            }
+            htk::bench::keep(pose);
+        });
+        htk::bench::report("measuring + smoothing, Euler", eulerNs);
+        htk::bench::report("measuring + smoothing, quaternion", poseNs);
+    }
+
+    // Coasting
+    {
+        TrackingData euler;
+        Pose pose;
+        const Pose detected[2] = {Pose::fromTrackingData(samples[0][0]), Pose::fromTrackingData(samples[1][0])};
+        const double eulerNs = htk::bench::nanosPerIteration(kIterations, [&](uint64_t i) {
+            for (int c = 0; c < 2; ++c) {
+                eulerCoast(euler, samples[c][i & (kSamples - 1)], velocity);
+                htk::bench::keep(euler);
+            }
+        });
+        const double poseNs = htk::bench::nanosPerIteration(kIterations, [&](uint64_t i) {
+            for (int c = 0; c < 2; ++c) {
+                poseCoast(pose, detected[(c + i) & 1], angular, linear);
+                htk::bench::keep(pose);
+            }
+        });
+        htk::bench::report("coasting, Euler", eulerNs);
+        htk::bench::report("coasting, quaternion", poseNs);
+    }
+
+    // Fusion, centering and the output conversion
+    {
+        std::vector<CameraEstimate> estimates[2];
+        for (int c = 0; c < 2; ++c) {
+            estimates[c].resize(kSamples);
+            for (size_t i = 0; i < kSamples; ++i) {
+                estimates[c][i].pose = Pose::fromTrackingData(samples[c][i]);
+                estimates[c][i].setMount(mountYaw[c], mountPitch[c]);
+            }
+        }
+
+        const double eulerNs = htk::bench::nanosPerIteration(kIterations, [&](uint64_t i) {
+            const TrackingData data[2] = {samples[0][i & (kSamples - 1)], samples[1][i & (kSamples - 1)]};
+            const TrackingData fused = eulerFuse(data, mountYaw, mountPitch, 2);
+            htk::bench::keep(eulerCenter(fused, eulerCenterPose));
+        });
+        const double poseNs = htk::bench::nanosPerIteration(kIterations, [&](uint64_t i) {
+            const CameraEstimate pair[2] = {estimates[0][i & (kSamples - 1)], estimates[1][i & (kSamples - 1)]};
+            const Pose fused = fusion.fuse(pair, 2);
+            htk::bench::keep(poseCenter(fused, poseCenterPose).toTrackingData());
+        });
+        htk::bench::report("fusion + centering, Euler", eulerNs);
+        htk::bench::report("fusion + centering + output, quaternion", poseNs);
+    }
+
+    // Whole frame with one camera, the common setup: measure, smooth,
+    // center, convert
+    {
+        TrackingData euler;
+        Pose pose;
+        const double eulerNs = htk::bench::nanosPerIteration(kIterations, [&](uint64_t i) {
+            eulerSmooth(euler, eulerMeasure(measured[0][i & (kSamples - 1)]));
+            htk::bench::keep(eulerCenter(euler, eulerCenterPose));
+        });
+        const double poseNs = htk::bench::nanosPerIteration(kIterations, [&](uint64_t i) {
+            poseSmooth(pose, measured[0][i & (kSamples - 1)]);
+            htk::bench::keep(poseCenter(pose, poseCenterPose).toTrackingData());
+        });
+        htk::bench::report("frame total (1 camera), Euler", eulerNs);
+        htk::bench::report("frame total (1 camera), quaternion", poseNs);
+    }
+
+    // Whole frame: smooth both cameras, fuse, center, convert
+    {
+        TrackingData euler[2];
+        Pose pose[2];
+        const double eulerNs = htk::bench::nanosPerIteration(kIterations, [&](uint64_t i) {
+            for (int c = 0; c < 2; ++c) {
+                eulerSmooth(euler[c], eulerMeasure(measured[c][i & (kSamples - 1)]));
+                euler[c].confidence = measured[c][i & (kSamples - 1)].confidence;
+                euler[c].isValid = true;
+            }
+            const TrackingData fused = eulerFuse(euler, mountYaw, mountPitch, 2);
+            htk::bench::keep(eulerCenter(fused, eulerCenterPose));
+        });
+        const double poseNs = htk::bench::nanosPerIteration(kIterations, [&](uint64_t i) {
+            for (int c = 0; c < 2; ++c) {
+                poseSmooth(pose[c], measured[c][i & (kSamples - 1)]);
+                mounted[c].pose = pose[c];
+                mounted[c].pose.confidence = measured[c][i & (kSamples - 1)].confidence;
+                mounted[c].pose.isValid = true;
+            }
+            const Pose fused = fusion.fuse(mounted, 2);
+            htk::bench::keep(poseCenter(fused, poseCenterPose).toTrackingData());
+        });
+        htk::bench::report("frame total, Euler", eulerNs);
+        htk::bench::report("frame total, quaternion", poseNs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+// htk-protocol-bench: cost of encoding one pose into the FreeTrack and
+// TrackIR packets and publishing it, against writing the FreeTrack fields
+// straight into shared memory one at a time as sendData() used to.
+
+#include "Bench.h"
+
+#include "output/ProtocolFormat.h"
+
+#include <cmath>
+#include <vector>
+
+using htk::core::TrackingData;
+using namespace htk::output;
+
+namespace {
+
+constexpr uint64_t kIterations = 5000000;
+constexpr size_t kSamples = 1024;  // Power of two
+
+// The old FreeTrackOutput::sendData body
+void writeFieldByField(freetrack::Packet* shared, const TrackingData& data, uint32_t sequence) {
+    shared->dataID = sequence;
+    shared->camWidth = 640;
+    shared->camHeight = 480;
+
+    shared->yaw   = data.yaw   * kDegToRad;
+    shared->pitch = data.pitch * kDegToRad;
+    shared->roll  = data.roll  * kDegToRad;
+    shared->x = data.x;
+    shared->y = data.y;
+    shared->z = data.z;
+
+    shared->rawyaw   = shared->yaw;
+    shared->rawpitch = shared->pitch;
+    shared->rawroll  = shared->roll;
+    shared->rawx     = shared->x;
+    shared->rawy     = shared->y;
+    shared->rawz     = shared->z;
+
+    shared->x1 = shared->y1 = 0.0f;
+    shared->x2 = shared->y2 = 0.0f;
+    shared->x3 = shared->y3 = 0.0f;
+    shared->x4 = shared->y4 = 0.0f;
+}
+
+} // namespace
+
+int main() {
+    std::vector<TrackingData> samples(kSamples);
+    for (size_t i = 0; i < kSamples; ++i) {
+        const float t = static_cast<float>(i) * 0.05f;
+        samples[i].yaw = 60.0f * std::sin(t);
+        samples[i].pitch = 30.0f * std::sin(0.7f * t);
+        samples[i].roll = 15.0f * std::sin(1.3f * t);
+        samples[i].x = 40.0f * std::sin(0.5f * t);
+        samples[i].y = 20.0f * std::cos(0.4f * t);
+        samples[i].z = 600.0f;
+        samples[i].isValid = true;
+    }
+
+    // Stand-ins for the mapped views
+    alignas(64) freetrack::Packet freeTrackShared{};
+    alignas(64) trackir::Packet trackIRShared{};
+
+    std::printf("%-40s %12s\n", "Per pose", "Time");
+
+    const double fieldsNs = htk::bench::nanosPerIteration(kIterations, [&](uint64_t i) {
+        writeFieldByField(&freeTrackShared, samples[i & (kSamples - 1)], static_cast<uint32_t>(i));
+        htk::bench::keep(freeTrackShared);
+    });
+    htk::bench::report("FreeTrack, fields into shared memory", fieldsNs);
+
+    const double freeTrackEncodeNs = htk::bench::nanosPerIteration(kIterations, [&](uint64_t i) {
+        freetrack::Packet packet;
+        freetrack::encode(samples[i & (kSamples - 1)], static_cast<uint32_t>(2 * i), packet);
+        htk::bench::keep(packet);
+    });
+    htk::bench::report("FreeTrack, encode", freeTrackEncodeNs);
+
+    const double freeTrackNs = htk::bench::nanosPerIteration(kIterations, [&](uint64_t i) {
+        freetrack::Packet packet;
+        freetrack::encode(samples[i & (kSamples - 1)], static_cast<uint32_t>(2 * i), packet);
+        freetrack::publish(&freeTrackShared, packet);
+        htk::bench::keep(freeTrackShared);
+    });
+    htk::bench::report("FreeTrack, encode + publish", freeTrackNs);
+
+    const double trackIRNs = htk::bench::nanosPerIteration(kIterations, [&](uint64_t i) {
+        trackir::Packet packet;
+        trackir::encode(samples[i & (kSamples - 1)], static_cast<uint16_t>(2 * i), packet);
+        trackir::publish(&trackIRShared, packet);
+        htk::bench::keep(trackIRShared);
+    });
+    htk::bench::report("TrackIR, encode + publish", trackIRNs);
+
+    return 0;
+}
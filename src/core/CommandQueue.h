@@ -0,0 +1,81 @@
+#ifndef COMMANDQUEUE_H
+#define COMMANDQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace htk::core {
+
+    // Bounded lock-free queue: any number of threads push, one thread pops.
+    // Each slot carries a sequence number saying whose turn it is, so a
+    // producer only contends on claiming a position and the consumer never
+    // waits on anyone. push() fails instead of blocking when the queue is full.
+    template <typename T, size_t Capacity>
+    class CommandQueue {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+    public:
+        CommandQueue() {
+            for (size_t i = 0; i < Capacity; ++i) {
+                m_slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        CommandQueue(const CommandQueue&) = delete;
+        CommandQueue& operator=(const CommandQueue&) = delete;
+
+        // Any thread
+        bool push(const T& value) {
+            size_t position = m_tail.load(std::memory_order_relaxed);
+            for (;;) {
+                Slot& slot = m_slots[position & (Capacity - 1)];
+                const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                const intptr_t lag = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+                if (lag == 0) {
+                    // Free slot: claim the position, then fill it
+                    if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        slot.value = value;
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (lag < 0) {
+                    return false;  // Consumer hasn't freed it yet: full
+                } else {
+                    position = m_tail.load(std::memory_order_relaxed);  // Another producer got there first
+                }
+            }
+        }
+
+        // Consumer thread only. False when empty, or when the next entry
+        // is claimed but still being written (it comes with the next pop).
+        bool pop(T& value) {
+            Slot& slot = m_slots[m_head & (Capacity - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != m_head + 1) {
+                return false;
+            }
+
+            value = slot.value;
+            slot.sequence.store(m_head + Capacity, std::memory_order_release);
+            ++m_head;
+            return true;
+        }
+
+    private:
+        struct Slot {
+            std::atomic<size_t> sequence;
+            T value{};
+        };
+
+        std::array<Slot, Capacity> m_slots;
+
+        // Producers and consumer on separate cache lines
+        alignas(64) std::atomic<size_t> m_tail{0};
+        alignas(64) size_t m_head = 0;
+    };
+
+} // namespace htk::core
+
+#endif // COMMANDQUEUE_H
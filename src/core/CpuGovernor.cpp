@@ -0,0 +1,140 @@
+#include "CpuGovernor.h"
+
+#include <algorithm>
+
+namespace htk::core {
+
+namespace {
+
+// Operating points from full quality to cheapest
+struct Rung {
+    int interval;
+    float scale;
+    float searchMargin;
+};
+
+constexpr Rung kLadder[CpuGovernor::kLevelCount] = {
+    {1, 1.00f, 0.00f},  // Full frame, full resolution
+    {1, 1.00f, 1.00f},  // Search around the last face
+    {1, 0.75f, 0.75f},
+    {1, 0.50f, 0.50f},
+    {2, 0.50f, 0.50f},  // Detect every other frame
+    {3, 0.50f, 0.50f},
+    {4, 0.40f, 0.50f},
+};
+
+constexpr float kCostAlpha  = 0.1f;
+constexpr float kSpeedAlpha = 0.3f;
+
+// Frames to stay on a level before moving again, so one slow frame
+// doesn't make the ladder oscillate
+constexpr int kHoldFrames = 15;
+
+// Step back up once cost falls below this share of the budget
+constexpr float kHeadroom = 0.5f;
+
+// Angular speeds (degrees per second) at which detection must keep up
+constexpr float kMediumSpeed = 20.0f;
+constexpr float kFastSpeed   = 60.0f;
+
+} // namespace
+
+CpuGovernor::CpuGovernor() = default;
+
+void CpuGovernor::setBudgetMs(float msPerFrame) {
+    m_budgetMs = std::max(0.0f, msPerFrame);
+}
+
+void CpuGovernor::setBudgetPercent(float percentOfCore, float fps) {
+    if (fps <= 0.0f) {
+        fps = 30.0f;
+    }
+    setBudgetMs(std::max(0.0f, percentOfCore) / 100.0f * 1000.0f / fps);
+}
+
+htk::input::DetectionSettings CpuGovernor::update(const FrameTiming& timing, const Pose& pose,
+                                                  const htk::input::DetectionSettings& current) {
+    // Detection is charged by CPU time: with the ensemble on, its wall time
+    // hides the detectors running side by side
+    const float costMs = static_cast<float>(timing.detectCpuUs + timing.poseUs) / 1000.0f;
+    m_costMs += kCostAlpha * (costMs - m_costMs);
+
+    // Head motion from consecutive valid poses
+    if (pose.isValid && m_haveLastPose && pose.timestamp > m_lastPose.timestamp) {
+        constexpr float kRadToDeg = 180.0f / 3.14159265358979f;
+        const float dt = static_cast<float>(pose.timestamp - m_lastPose.timestamp) / 1e6f;
+        const float speed = rotationBetween(m_lastPose.rotation, pose.rotation).norm() * kRadToDeg / dt;
+        m_speed += kSpeedAlpha * (speed - m_speed);
+    }
+    m_lastPose = pose;
+    m_haveLastPose = pose.isValid;
+
+    // Walk the ladder against the budget
+    const float budgetMs = m_budgetMs.load(std::memory_order_relaxed);
+    ++m_framesAtLevel;
+
+    if (budgetMs <= 0.0f) {
+        m_level = 0;
+    } else if (m_framesAtLevel >= kHoldFrames) {
+        if (m_costMs > budgetMs && m_level + 1 < kLevelCount) {
+            ++m_level;
+            m_framesAtLevel = 0;
+        } else if (m_costMs < kHeadroom * budgetMs && m_level > 0) {
+            --m_level;
+            m_framesAtLevel = 0;
+        }
+    }
+
+    const htk::input::DetectionSettings settings = settingsFor(m_level, m_speed, current);
+
+    m_publishedCostMs.store(m_costMs, std::memory_order_relaxed);
+    m_publishedSpeed.store(m_speed, std::memory_order_relaxed);
+    m_publishedLevel.store(m_level, std::memory_order_relaxed);
+    m_publishedInterval.store(settings.interval, std::memory_order_relaxed);
+    m_publishedScale.store(settings.scale, std::memory_order_relaxed);
+    m_publishedMargin.store(settings.searchMargin, std::memory_order_relaxed);
+    m_publishedMotionThreshold.store(settings.motionThreshold, std::memory_order_relaxed);
+    m_publishedRefine.store(settings.refine, std::memory_order_relaxed);
+    m_publishedEnsemble.store(settings.ensemble, std::memory_order_relaxed);
+
+    return settings;
+}
+
+htk::input::DetectionSettings CpuGovernor::settingsFor(int level, float speed,
+                                                       htk::input::DetectionSettings settings) const {
+    const Rung& rung = kLadder[level];
+
+    settings.interval     = rung.interval;
+    settings.scale        = rung.scale;
+    settings.searchMargin = rung.searchMargin;
+
+    // A moving head needs fresh detections and room to move within the ROI
+    if (settings.searchMargin > 0.0f) {
+        if (speed > kFastSpeed) {
+            settings.interval = 1;
+            settings.searchMargin = std::max(settings.searchMargin, 1.0f);
+        } else if (speed > kMediumSpeed) {
+            settings.interval = std::min(settings.interval, 2);
+            settings.searchMargin = std::max(settings.searchMargin, 0.75f);
+        }
+    }
+
+    return settings;
+}
+
+GovernorState CpuGovernor::getState() const {
+    GovernorState state;
+    state.budgetMs   = m_budgetMs.load(std::memory_order_relaxed);
+    state.measuredMs = m_publishedCostMs.load(std::memory_order_relaxed);
+    state.headSpeed  = m_publishedSpeed.load(std::memory_order_relaxed);
+    state.level      = m_publishedLevel.load(std::memory_order_relaxed);
+    state.settings.interval     = m_publishedInterval.load(std::memory_order_relaxed);
+    state.settings.scale        = m_publishedScale.load(std::memory_order_relaxed);
+    state.settings.searchMargin = m_publishedMargin.load(std::memory_order_relaxed);
+    state.settings.motionThreshold = m_publishedMotionThreshold.load(std::memory_order_relaxed);
+    state.settings.refine       = m_publishedRefine.load(std::memory_order_relaxed);
+    state.settings.ensemble     = m_publishedEnsemble.load(std::memory_order_relaxed);
+    return state;
+}
+
+} // namespace htk::core
@@ -0,0 +1,76 @@
+#ifndef CPUGOVERNOR_H
+#define CPUGOVERNOR_H
+
+#include "TrackingData.h"
+#include "Pose.h"
+#include "../input/DetectionSettings.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace htk::core {
+
+    // What the governor is currently doing
+    struct GovernorState {
+        float budgetMs   = 0.0f;  // Per-frame budget (0 = unlimited)
+        float measuredMs = 0.0f;  // Smoothed detection (CPU time) + pose cost per frame
+        float headSpeed  = 0.0f;  // Smoothed angular speed, degrees per second
+        int level        = 0;     // 0 = full quality, higher = cheaper
+        htk::input::DetectionSettings settings;  // In effect on the tracker
+    };
+
+    // Keeps the tracker's CPU cost within a budget by stepping through a
+    // ladder of detection operating points (ROI search, lower detection
+    // resolution, skipping detection frames). Head motion pulls it back to
+    // every-frame detection with a wider search area so fast turns aren't
+    // lost. Only interval, scale and searchMargin are the governor's; the
+    // rest of the tracker's settings pass through untouched. update() runs
+    // on the tracking thread; the budget can be set and the state read from
+    // any thread.
+    class CpuGovernor {
+    public:
+        CpuGovernor();
+
+        // Budget as milliseconds per frame, or as a share of one core at
+        // the given frame rate. 0 disables governing (always full quality).
+        void setBudgetMs(float msPerFrame);
+        void setBudgetPercent(float percentOfCore, float fps);
+
+        // Feed one frame's measured cost and pose along with the settings
+        // it ran with; returns the settings to use for the next frame
+        htk::input::DetectionSettings update(const FrameTiming& timing, const Pose& pose,
+                                             const htk::input::DetectionSettings& current);
+
+        GovernorState getState() const;
+
+        static constexpr int kLevelCount = 7;
+
+    private:
+        std::atomic<float> m_budgetMs{0.0f};
+
+        // Tracking thread state
+        float m_costMs = 0.0f;
+        float m_speed = 0.0f;
+        int m_level = 0;
+        int m_framesAtLevel = 0;
+        Pose m_lastPose;
+        bool m_haveLastPose = false;
+
+        // Published state
+        std::atomic<float> m_publishedCostMs{0.0f};
+        std::atomic<float> m_publishedSpeed{0.0f};
+        std::atomic<int> m_publishedLevel{0};
+        std::atomic<int> m_publishedInterval{1};
+        std::atomic<float> m_publishedScale{1.0f};
+        std::atomic<float> m_publishedMargin{0.0f};
+        std::atomic<float> m_publishedMotionThreshold{htk::input::DetectionSettings().motionThreshold};
+        std::atomic<bool> m_publishedRefine{htk::input::DetectionSettings().refine};
+        std::atomic<bool> m_publishedEnsemble{htk::input::DetectionSettings().ensemble};
+
+        htk::input::DetectionSettings settingsFor(int level, float speed,
+                                                  htk::input::DetectionSettings settings) const;
+    };
+
+} // namespace htk::core
+
+#endif // CPUGOVERNOR_H
@@ -0,0 +1,382 @@
+#include "FrameExporter.h"
+#include "FrameRingFormat.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+namespace htk::core {
+
+using namespace framering;
+
+namespace {
+
+// How often the accept loop checks for stop()
+constexpr int kPollMs = 200;
+
+RingHeader* headerOf(uint8_t* map) {
+    return reinterpret_cast<RingHeader*>(map);
+}
+
+ReaderControl* controlOf(uint8_t* map) {
+    return reinterpret_cast<ReaderControl*>(map);
+}
+
+} // namespace
+
+FrameExporter::~FrameExporter() {
+    stop();
+}
+
+#ifdef __linux__
+
+// Linux 5.1; older headers lack the name
+#ifndef F_SEAL_FUTURE_WRITE
+#define F_SEAL_FUTURE_WRITE 0x0010
+#endif
+
+namespace {
+
+void wakeReaders(std::atomic<uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+} // namespace
+
+bool FrameExporter::start(const std::string& socketPath, int slotCount, bool annotate) {
+    stop();
+
+    sockaddr_un addr{};
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Frame export socket path too long: " << socketPath << std::endl;
+        return false;
+    }
+
+    const int listenSocket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenSocket < 0) {
+        std::cerr << "Failed to create frame export socket" << std::endl;
+        return false;
+    }
+
+    // A stale socket from a previous run would make bind() fail
+    ::unlink(socketPath.c_str());
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (::bind(listenSocket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listenSocket, 8) != 0) {
+        std::cerr << "Failed to listen for frame consumers on " << socketPath << std::endl;
+        ::close(listenSocket);
+        return false;
+    }
+
+    m_socketPath = socketPath;
+    m_listenSocket = listenSocket;
+    m_slotCount = std::max(2, slotCount);
+    m_annotate = annotate;
+    m_published = 0;
+    m_shouldStop = false;
+    m_isRunning = true;
+    m_thread = std::make_unique<std::thread>(&FrameExporter::acceptLoop, this);
+
+    std::cout << "Exporting frames on " << socketPath << std::endl;
+    return true;
+}
+
+void FrameExporter::stop() {
+    m_shouldStop = true;
+
+    if (m_thread && m_thread->joinable()) {
+        m_thread->join();
+    }
+    m_thread.reset();
+
+    if (m_listenSocket >= 0) {
+        ::close(m_listenSocket);
+        ::unlink(m_socketPath.c_str());
+        m_listenSocket = -1;
+    }
+
+    std::lock_guard<std::mutex> lock(m_ringMutex);
+    closeRing();
+    m_isRunning = false;
+}
+
+void FrameExporter::publish(const cv::Mat& frame, uint64_t captureUs,
+                            const cv::Rect& faceRect, const TrackingData& data) {
+    if (!m_isRunning || frame.empty() || frame.type() != CV_8UC3) {
+        return;
+    }
+
+    RingHeader* header = m_map ? headerOf(m_map) : nullptr;
+    if (!header || header->width != static_cast<uint32_t>(frame.cols) ||
+        header->height != static_cast<uint32_t>(frame.rows)) {
+        // Never wait on the accept thread; try again next frame
+        std::unique_lock<std::mutex> lock(m_ringMutex, std::try_to_lock);
+        if (!lock.owns_lock() || !createRing(frame.cols, frame.rows)) {
+            return;
+        }
+        header = headerOf(m_map);
+    }
+
+    const uint64_t n = m_published;
+    uint8_t* slotBase = m_map + header->slotOffset + (n % header->slotCount) * header->slotStride;
+    SlotHeader* slot = reinterpret_cast<SlotHeader*>(slotBase);
+
+    // Odd sequence: readers that catch the slot now will drop it
+    slot->sequence.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    cv::Mat pixels(frame.rows, frame.cols, CV_8UC3, slotBase + kSlotHeaderBytes, header->rowStride);
+    frame.copyTo(pixels);
+
+    const bool hasFace = data.isValid && faceRect.area() > 0;
+    if (m_annotate && hasFace) {
+        cv::rectangle(pixels, faceRect, cv::Scalar(0, 255, 0), 2);
+    }
+
+    slot->captureUs = captureUs;
+    slot->publishUs = FrameTiming::steadyMicros();
+    slot->rectX = faceRect.x;
+    slot->rectY = faceRect.y;
+    slot->rectW = faceRect.width;
+    slot->rectH = faceRect.height;
+    slot->yaw   = data.yaw;
+    slot->pitch = data.pitch;
+    slot->roll  = data.roll;
+    slot->flags = hasFace ? kSlotFlagValid : 0;
+
+    slot->sequence.store(2 * n + 2, std::memory_order_release);
+    header->published.store(n + 1, std::memory_order_release);
+    m_published = n + 1;
+
+    // No syscall unless someone sleeps. Pairs with the reader's increment
+    // before FUTEX_WAIT: either we see it, or its wait sees the new value.
+    header->wakeup.fetch_add(1, std::memory_order_seq_cst);
+    if (controlOf(m_control)->waiters.load(std::memory_order_seq_cst) != 0) {
+        wakeReaders(header->wakeup);
+    }
+}
+
+bool FrameExporter::createRing(int width, int height) {
+    closeRing();
+
+    const size_t rowStride  = alignUp(static_cast<size_t>(width) * 3, kRowAlign);
+    const size_t pageSize   = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t slotStride = alignUp(kSlotHeaderBytes + rowStride * static_cast<size_t>(height), pageSize);
+    const size_t mapSize    = kHeaderBytes + slotStride * static_cast<size_t>(m_slotCount);
+
+    const int fd = memfd_create("htk-frames", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        std::cerr << "memfd_create failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Sealed size: a consumer's map can never be truncated under it
+    if (ftruncate(fd, static_cast<off_t>(mapSize)) != 0 ||
+        fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW) != 0) {
+        std::cerr << "Failed to size frame ring: " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    // Populated up front so publish() never takes a page fault
+    void* map = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "Failed to map frame ring: " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    // Ours is the only writable mapping there will ever be: consumers get
+    // the same fd, but can neither write through it nor map it writable
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_FUTURE_WRITE | F_SEAL_SEAL) != 0) {
+        std::cerr << "Failed to seal frame ring: " << std::strerror(errno) << std::endl;
+        munmap(map, mapSize);
+        ::close(fd);
+        return false;
+    }
+
+    // A fresh waiter count per ring, so a reader that died asleep only
+    // costs wakeups until the next one
+    if (!createControl()) {
+        munmap(map, mapSize);
+        ::close(fd);
+        return false;
+    }
+
+    uint8_t* bytes = static_cast<uint8_t*>(map);
+    RingHeader* header = new (bytes) RingHeader{};
+    std::memcpy(header->magic, kMagic, sizeof(kMagic));
+    header->version        = kVersion;
+    header->headerSize     = sizeof(RingHeader);
+    header->pixelFormat    = kPixelFormatBgr8;
+    header->slotCount      = static_cast<uint32_t>(m_slotCount);
+    header->slotHeaderSize = kSlotHeaderBytes;
+    header->slotStride     = slotStride;
+    header->slotOffset     = kHeaderBytes;
+    header->width          = static_cast<uint32_t>(width);
+    header->height         = static_cast<uint32_t>(height);
+    header->rowStride      = static_cast<uint32_t>(rowStride);
+    header->published.store(0, std::memory_order_relaxed);
+    header->wakeup.store(0, std::memory_order_relaxed);
+
+    for (int i = 0; i < m_slotCount; ++i) {
+        new (bytes + kHeaderBytes + static_cast<size_t>(i) * slotStride) SlotHeader{};
+    }
+    header->state.store(kStateActive, std::memory_order_release);
+
+    m_ringFd = fd;
+    m_map = bytes;
+    m_mapSize = mapSize;
+    m_published = 0;
+
+    std::cout << "Frame ring: " << width << "x" << height << ", " << m_slotCount
+              << " slots, " << mapSize / 1024 << " KiB" << std::endl;
+    return true;
+}
+
+bool FrameExporter::createControl() {
+    const int fd = memfd_create("htk-frames-control", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        std::cerr << "memfd_create failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Readers write here, so only the size is sealed
+    if (ftruncate(fd, static_cast<off_t>(kControlBytes)) != 0 ||
+        fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+        std::cerr << "Failed to size frame ring control: " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    void* map = mmap(nullptr, kControlBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "Failed to map frame ring control: " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    m_controlFd = fd;
+    m_control = static_cast<uint8_t*>(map);
+    new (m_control) ReaderControl{};
+    return true;
+}
+
+void FrameExporter::closeRing() {
+    if (m_map) {
+        // Readers keep their own mapping; tell them to reconnect
+        RingHeader* header = headerOf(m_map);
+        header->state.store(kStateClosed, std::memory_order_release);
+        header->wakeup.fetch_add(1, std::memory_order_release);
+        wakeReaders(header->wakeup);
+
+        munmap(m_map, m_mapSize);
+        m_map = nullptr;
+        m_mapSize = 0;
+    }
+    if (m_ringFd >= 0) {
+        ::close(m_ringFd);
+        m_ringFd = -1;
+    }
+    if (m_control) {
+        munmap(m_control, kControlBytes);
+        m_control = nullptr;
+    }
+    if (m_controlFd >= 0) {
+        ::close(m_controlFd);
+        m_controlFd = -1;
+    }
+}
+
+void FrameExporter::acceptLoop() {
+    while (!m_shouldStop) {
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(m_listenSocket, &readSet);
+        timeval timeout{0, kPollMs * 1000};
+
+        if (::select(m_listenSocket + 1, &readSet, nullptr, nullptr, &timeout) <= 0) {
+            continue;
+        }
+
+        const int client = ::accept4(m_listenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            continue;
+        }
+
+        // No ring until the first frame: the consumer retries
+        std::lock_guard<std::mutex> lock(m_ringMutex);
+        if (m_ringFd >= 0) {
+            HandshakeMessage message{};
+            std::memcpy(message.magic, kMagic, sizeof(kMagic));
+            message.mapSize = m_mapSize;
+            message.controlSize = kControlBytes;
+
+            const int fds[2] = {m_ringFd, m_controlFd};
+            iovec iov{&message, sizeof(message)};
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))] = {};
+            msghdr msg{};
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+            std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+            ::sendmsg(client, &msg, MSG_NOSIGNAL);
+        }
+        ::close(client);
+    }
+}
+
+#else
+
+bool FrameExporter::start(const std::string&, int, bool) {
+    std::cerr << "Frame export needs Linux (memfd)" << std::endl;
+    return false;
+}
+
+void FrameExporter::stop() {
+    m_isRunning = false;
+}
+
+void FrameExporter::publish(const cv::Mat&, uint64_t, const cv::Rect&, const TrackingData&) {
+}
+
+bool FrameExporter::createRing(int, int) {
+    return false;
+}
+
+bool FrameExporter::createControl() {
+    return false;
+}
+
+void FrameExporter::closeRing() {
+}
+
+void FrameExporter::acceptLoop() {
+}
+
+#endif
+
+} // namespace htk::core
@@ -0,0 +1,70 @@
+#ifndef FRAMEEXPORTER_H
+#define FRAMEEXPORTER_H
+
+#include "TrackingData.h"
+
+#include <opencv2/opencv.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace htk::core {
+
+    // Exports camera frames to other local processes through a memfd-backed
+    // ring (see FrameRingFormat.h). Consumers get the fd over a unix socket
+    // and map it read-only, so they read frames in place and can never hold
+    // up publish(). Linux only; start() fails elsewhere.
+    class FrameExporter {
+    public:
+        FrameExporter() = default;
+        ~FrameExporter();
+
+        FrameExporter(const FrameExporter&) = delete;
+        FrameExporter& operator=(const FrameExporter&) = delete;
+
+        // Listen on socketPath. The ring itself is created on the first
+        // frame, once the resolution is known.
+        bool start(const std::string& socketPath, int slotCount = 4, bool annotate = true);
+        void stop();
+        bool isRunning() const { return m_isRunning; }
+
+        // Copy a BGR frame into the next slot (drawing the face rect when
+        // annotating). Called from the tracking thread only.
+        void publish(const cv::Mat& frame, uint64_t captureUs,
+                     const cv::Rect& faceRect, const TrackingData& data);
+
+    private:
+        std::unique_ptr<std::thread> m_thread;
+        std::atomic<bool> m_isRunning{false};
+        std::atomic<bool> m_shouldStop{false};
+
+        std::string m_socketPath;
+        int m_listenSocket = -1;
+        int m_slotCount = 4;
+        bool m_annotate = true;
+
+        // Current ring. Replaced only by publish(); the mutex keeps the
+        // accept thread from handing out an fd that is being closed.
+        std::mutex m_ringMutex;
+        int m_ringFd = -1;
+        uint8_t* m_map = nullptr;
+        size_t m_mapSize = 0;
+        uint64_t m_published = 0;
+
+        // Page the readers count themselves in before sleeping on the ring
+        int m_controlFd = -1;
+        uint8_t* m_control = nullptr;
+
+        void acceptLoop();
+        bool createRing(int width, int height);
+        void closeRing();
+        bool createControl();
+    };
+
+} // namespace htk::core
+
+#endif // FRAMEEXPORTER_H
@@ -0,0 +1,118 @@
+#ifndef FRAMERINGFORMAT_H
+#define FRAMERINGFORMAT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace htk::core {
+
+    // Shared-memory frame ring (Linux memfd), written by FrameExporter
+    //
+    // A consumer connects to the exporter's unix socket and receives one
+    // HandshakeMessage with two memfds attached (SCM_RIGHTS): the ring,
+    // which it maps read-only, and the reader control page, which it maps
+    // read-write. The ring is sealed against resizing and against any write
+    // or writable mapping besides the exporter's own (Linux 5.1+).
+    //
+    //   RingHeader                   first kHeaderBytes of the map
+    //   slot[slotCount]              slotStride bytes each
+    //
+    // Slot:
+    //   SlotHeader                   kSlotHeaderBytes
+    //   pixels                       height rows of rowStride bytes, BGR8
+    //
+    // Frame n goes to slot n % slotCount. The slot's sequence is 2n+1 while
+    // it is written and 2n+2 once complete: a reader takes
+    // published - 1, checks the sequence, uses the pixels in place and
+    // checks the sequence again. A change means the writer lapped it and
+    // the frame is dropped; the writer never waits for readers.
+    //
+    // wakeup is a futex word bumped after every frame, for readers that
+    // would rather sleep than poll. The exporter only makes the wake
+    // syscall while ReaderControl::waiters is non-zero, so a sleeping
+    // reader increments it before FUTEX_WAIT and decrements it after.
+    // Timestamps are CLOCK_MONOTONIC microseconds, comparable across
+    // processes on the same machine.
+    //
+    // When the resolution changes the exporter sets state to kStateClosed
+    // and starts a new ring; readers reconnect to pick it up.
+    namespace framering {
+
+        constexpr char kMagic[8] = {'H', 'T', 'K', 'R', 'I', 'N', 'G', '1'};
+        constexpr uint16_t kVersion = 2;
+
+        constexpr uint32_t kPixelFormatBgr8 = 1;
+
+        constexpr uint32_t kStateActive = 1;
+        constexpr uint32_t kStateClosed = 2;
+
+        constexpr uint32_t kSlotFlagValid = 0x01;  // Pose/face fields are meaningful
+
+        constexpr size_t kHeaderBytes     = 4096;
+        constexpr size_t kControlBytes    = 4096;
+        constexpr size_t kSlotHeaderBytes = 64;
+        constexpr size_t kRowAlign        = 64;
+
+        static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+                      std::atomic<uint64_t>::is_always_lock_free,
+                      "ring atomics must be lock-free to work across processes");
+
+        struct RingHeader {
+            char magic[8];
+            uint16_t version;
+            uint16_t headerSize;
+            uint32_t pixelFormat;
+            uint32_t slotCount;
+            uint32_t slotHeaderSize;
+            uint64_t slotStride;       // Bytes from one slot to the next
+            uint64_t slotOffset;       // Offset of slot 0 from the start of the map
+            uint32_t width;
+            uint32_t height;
+            uint32_t rowStride;        // Bytes per pixel row
+            std::atomic<uint32_t> state;
+            std::atomic<uint32_t> wakeup;
+            uint32_t reserved0;
+            std::atomic<uint64_t> published;  // Frames completed so far
+            uint8_t reserved[56];
+        };
+        static_assert(sizeof(RingHeader) == 128, "ring header must stay 128 bytes");
+
+        struct SlotHeader {
+            std::atomic<uint64_t> sequence;
+            uint64_t captureUs;        // Camera frame arrival
+            uint64_t publishUs;        // Written to the ring
+            int32_t rectX;             // Face rect in pixels
+            int32_t rectY;
+            int32_t rectW;
+            int32_t rectH;
+            float yaw;                 // Centered output pose, degrees
+            float pitch;
+            float roll;
+            uint32_t flags;
+        };
+        static_assert(sizeof(SlotHeader) <= kSlotHeaderBytes, "slot header must fit its reservation");
+
+        // The one page readers may write to, shared by all of them
+        struct ReaderControl {
+            std::atomic<uint32_t> waiters;  // Readers in (or about to enter) FUTEX_WAIT
+            uint8_t reserved[60];
+        };
+        static_assert(sizeof(ReaderControl) <= kControlBytes, "reader control must fit its page");
+
+        // Sent with the ring fd, then the control fd
+        struct HandshakeMessage {
+            char magic[8];
+            uint64_t mapSize;
+            uint64_t controlSize;
+        };
+
+        inline size_t alignUp(size_t value, size_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+    } // namespace framering
+
+} // namespace htk::core
+
+#endif // FRAMERINGFORMAT_H
@@ -1,5 +1,12 @@
 #include "HeadTracker.h"
-
+#include "../input/CameraSource.h"
+#include "../input/VideoFileSource.h"
+#include "../input/StallInjectionSource.h"
+#include "../input/SyntheticSource.h"
+#include "../input/WatchdogSource.h"
+#include "Instrumentation.h"
+
+#include <algorithm>
 #include <iostream>
 #include <chrono>
 #include <thread>
@@ -9,6 +16,7 @@ namespace htk::core {
 HeadTracker::HeadTracker()
     : m_isRunning(false)
     , m_isPaused(false)
+    , m_isStandby(false)
     , m_shouldStop(false)
     , m_freeTrackEnabled(true)
     , m_trackIREnabled(true)
@@ -16,12 +24,11 @@ HeadTracker::HeadTracker()
     m_webcamTracker = std::make_unique<htk::input::WebcamTracker>();
 
 #ifdef _WIN32
-    m_freeTrackOutput = std::make_unique<FreeTrackOutput>();
-    m_trackIROutput  = std::make_unique<TrackIROutput>();
+    m_freeTrackOutput = std::make_unique<htk::output::FreeTrackOutput>();
+    m_trackIROutput  = std::make_unique<htk::output::TrackIROutput>();
 #endif
 
     m_currentData.reset();
-    m_centerOffset.reset();
 }
 
 HeadTracker::~HeadTracker() {
@@ -29,24 +36,90 @@ HeadTracker::~HeadTracker() {
 }
 
 bool HeadTracker::initialize(int cameraIndex) {
+    CameraSetup camera;
+    camera.cameraIndex = cameraIndex;
+    return initialize(std::vector<CameraSetup>{camera});
+}
+
+bool HeadTracker::initialize(const std::vector<CameraSetup>& cameras) {
+    if (cameras.empty()) {
+        std::cerr << "No cameras configured" << std::endl;
+        return false;
+    }
+
+    // Warm: cameras, cascade and outputs are already up
+    if (m_isInitialized && m_cameras == cameras && m_webcamTracker->isInitialized()) {
+        std::cout << "Head-Tracking Kit already initialized (warm)" << std::endl;
+        return true;
+    }
+
     std::cout << "Initializing Head-Tracking Kit..." << std::endl;
 
-    // Initialize webcam tracker
-    if (!m_webcamTracker->initialize(cameraIndex)) {
+    // Switching cameras needs the loop off the old devices first
+    if (m_isRunning) {
+        joinUpdateThread();
+    }
+    m_cameraWorkers.clear();
+
+    // The loop is down, so this thread may consume: settle what was sent
+    // before (outputs enabled or not decides what gets initialized below)
+    applyCommands();
+
+    // Primary camera (keeps its own warm state if it is unchanged)
+    const CameraSetup& primary = cameras.front();
+    const bool plainCamera = primary.videoPath.empty() && primary.syntheticMode.empty() &&
+                             primary.stallEvery <= 0.0f;
+    const bool primaryReady = plainCamera
+        ? m_webcamTracker->initialize(primary.cameraIndex, m_realtime)
+        : m_webcamTracker->initialize(makeSource(primary, m_realtime));
+
+    if (!primaryReady) {
         std::cerr << "Failed to initialize Head-Tracking Kit" << std::endl;
         return false;
     }
+    m_webcamTracker->setCalibration(loadCalibration(primary));
+    m_webcamTracker->setExposureSettings(exposureSettings(primary));
+    m_metrics.setNominalFps(m_webcamTracker->getNominalFps());
+    if (m_cpuBudgetPercent > 0.0f) {
+        m_cpuGovernor.setBudgetPercent(m_cpuBudgetPercent, m_webcamTracker->getNominalFps());
+    }
+
+    // Additional cameras are best effort
+    m_estimates.assign(1, CameraEstimate{});
+    m_estimates[0].setMount(primary.mountYaw, primary.mountPitch,
+                            Eigen::Vector3f(primary.mountX, primary.mountY, primary.mountZ));
+
+    for (size_t i = 1; i < cameras.size(); ++i) {
+        const CameraSetup& setup = cameras[i];
+        auto worker = std::make_unique<htk::input::CameraWorker>();
+        if (!worker->initialize(makeSource(setup, m_realtime))) {
+            std::cerr << "Warning: Skipping camera " << i << std::endl;
+            continue;
+        }
+        worker->setCalibration(loadCalibration(setup));
+        worker->setExposureSettings(exposureSettings(setup));
+        worker->setSmoothing(m_smoothing);
+        worker->setCoastTime(m_coastTime);
+
+        CameraEstimate estimate;
+        estimate.setMount(setup.mountYaw, setup.mountPitch,
+                          Eigen::Vector3f(setup.mountX, setup.mountY, setup.mountZ));
+        m_estimates.push_back(estimate);
+        m_cameraWorkers.push_back(std::move(worker));
+    }
+
+    m_cameras = cameras;
 
 #ifdef _WIN32
     // Initialize output protocols
-    if (m_freeTrackEnabled) {
+    if (m_freeTrackEnabled && !m_freeTrackOutput->isInitialized()) {
         if (!m_freeTrackOutput->initialize()) {
             std::cerr << "Warning: Failed to initialize FreeTrack output" << std::endl;
             m_freeTrackEnabled = false;
         }
     }
 
-    if (m_trackIREnabled) {
+    if (m_trackIREnabled && !m_trackIROutput->isInitialized()) {
         if (!m_trackIROutput->initialize()) {
             std::cerr << "Warning: Failed to initialize TrackIR output" << std::endl;
             m_trackIREnabled = false;
@@ -61,21 +134,48 @@ bool HeadTracker::initialize(int cameraIndex) {
     std::cout << "Note: Output protocols are only available on Windows" << std::endl;
 #endif
 
+    m_isInitialized = true;
     std::cout << "Head-Tracking Kit initialized successfully" << std::endl;
     return true;
 }
 
 bool HeadTracker::start() {
     if (m_isRunning) {
-        std::cout << "Head-Tracking Kit already running" << std::endl;
+        if (m_isStandby) {
+            // Queued behind any pause() sent before, so start() wins
+            postCommand({ControlCommand::Type::Resume});
+            m_isStandby = false;
+            std::cout << "Head-Tracking Kit resumed from standby" << std::endl;
+        } else {
+            std::cout << "Head-Tracking Kit already running" << std::endl;
+        }
         return true;
     }
 
+    // The loop is down, so this thread may consume: earlier commands
+    // (a pause included) land first, then start() unpauses
+    applyCommands();
+
     m_shouldStop = false;
+    m_isCentered = false;
     m_isPaused   = false;
+    m_isStandby  = false;
     m_isRunning  = true;
 
-    // Start update thread
+    if (m_realtime.enabled && m_realtime.lockMemory && !m_memoryLocked) {
+        std::string note;
+        m_memoryLocked = realtime::lockMemory(note);
+        if (!note.empty()) {
+            std::cerr << "Real-time mode: " << note << std::endl;
+        }
+    }
+
+    // Start camera worker threads, then the update thread
+    for (auto& worker : m_cameraWorkers) {
+        worker->setIdle(false);
+        worker->setRealtime(m_realtime);
+        worker->start();
+    }
     m_updateThread = std::make_unique<std::thread>(&HeadTracker::updateLoop, this);
 
     std::cout << "Head-Tracking Kit started" << std::endl;
@@ -83,24 +183,48 @@ bool HeadTracker::start() {
 }
 
 void HeadTracker::stop() {
-    if (!m_isRunning) {
+    if (!m_isRunning || m_isStandby) {
         return;
     }
 
-    std::cout << "Head-Tracking Kit stopping..." << std::endl;
+    // Keep the loop alive in standby so the camera stays drained and warm
+    m_isStandby = true;
+    std::cout << "Head-Tracking Kit stopped (standby)" << std::endl;
+}
 
+void HeadTracker::joinUpdateThread() {
     m_shouldStop = true;
 
     if (m_updateThread && m_updateThread->joinable()) {
         m_updateThread->join();
     }
+    m_updateThread.reset();
+
+    for (auto& worker : m_cameraWorkers) {
+        worker->stop();
+    }
 
     m_isRunning = false;
-    std::cout << "Head-Tracking Kit stopped" << std::endl;
+    m_isStandby = false;
 }
 
 void HeadTracker::shutdown() {
-    stop();
+    if (m_isRunning) {
+        std::cout << "Head-Tracking Kit stopping..." << std::endl;
+        joinUpdateThread();
+    }
+
+    stopRecording();
+    stopMetricsExport();
+    stopFrameExport();
+
+    m_cameraWorkers.clear();
+    m_cameras.clear();
+
+    if (m_memoryLocked) {
+        realtime::unlockMemory();
+        m_memoryLocked = false;
+    }
 
     if (m_webcamTracker) {
         m_webcamTracker->shutdown();
@@ -115,33 +239,32 @@ void HeadTracker::shutdown() {
     }
 #endif
 
+    m_isInitialized = false;
     std::cout << "Head-Tracking Kit shutdown complete" << std::endl;
 }
 
 void HeadTracker::recenter() {
-    std::lock_guard<std::mutex> lock(m_dataMutex);
-
-    // Store current position as center offset
-    m_centerOffset = m_currentData;
-
-    std::cout << "Recentered at: yaw="   << m_centerOffset.yaw
-              << " pitch="              << m_centerOffset.pitch
-              << " roll="               << m_centerOffset.roll
-              << std::endl;
+    postCommand({ControlCommand::Type::Recenter});
 }
 
 void HeadTracker::pause() {
-    m_isPaused = true;
-    std::cout << "Head-Tracking Kit paused" << std::endl;
+    postCommand({ControlCommand::Type::Pause});
 }
 
 void HeadTracker::resume() {
-    m_isPaused = false;
-    std::cout << "Head-Tracking Kit resumed" << std::endl;
+    postCommand({ControlCommand::Type::Resume});
 }
 
 bool HeadTracker::isTracking() const {
-    return m_isRunning && m_webcamTracker->isTracking();
+    if (!isRunning()) {
+        return false;
+    }
+
+    bool tracking = m_webcamTracker->isTracking();
+    for (const auto& worker : m_cameraWorkers) {
+        tracking = tracking || worker->isTracking();
+    }
+    return tracking;
 }
 
 TrackingData HeadTracker::getCurrentData() const {
@@ -149,18 +272,208 @@ TrackingData HeadTracker::getCurrentData() const {
     return m_currentData;
 }
 
+bool HeadTracker::getPreviewFrame(cv::Mat& frame) {
+    m_previewWanted = true;
+
+    std::lock_guard<std::mutex> lock(m_previewMutex);
+    if (!m_previewFresh) {
+        return false;
+    }
+
+    m_previewFrame.copyTo(frame);
+    m_previewFresh = false;
+    return true;
+}
+
 void HeadTracker::setSmoothing(float factor) {
-    m_webcamTracker->setSmoothing(factor);
+    postCommand({ControlCommand::Type::Smoothing, factor});
+}
+
+void HeadTracker::setCoastTime(float seconds) {
+    postCommand({ControlCommand::Type::CoastTime, seconds});
 }
 
 void HeadTracker::enableFreeTrack(bool enable) {
-    m_freeTrackEnabled = enable;
-    std::cout << "FreeTrack output " << (enable ? "enabled" : "disabled") << std::endl;
+    postCommand({ControlCommand::Type::FreeTrack, 0.0f, enable});
 }
 
 void HeadTracker::enableTrackIR(bool enable) {
-    m_trackIREnabled = enable;
-    std::cout << "TrackIR output " << (enable ? "enabled" : "disabled") << std::endl;
+    postCommand({ControlCommand::Type::TrackIR, 0.0f, enable});
+}
+
+void HeadTracker::postCommand(const ControlCommand& command) {
+    if (!m_commands.push(command)) {
+        std::cerr << "Warning: Control queue full, command dropped" << std::endl;
+    }
+}
+
+void HeadTracker::applyCommands() {
+    ControlCommand command;
+    while (m_commands.pop(command)) {
+        applyCommand(command);
+    }
+
+    // Curve edits land on the same frame boundary
+    m_responseMapper.applyPending();
+}
+
+void HeadTracker::applyCommand(const ControlCommand& command) {
+    switch (command.type) {
+        case ControlCommand::Type::Recenter: {
+            // The raw pose, not the already-centered output, becomes the new center
+            m_centerPose = m_rawPose;
+            m_isCentered = true;
+
+            const TrackingData center = m_centerPose.toTrackingData();
+            std::cout << "Recentered at: yaw="   << center.yaw
+                      << " pitch="              << center.pitch
+                      << " roll="               << center.roll
+                      << std::endl;
+            break;
+        }
+        case ControlCommand::Type::Pause:
+            m_isPaused = true;
+            std::cout << "Head-Tracking Kit paused" << std::endl;
+            break;
+        case ControlCommand::Type::Resume:
+            m_isPaused = false;
+            std::cout << "Head-Tracking Kit resumed" << std::endl;
+            break;
+        case ControlCommand::Type::Smoothing:
+            m_smoothing = command.value;
+            m_webcamTracker->setSmoothing(command.value);
+            for (auto& worker : m_cameraWorkers) {
+                worker->setSmoothing(command.value);
+            }
+            break;
+        case ControlCommand::Type::CoastTime:
+            m_coastTime = command.value;
+            m_webcamTracker->setCoastTime(command.value);
+            for (auto& worker : m_cameraWorkers) {
+                worker->setCoastTime(command.value);
+            }
+            break;
+        case ControlCommand::Type::FreeTrack:
+            m_freeTrackEnabled = command.enable;
+            std::cout << "FreeTrack output " << (command.enable ? "enabled" : "disabled") << std::endl;
+            break;
+        case ControlCommand::Type::TrackIR:
+            m_trackIREnabled = command.enable;
+            std::cout << "TrackIR output " << (command.enable ? "enabled" : "disabled") << std::endl;
+            break;
+        case ControlCommand::Type::CpuBudgetMs:
+            m_cpuBudgetPercent = 0.0f;
+            m_cpuGovernor.setBudgetMs(command.value);
+            break;
+        case ControlCommand::Type::CpuBudgetPercent: {
+            // Before the camera is up the governor assumes 30 FPS;
+            // initialize() converts again with the real rate
+            m_cpuBudgetPercent = command.value;
+            const float fps = m_webcamTracker->isInitialized() ? m_webcamTracker->getNominalFps() : 0.0f;
+            m_cpuGovernor.setBudgetPercent(command.value, fps);
+            break;
+        }
+    }
+}
+
+void HeadTracker::setResponseCurve(PoseAxis axis, const ResponseCurve& curve) {
+    m_responseMapper.setCurve(axis, curve);
+}
+
+ResponseCurve HeadTracker::getResponseCurve(PoseAxis axis) const {
+    return m_responseMapper.getCurve(axis);
+}
+
+void HeadTracker::setCpuBudgetMs(float msPerFrame) {
+    postCommand({ControlCommand::Type::CpuBudgetMs, msPerFrame});
+}
+
+void HeadTracker::setCpuBudgetPercent(float percentOfCore) {
+    postCommand({ControlCommand::Type::CpuBudgetPercent, percentOfCore});
+}
+
+bool HeadTracker::setRealtime(const RealtimeSettings& settings) {
+    // Read by threads that are already running once initialized
+    if (m_isInitialized) {
+        std::cerr << "Warning: Real-time settings only apply before initialize(), ignored" << std::endl;
+        return false;
+    }
+    m_realtime = settings;
+    return true;
+}
+
+RealtimeStatus HeadTracker::getRealtimeStatus() const {
+    RealtimeStatus status;
+    {
+        std::lock_guard<std::mutex> lock(m_realtimeMutex);
+        status = m_realtimeStatus;
+    }
+
+    // Capture threads report for themselves once they have started
+    const auto addCapture = [&status](const RealtimeStatus& capture) {
+        ++status.captureThreads;
+        status.captureScheduled += capture.scheduled ? 1 : 0;
+        if (!capture.message.empty() && status.message.find(capture.message) == std::string::npos) {
+            status.message += status.message.empty() ? capture.message : "; " + capture.message;
+        }
+    };
+
+    RealtimeStatus capture[2];
+    if (m_webcamTracker->getCaptureRealtime(capture[0])) {
+        addCapture(capture[0]);
+    }
+    for (const auto& worker : m_cameraWorkers) {
+        const int count = worker->getRealtimeStatus(capture);
+        for (int i = 0; i < count; ++i) {
+            addCapture(capture[i]);
+        }
+    }
+    return status;
+}
+
+bool HeadTracker::startRecording(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_recorderMutex);
+
+    if (!m_recorder.open(path)) {
+        m_isRecording = false;
+        return false;
+    }
+
+    m_isRecording = true;
+    return true;
+}
+
+void HeadTracker::stopRecording() {
+    std::lock_guard<std::mutex> lock(m_recorderMutex);
+
+    m_isRecording = false;
+    m_recorder.close();
+}
+
+bool HeadTracker::exportMetricsToFile(const std::string& path, int intervalMs) {
+    return m_metricsExporter.startFile(path, intervalMs);
+}
+
+bool HeadTracker::serveMetrics(uint16_t port) {
+    return m_metricsExporter.startHttp(port);
+}
+
+void HeadTracker::stopMetricsExport() {
+    m_metricsExporter.stop();
+}
+
+bool HeadTracker::startFrameExport(const std::string& socketPath) {
+    std::lock_guard<std::mutex> lock(m_frameExportMutex);
+
+    m_isExportingFrames = m_frameExporter.start(socketPath);
+    return m_isExportingFrames;
+}
+
+void HeadTracker::stopFrameExport() {
+    std::lock_guard<std::mutex> lock(m_frameExportMutex);
+
+    m_isExportingFrames = false;
+    m_frameExporter.stop();
 }
 
 void HeadTracker::updateLoop() {
@@ -170,36 +483,131 @@ void HeadTracker::updateLoop() {
     const auto targetFrameTime = milliseconds(1000 / targetFPS);
 
     std::cout << "Update loop started (target: " << targetFPS << " FPS)" << std::endl;
+    HTK_THREAD_NAME("tracking");
+
+    if (m_realtime.enabled) {
+        RealtimeStatus status = realtime::applyToCurrentThread(
+            m_realtime.trackingPriority, m_realtime.roundRobin, m_realtime.trackingCpus);
+        status.memoryLocked = m_memoryLocked;
+        realtime::prefaultStack();
+
+        if (status.scheduled) {
+            std::cout << "Update loop running with real-time priority " << m_realtime.trackingPriority << std::endl;
+        }
+        if (!status.message.empty()) {
+            std::cerr << "Real-time mode: " << status.message << std::endl;
+        }
+
+        std::lock_guard<std::mutex> lock(m_realtimeMutex);
+        m_realtimeStatus = status;
+    }
 
     while (!m_shouldStop) {
         const auto frameStart = steady_clock::now();
 
-        if (!m_isPaused) {
+        // Control changes take effect here, all at once, never mid-frame
+        applyCommands();
+
+        const bool idle = m_isPaused || m_isStandby;
+        for (auto& worker : m_cameraWorkers) {
+            worker->setIdle(idle);
+        }
+
+        if (idle) {
+            // Drain the camera so resuming doesn't start on stale buffers
+            HTK_ZONE("idle");
+            m_webcamTracker->idle();
+        } else {
             // Update webcam tracker
+            HTK_ZONE("tracking frame");
             if (m_webcamTracker->update()) {
-                // Get raw tracking data
-                TrackingData rawData = m_webcamTracker->getTrackingData();
-
-                // Apply center offset
-                TrackingData centeredData = applyCenterOffset(rawData);
+                // Get raw pose, fused with any other cameras
+                const Pose rawPose = m_cameraWorkers.empty()
+                    ? m_webcamTracker->getPose()
+                    : fuseCameras(m_webcamTracker->getPose());
+
+                // A stalled camera gives no frame, only a coasted pose
+                const bool stalled = m_webcamTracker->isStalled();
+                if (stalled) {
+                    m_metrics.onCameraStall(!m_isDegraded);
+                } else {
+                    m_metrics.onCameraFrame(m_webcamTracker->getFrameArrival(),
+                                            m_webcamTracker->isDuplicateFrame());
+                    m_metrics.onDetection(m_webcamTracker->isTracking(),
+                                          m_webcamTracker->wasDetectionGated(),
+                                          m_webcamTracker->isCoasting());
+                    if (const uint32_t gapUs = m_webcamTracker->getReacquireTime()) {
+                        m_metrics.onReacquire(gapUs);
+                    }
 
-                // Update shared data
+                    // Adjust detection cost for the next frame, keeping
+                    // the tracker's other settings
+                    m_webcamTracker->setDetectionSettings(
+                        m_cpuGovernor.update(m_webcamTracker->getFrameTiming(),
+                                             m_webcamTracker->getPose(),
+                                             m_webcamTracker->getDetectionSettings()));
+                }
+                if (const uint32_t outageUs = m_webcamTracker->getReconnectTime()) {
+                    m_metrics.onCameraReconnect(outageUs);
+                }
+                m_isDegraded = stalled;
+
+                const uint64_t outputStart = FrameTiming::steadyMicros();
+                HTK_ZONE("output");
+
+                // Center, then leave quaternions behind: Euler angles only
+                // exist from here on. Recentering happens on this thread,
+                // so only the published copy needs the lock.
+                m_rawPose = rawPose;
+
+                // Z is the distance from the camera, so until the user
+                // recenters, the first valid pose's position is the center
+                // (orientation stays relative to looking into the camera)
+                if (!m_isCentered && rawPose.isValid) {
+                    m_centerPose.translation = rawPose.translation;
+                    m_isCentered = true;
+                    std::cout << "Centered at " << rawPose.translation.z() << " mm from the camera" << std::endl;
+                }
+                const TrackingData centeredData = applyCenterOffset(rawPose).toTrackingData();
                 {
                     std::lock_guard<std::mutex> lock(m_dataMutex);
                     m_currentData = centeredData;
                 }
 
+                // Per-axis response curves
+                const TrackingData outputData = m_responseMapper.apply(centeredData);
+
 #ifdef _WIN32
                 // Send to outputs
-                if (centeredData.isValid) {
+                if (outputData.isValid) {
                     if (m_freeTrackEnabled) {
-                        m_freeTrackOutput->sendData(centeredData);
+                        m_freeTrackOutput->sendData(outputData);
                     }
                     if (m_trackIREnabled) {
-                        m_trackIROutput->sendData(centeredData);
+                        m_trackIROutput->sendData(outputData);
                     }
                 }
+#else
+                (void)outputData;
 #endif
+
+                if (centeredData.isValid) {
+                    m_metrics.onOutput(centeredData, outputStart);
+                }
+
+                if (m_isRecording) {
+                    recordSample(centeredData, FrameTiming::steadyMicros() - outputStart);
+                }
+
+                if (m_isExportingFrames && !stalled) {
+                    exportFrame(centeredData);
+                }
+
+                if (m_previewWanted) {
+                    publishPreviewFrame();
+                }
+
+                HTK_FRAME_MARK(m_webcamTracker->getFrameTiming(), FrameTiming::steadyMicros() - outputStart);
             }
         }
 
@@ -208,22 +616,134 @@ void HeadTracker::updateLoop() {
         const auto frameTime = duration_cast<milliseconds>(frameEnd - frameStart);
 
         if (frameTime < targetFrameTime) {
-            std::this_thread::sleep_for(targetFrameTime - frameTime);
+            // How late we wake is the scheduling jitter real-time mode fights
+            const auto sleepTime  = targetFrameTime - frameTime;
+            const auto sleepStart = steady_clock::now();
+            std::this_thread::sleep_for(sleepTime);
+
+            const auto lateUs = duration_cast<microseconds>(steady_clock::now() - sleepStart - sleepTime).count();
+            m_metrics.onWakeup(static_cast<uint32_t>(std::max<int64_t>(lateUs, 0)));
         }
     }
 
     std::cout << "Update loop stopped" << std::endl;
 }
 
-TrackingData HeadTracker::applyCenterOffset(const TrackingData& data) const {
-    TrackingData result = data;
+std::unique_ptr<htk::input::FrameSource> HeadTracker::makeSource(const CameraSetup& setup,
+                                                                 const RealtimeSettings& realtime) {
+    std::unique_ptr<htk::input::FrameSource> source;
+    const bool isCamera = setup.videoPath.empty() && setup.syntheticMode.empty();
+    if (!setup.syntheticMode.empty()) {
+        htk::input::SyntheticSettings synthetic;
+        htk::input::parseSyntheticMode(setup.syntheticMode, synthetic);
+        source = std::make_unique<htk::input::SyntheticSource>(synthetic);
+    } else if (!isCamera) {
+        source = std::make_unique<htk::input::VideoFileSource>(setup.videoPath, true, true);
+    } else {
+        source = std::make_unique<htk::input::CameraSource>(setup.cameraIndex);
+    }
+
+    const bool injectFaults = setup.stallEvery > 0.0f;
+    if (injectFaults) {
+        source = std::make_unique<htk::input::StallInjectionSource>(
+            std::move(source), setup.stallEvery, setup.stallLength, setup.stallDisconnect);
+    }
+
+    // Live cameras can hang in read(); so can anything with injected faults
+    if (isCamera || injectFaults) {
+        source = std::make_unique<htk::input::WatchdogSource>(std::move(source), 3.0f, realtime);
+    }
+    return source;
+}
+
+htk::input::CameraCalibration HeadTracker::loadCalibration(const CameraSetup& setup) {
+    htk::input::CameraCalibration calibration;
+    if (!setup.calibrationPath.empty() && !calibration.load(setup.calibrationPath)) {
+        std::cerr << "Warning: Using nominal lens for " << setup.calibrationPath << std::endl;
+    }
+    return calibration;
+}
+
+htk::input::ExposureSettings HeadTracker::exposureSettings(const CameraSetup& setup) {
+    htk::input::ExposureSettings exposure;
+    exposure.enabled = setup.exposureCap > 0.0f;
+    exposure.headroom = std::min(setup.exposureCap, 1.0f);
+    return exposure;
+}
+
+Pose HeadTracker::fuseCameras(const Pose& primary) {
+    HTK_ZONE("fuse");
+
+    // The primary frame drives the cadence; other cameras contribute their
+    // latest estimate, so fusion never waits on a slower camera
+    m_estimates[0].pose = primary;
+    for (size_t i = 0; i < m_cameraWorkers.size(); ++i) {
+        m_estimates[i + 1].pose = m_cameraWorkers[i]->getPose();
+    }
+
+    return m_fusion.fuse(m_estimates.data(), m_estimates.size());
+}
+
+void HeadTracker::publishPreviewFrame() {
+    HTK_ZONE("preview publish");
+
+    // The UI is copying the previous one out; it'll ask again
+    std::unique_lock<std::mutex> lock(m_previewMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return;
+    }
+
+    if (m_webcamTracker->getCurrentFrame(m_previewFrame)) {
+        m_previewFresh = true;
+        m_previewWanted = false;
+    }
+}
+
+void HeadTracker::exportFrame(const TrackingData& data) {
+    HTK_ZONE("frame export");
+
+    // Never wait on the UI thread starting/stopping the export; drop the frame
+    std::unique_lock<std::mutex> lock(m_frameExportMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return;
+    }
+
+    m_frameExporter.publish(m_webcamTracker->getFrame(), m_webcamTracker->getFrameArrival(),
+                            m_webcamTracker->getLastFaceRect(), data);
+}
+
+void HeadTracker::recordSample(const TrackingData& data, uint64_t outputUs) {
+    HTK_ZONE("record");
+
+    // Never wait on the UI thread opening/closing the file; drop the sample
+    std::unique_lock<std::mutex> lock(m_recorderMutex, std::try_to_lock);
+    if (!lock.owns_lock() || !m_recorder.isOpen()) {
+        return;
+    }
+
+    SessionSample sample;
+    sample.data = data;
+    sample.timing = m_webcamTracker->getFrameTiming();
+    sample.timing.outputUs = static_cast<uint32_t>(outputUs);
+
+    if (data.isValid) {
+        const cv::Rect& rect = m_webcamTracker->getLastFaceRect();
+        sample.rectX = rect.x;
+        sample.rectY = rect.y;
+        sample.rectW = rect.width;
+        sample.rectH = rect.height;
+    }
+
+    m_recorder.append(sample);
+}
+
+Pose HeadTracker::applyCenterOffset(const Pose& pose) const {
+    Pose result = pose;
 
-    result.yaw   -= m_centerOffset.yaw;
-    result.pitch -= m_centerOffset.pitch;
-    result.roll  -= m_centerOffset.roll;
-    result.x     -= m_centerOffset.x;
-    result.y     -= m_centerOffset.y;
-    result.z     -= m_centerOffset.z;
+    // Rotation relative to the center orientation, composed rather than
+    // subtracted per axis so it stays right when rotations combine
+    result.rotation    = m_centerPose.rotation.conjugate() * pose.rotation;
+    result.translation = pose.translation - m_centerPose.translation;
 
     return result;
 }
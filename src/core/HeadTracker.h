@@ -2,7 +2,17 @@
 #define HEADTRACKER_H
 
 #include "TrackingData.h"
+#include "SessionRecorder.h"
+#include "TrackingMetrics.h"
+#include "MetricsExporter.h"
+#include "FrameExporter.h"
+#include "PoseFusion.h"
+#include "ResponseCurve.h"
+#include "CpuGovernor.h"
+#include "Realtime.h"
+#include "CommandQueue.h"
 #include "../input/WebcamTracker.h"
+#include "../input/CameraWorker.h"
 
 #ifdef _WIN32
 #include "../output/FreeTrackOutput.h"
@@ -10,41 +20,162 @@
 #endif
 
 #include <memory>
+#include <string>
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <vector>
 
 namespace htk::core {
 
+    // One frame source feeding the tracker
+    struct CameraSetup {
+        int cameraIndex = 0;      // Live camera, used when videoPath is empty
+        std::string videoPath;    // Replay a recording instead (looped, paced)
+        std::string syntheticMode;  // "<w>x<h>@<fps>": render a synthetic face instead
+        std::string calibrationPath;  // Lens calibration file (empty = nominal lens)
+
+        // Fault injection for testing the capture watchdog: every stallEvery
+        // seconds the source hangs (or disconnects) for stallLength seconds
+        float stallEvery  = 0.0f;
+        float stallLength = 0.0f;
+        bool stallDisconnect = false;
+
+        // Exposure cap (share of the frame period) once auto exposure costs
+        // frame rate in low light; 0 leaves auto exposure alone
+        float exposureCap = 0.8f;
+
+        // Mounting relative to the first camera: rotation (degrees added
+        // to its estimate) and where it sits in the first camera's frame
+        // (mm; x right, y down, z forward)
+        float mountYaw   = 0.0f;
+        float mountPitch = 0.0f;
+        float mountX = 0.0f;
+        float mountY = 0.0f;
+        float mountZ = 0.0f;
+
+        bool operator==(const CameraSetup& other) const {
+            return cameraIndex == other.cameraIndex && videoPath == other.videoPath &&
+                   syntheticMode == other.syntheticMode &&
+                   calibrationPath == other.calibrationPath &&
+                   stallEvery == other.stallEvery && stallLength == other.stallLength &&
+                   stallDisconnect == other.stallDisconnect && exposureCap == other.exposureCap &&
+                   mountYaw == other.mountYaw && mountPitch == other.mountPitch &&
+                   mountX == other.mountX && mountY == other.mountY && mountZ == other.mountZ;
+        }
+    };
+
+    // Runtime control request, queued by the control calls and carried out
+    // by the update thread at the start of a frame
+    struct ControlCommand {
+        enum class Type {
+            Recenter, Pause, Resume, Smoothing, CoastTime, FreeTrack, TrackIR, CpuBudgetMs, CpuBudgetPercent
+        };
+
+        Type type = Type::Recenter;
+        float value = 0.0f;   // Smoothing factor, coast time (seconds), CPU budget
+        bool enable = false;  // Output on/off
+    };
+
     class HeadTracker {
     public:
         HeadTracker();
         ~HeadTracker();
 
         // Lifecycle
+        // initialize() is cheap when already warm on the same camera.
+        // stop() drops to warm standby: the camera stays open and drained,
+        // detector and last tracking/filter state stay resident, so start()
+        // resumes on the next frame. shutdown() releases everything.
         bool initialize(int cameraIndex = 0);
+
+        // Several cameras: the first runs on the update thread and sets the
+        // output cadence, every other one gets its own capture/detection
+        // thread, and the estimates are fused weighted by confidence
+        bool initialize(const std::vector<CameraSetup>& cameras);
         bool start();
         void stop();
         void shutdown();
 
+        // Control and settings calls below never block on the update
+        // thread: they queue a command it applies at the start of its next
+        // frame (or initialize() does, while the loop isn't running)
+
         // Control
         void recenter();
         void pause();
         void resume();
 
         // Status
-        bool isRunning() const { return m_isRunning; }
+        bool isRunning() const { return m_isRunning && !m_isStandby; }
+        bool isStandby() const { return m_isRunning && m_isStandby; }
         bool isTracking() const;
+
+        // The primary camera stopped delivering frames: outputs get coasted
+        // poses while it reconnects in the background
+        bool isDegraded() const { return m_isDegraded; }
         htk::core::TrackingData getCurrentData() const;
 
+        // Latest primary camera frame for display, copied into the caller's
+        // buffer (reused when the size matches). False when there is no new
+        // frame yet. Asking also requests the next one, so the tracking
+        // thread only copies frames someone shows.
+        bool getPreviewFrame(cv::Mat& frame);
+
         // Settings
         void setSmoothing(float factor);
+        void setCoastTime(float seconds);  // Bridge missed detections this long
         void enableFreeTrack(bool enable);
         void enableTrackIR(bool enable);
 
+        // Per-axis response curves between centering and the outputs
+        // (compiled on the caller's thread, swapped in at a frame start)
+        void setResponseCurve(PoseAxis axis, const ResponseCurve& curve);
+        ResponseCurve getResponseCurve(PoseAxis axis) const;
+
+        // CPU budget for detection on the primary camera, in milliseconds
+        // per frame or percent of one core at the camera's frame rate.
+        // 0 (default) always runs full-quality detection. Queued like the
+        // settings above; a percentage is converted once the camera's rate
+        // is known.
+        void setCpuBudgetMs(float msPerFrame);
+        void setCpuBudgetPercent(float percentOfCore);
+        htk::core::GovernorState getGovernorState() const { return m_cpuGovernor.getState(); }
+
+        // Real-time scheduling for the update and camera threads, applied
+        // when the threads start. Only before initialize() (camera capture
+        // threads start with their sources): refused with a warning after,
+        // until shutdown(). getRealtimeStatus() reports what the update
+        // thread got and how many capture threads got their priority;
+        // wake-up jitter is in the metrics.
+        bool setRealtime(const RealtimeSettings& settings);
+        htk::core::RealtimeStatus getRealtimeStatus() const;
+
+        // Session recording (.htks, see SessionFormat.h)
+        bool startRecording(const std::string& path);
+        void stopRecording();
+        bool isRecording() const { return m_isRecording; }
+
+        // Quality metrics (lock-free, callable from any thread)
+        htk::core::MetricsSnapshot getMetrics() const { return m_metrics.snapshot(); }
+        bool exportMetricsToFile(const std::string& path, int intervalMs = 1000);
+        bool serveMetrics(uint16_t port);
+        void stopMetricsExport();
+
+        // Camera frames (face rect drawn in) for other local processes, via
+        // a shared-memory ring handed out on a unix socket (Linux only)
+        bool startFrameExport(const std::string& socketPath);
+        void stopFrameExport();
+        bool isExportingFrames() const { return m_isExportingFrames; }
+
     private:
         // Components
         std::unique_ptr<htk::input::WebcamTracker> m_webcamTracker;
+        std::vector<std::unique_ptr<htk::input::CameraWorker>> m_cameraWorkers;
+        htk::core::PoseFusion m_fusion;
+        htk::core::ResponseMapper m_responseMapper;
+        htk::core::CpuGovernor m_cpuGovernor;
+        std::vector<htk::core::CameraEstimate> m_estimates;  // Sized at initialize()
 
 #ifdef _WIN32
         std::unique_ptr<htk::output::FreeTrackOutput> m_freeTrackOutput;
@@ -55,23 +186,98 @@ namespace htk::core {
         std::unique_ptr<std::thread> m_updateThread;
         std::atomic<bool> m_isRunning{false};
         std::atomic<bool> m_isPaused{false};
+        std::atomic<bool> m_isStandby{false};
         std::atomic<bool> m_shouldStop{false};
+        std::atomic<bool> m_isDegraded{false};
+
+        // Control commands, drained by the update thread once per frame
+        static constexpr size_t kCommandQueueSize = 64;
+        htk::core::CommandQueue<ControlCommand, kCommandQueueSize> m_commands;
 
         // Data
-        htk::core::TrackingData m_currentData;
-        htk::core::TrackingData m_centerOffset;
-        mutable std::mutex m_dataMutex;
+        htk::core::TrackingData m_currentData;  // Centered, at the output boundary
+        mutable std::mutex m_dataMutex;         // Guards m_currentData only
+        htk::core::Pose m_rawPose;              // Latest uncentered pose (update thread)
+        htk::core::Pose m_centerPose;           // (update thread)
+        bool m_isCentered{false};               // Center taken since start() (update thread)
 
-        // Settings
+        // Preview hand-off (only try-locked from the update loop)
+        cv::Mat m_previewFrame;
+        bool m_previewFresh{false};
+        std::mutex m_previewMutex;
+        std::atomic<bool> m_previewWanted{false};
+
+        // Recording (only try-locked from the update loop)
+        htk::core::SessionRecorder m_recorder;
+        std::mutex m_recorderMutex;
+        std::atomic<bool> m_isRecording{false};
+
+        // Metrics
+        htk::core::TrackingMetrics m_metrics;
+        htk::core::MetricsExporter m_metricsExporter{m_metrics};
+
+        // Frame export (only try-locked from the update loop)
+        htk::core::FrameExporter m_frameExporter;
+        std::mutex m_frameExportMutex;
+        std::atomic<bool> m_isExportingFrames{false};
+
+        // Real-time mode
+        htk::core::RealtimeSettings m_realtime;
+        htk::core::RealtimeStatus m_realtimeStatus;
+        mutable std::mutex m_realtimeMutex;
+        bool m_memoryLocked{false};
+
+        // Lifecycle state
+        bool m_isInitialized{false};
+        std::vector<CameraSetup> m_cameras;
+
+        // Settings, owned by the update thread (changed through commands);
+        // kept so cameras added later start with the same filter
         bool m_freeTrackEnabled{true};
         bool m_trackIREnabled{true};
+        float m_smoothing{0.5f};
+        float m_coastTime{0.5f};
+        float m_cpuBudgetPercent{0.0f};  // 0 when the budget was given in ms
 
         // Update loop (runs in separate thread)
         void updateLoop();
 
-        // Apply center offset to data
-        htk::core::TrackingData applyCenterOffset(
-            const htk::core::TrackingData& data
+        // Queue a command; dropped with a warning if the queue is full
+        void postCommand(const ControlCommand& command);
+
+        // Apply queued commands and curve edits (update thread, or any
+        // thread while the loop isn't running)
+        void applyCommands();
+        void applyCommand(const ControlCommand& command);
+
+        // Stop and join the update thread
+        void joinUpdateThread();
+
+        // Frame source for a camera setup, watchdog-guarded where it can hang
+        // (the watchdog's capture thread gets the capture priority/CPUs)
+        static std::unique_ptr<htk::input::FrameSource> makeSource(const CameraSetup& setup,
+                                                                   const RealtimeSettings& realtime);
+
+        // Calibration for a camera (nominal lens when none or unreadable)
+        static htk::input::CameraCalibration loadCalibration(const CameraSetup& setup);
+
+        static htk::input::ExposureSettings exposureSettings(const CameraSetup& setup);
+
+        // Primary estimate fused with the latest from every camera worker
+        htk::core::Pose fuseCameras(const htk::core::Pose& primary);
+
+        // Copy the current frame for getPreviewFrame()
+        void publishPreviewFrame();
+
+        // Append the current frame to the session file
+        void recordSample(const htk::core::TrackingData& data, uint64_t outputUs);
+
+        // Write the current frame to the export ring
+        void exportFrame(const htk::core::TrackingData& data);
+
+        // Pose relative to the recentered pose
+        htk::core::Pose applyCenterOffset(
+            const htk::core::Pose& pose
         ) const;
     };
 
@@ -0,0 +1,95 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+// Compile-time optional profiling markers. Both backends are off by default
+// and every macro then expands to nothing.
+//
+//   HTK_TRACY  Tracy zones, frame marks and thread names (-DHTK_TRACY=ON)
+//   HTK_USDT   Linux USDT probes, provider "htk" (-DHTK_USDT=ON):
+//                zone_begin(name), zone_end(name)   around every zone
+//                frame(captureUs, detectUs, poseUs, outputUs)   per tracked frame
+//              e.g. bpftrace -e 'usdt:./htk-core:htk:zone_begin { @[str(arg0)] = count(); }'
+//
+// An untraced USDT probe is a single nop; a Tracy zone costs a few
+// nanoseconds while no profiler is connected.
+
+#ifdef HTK_TRACY
+#include <tracy/Tracy.hpp>
+#endif
+
+#ifdef HTK_USDT
+#include <sys/sdt.h>
+#endif
+
+#define HTK_CONCAT_INNER(a, b) a##b
+#define HTK_CONCAT(a, b) HTK_CONCAT_INNER(a, b)
+
+#ifdef HTK_USDT
+namespace htk::core::instrumentation {
+
+    // Brackets a scope with zone_begin/zone_end probes
+    class UsdtZone {
+    public:
+        explicit UsdtZone(const char* name) : m_name(name) { DTRACE_PROBE1(htk, zone_begin, m_name); }
+        ~UsdtZone() { DTRACE_PROBE1(htk, zone_end, m_name); }
+
+        UsdtZone(const UsdtZone&) = delete;
+        UsdtZone& operator=(const UsdtZone&) = delete;
+
+    private:
+        const char* m_name;
+    };
+
+} // namespace htk::core::instrumentation
+
+#define HTK_USDT_ZONE(name) ::htk::core::instrumentation::UsdtZone HTK_CONCAT(htkUsdtZone, __LINE__)(name)
+#define HTK_USDT_FRAME(timing, outputUs) \
+    DTRACE_PROBE4(htk, frame, (timing).captureUs, (timing).detectUs, (timing).poseUs, (outputUs))
+#else
+#define HTK_USDT_ZONE(name)
+#define HTK_USDT_FRAME(timing, outputUs)
+#endif
+
+#ifdef HTK_TRACY
+#define HTK_TRACY_ZONE(name) ZoneScopedN(name)
+#define HTK_TRACY_FRAME() FrameMark
+#define HTK_THREAD_NAME(name) tracy::SetThreadName(name)
+#else
+#define HTK_TRACY_ZONE(name)
+#define HTK_TRACY_FRAME()
+#define HTK_THREAD_NAME(name)
+#endif
+
+// Calls into OpenCV that allocate internally however they are called
+// (cascade detection, template matching). Only the allocation test
+// (HTK_ALLOCATION_TEST) defines it: the rest of the enclosing scope is
+// left out of its count, everything else the tracker does must not allocate.
+#ifdef HTK_ALLOCATION_TEST
+namespace htk::core::instrumentation {
+
+    inline thread_local int opencvAllocationDepth = 0;
+
+    class OpencvAllocations {
+    public:
+        OpencvAllocations() { ++opencvAllocationDepth; }
+        ~OpencvAllocations() { --opencvAllocationDepth; }
+
+        OpencvAllocations(const OpencvAllocations&) = delete;
+        OpencvAllocations& operator=(const OpencvAllocations&) = delete;
+    };
+
+} // namespace htk::core::instrumentation
+
+#define HTK_OPENCV_ALLOCATES() ::htk::core::instrumentation::OpencvAllocations HTK_CONCAT(htkOpencvAllocations, __LINE__)
+#else
+#define HTK_OPENCV_ALLOCATES()
+#endif
+
+// Marks the rest of the enclosing scope; name must be a string literal
+#define HTK_ZONE(name) HTK_TRACY_ZONE(name); HTK_USDT_ZONE(name)
+
+// End of one tracked frame: its FrameTiming and output cost (microseconds),
+// neither evaluated unless USDT is compiled in
+#define HTK_FRAME_MARK(timing, outputUs) HTK_TRACY_FRAME(); HTK_USDT_FRAME(timing, outputUs)
+
+#endif // INSTRUMENTATION_H
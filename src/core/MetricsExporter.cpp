@@ -0,0 +1,276 @@
+#include "MetricsExporter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace htk::core {
+
+namespace {
+
+#ifdef _WIN32
+using SocketHandle = SOCKET;
+const SocketHandle kInvalidSocket = INVALID_SOCKET;
+void closeSocket(SocketHandle s) { closesocket(s); }
+#else
+using SocketHandle = int;
+const SocketHandle kInvalidSocket = -1;
+void closeSocket(SocketHandle s) { ::close(s); }
+#endif
+
+// How often loops check for stop()
+constexpr int kPollMs = 200;
+
+// A client that connects and then sends nothing, or stops reading, holds
+// the loop (and stop()) up at most this long per call
+constexpr int kClientTimeoutMs = 1000;
+
+// A client hanging up mid-response must not raise SIGPIPE
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+void setClientOptions(SocketHandle s) {
+#ifdef _WIN32
+    const DWORD timeoutMs = kClientTimeoutMs;
+    ::setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeoutMs), sizeof(timeoutMs));
+    ::setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeoutMs), sizeof(timeoutMs));
+#else
+    const timeval timeout{kClientTimeoutMs / 1000, (kClientTimeoutMs % 1000) * 1000};
+    ::setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+    const int on = 1;
+    ::setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+#endif
+}
+
+// send() until all of it is out; false once the client is gone or stalled
+bool sendAll(SocketHandle s, const char* data, size_t size) {
+    while (size > 0) {
+        const int chunk = static_cast<int>(std::min<size_t>(size, INT_MAX));
+        const auto sent = ::send(s, data, chunk, kSendFlags);
+        if (sent <= 0) {
+#ifndef _WIN32
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+#endif
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool writeFile(const std::string& path, const std::string& text) {
+    std::ofstream file(path, std::ios::trunc);
+    file << text;
+    file.close();
+    return !file.fail();
+}
+
+// Atomically: the old file stays in place until the new one takes over
+bool replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+} // namespace
+
+MetricsExporter::MetricsExporter(const TrackingMetrics& metrics)
+    : m_metrics(metrics)
+{
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::startFile(const std::string& path, int intervalMs) {
+    stop();
+
+    // Fail now rather than quietly on every interval
+    const std::string tmpPath = path + ".tmp";
+    if (!writeFile(tmpPath, "")) {
+        std::cerr << "Cannot write metrics to " << tmpPath << std::endl;
+        return false;
+    }
+    std::remove(tmpPath.c_str());
+
+    m_path = path;
+    m_intervalMs = intervalMs > 0 ? intervalMs : 1000;
+    m_shouldStop = false;
+    m_isRunning = true;
+    m_thread = std::make_unique<std::thread>(&MetricsExporter::fileLoop, this);
+
+    std::cout << "Exporting metrics to " << path << std::endl;
+    return true;
+}
+
+bool MetricsExporter::startHttp(uint16_t port) {
+    stop();
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "Failed to initialize Winsock for metrics export" << std::endl;
+        return false;
+    }
+#endif
+
+    SocketHandle listenSocket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listenSocket == kInvalidSocket) {
+        std::cerr << "Failed to create metrics socket" << std::endl;
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR,
+               reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (::bind(listenSocket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listenSocket, 4) != 0) {
+        std::cerr << "Failed to listen for metrics on 127.0.0.1:" << port << std::endl;
+        closeSocket(listenSocket);
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+
+    m_listenSocket = listenSocket;
+    m_shouldStop = false;
+    m_isRunning = true;
+    m_thread = std::make_unique<std::thread>(&MetricsExporter::httpLoop, this);
+
+    std::cout << "Serving metrics on http://127.0.0.1:" << port << "/metrics" << std::endl;
+    return true;
+}
+
+void MetricsExporter::stop() {
+    m_shouldStop = true;
+
+    if (m_thread && m_thread->joinable()) {
+        m_thread->join();
+    }
+    m_thread.reset();
+
+    closeListenSocket();
+    m_isRunning = false;
+}
+
+void MetricsExporter::fileLoop() {
+    using namespace std::chrono;
+
+    const std::string tmpPath = m_path + ".tmp";
+    auto nextWrite = steady_clock::now();
+    bool isFailing = false;
+
+    while (!m_shouldStop) {
+        if (steady_clock::now() >= nextWrite) {
+            // Scrapers must never see a half-written file: write aside, then
+            // swap it in (a failed write leaves the last good one in place)
+            const std::string text = TrackingMetrics::formatPrometheus(m_metrics.snapshot());
+            const bool written = writeFile(tmpPath, text) && replaceFile(tmpPath, m_path);
+
+            // Once per failure streak, not every interval
+            if (!written && !isFailing) {
+                std::cerr << "Failed to write metrics to " << m_path << std::endl;
+            } else if (written && isFailing) {
+                std::cout << "Writing metrics to " << m_path << " again" << std::endl;
+            }
+            isFailing = !written;
+
+            nextWrite += milliseconds(m_intervalMs);
+        }
+
+        std::this_thread::sleep_for(milliseconds(std::min(kPollMs, m_intervalMs)));
+    }
+}
+
+void MetricsExporter::httpLoop() {
+    const SocketHandle listenSocket = static_cast<SocketHandle>(m_listenSocket);
+
+    while (!m_shouldStop) {
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(listenSocket, &readSet);
+        timeval timeout{0, kPollMs * 1000};
+
+        if (::select(static_cast<int>(listenSocket) + 1, &readSet, nullptr, nullptr, &timeout) <= 0) {
+            continue;
+        }
+
+        SocketHandle client = ::accept(listenSocket, nullptr, nullptr);
+        if (client == kInvalidSocket) {
+            continue;
+        }
+
+        setClientOptions(client);
+
+        // Every request gets the metrics page; the request itself is drained
+        // (times out if the client never sends one)
+        char request[1024];
+        ::recv(client, request, sizeof(request), 0);
+
+        const std::string body = TrackingMetrics::formatPrometheus(m_metrics.snapshot());
+        char header[160];
+        const int headerLen = std::snprintf(header, sizeof(header),
+            "HTTP/1.0 200 OK\r\n"
+            "Content-Type: text/plain; version=0.0.4\r\n"
+            "Content-Length: %zu\r\n"
+            "Connection: close\r\n\r\n",
+            body.size());
+
+        if (sendAll(client, header, static_cast<size_t>(headerLen))) {
+            sendAll(client, body.data(), body.size());
+        }
+        closeSocket(client);
+    }
+}
+
+void MetricsExporter::closeListenSocket() {
+    const SocketHandle listenSocket = static_cast<SocketHandle>(m_listenSocket);
+    if (listenSocket != kInvalidSocket) {
+        closeSocket(listenSocket);
+        m_listenSocket = kInvalidSocket;
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+}
+
+} // namespace htk::core
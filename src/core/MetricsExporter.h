@@ -0,0 +1,59 @@
+#ifndef METRICSEXPORTER_H
+#define METRICSEXPORTER_H
+
+#include "TrackingMetrics.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace htk::core {
+
+    // Publishes TrackingMetrics in Prometheus text format, either by
+    // rewriting a file periodically (node_exporter textfile style) or by
+    // answering HTTP scrapes on a loopback port. Runs on its own thread and
+    // only reads the lock-free snapshot, so it never touches the tracker.
+    class MetricsExporter {
+    public:
+        explicit MetricsExporter(const TrackingMetrics& metrics);
+        ~MetricsExporter();
+
+        MetricsExporter(const MetricsExporter&) = delete;
+        MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+        // Rewrite path (atomically, via rename) every intervalMs; false when
+        // path + ".tmp" can't be written
+        bool startFile(const std::string& path, int intervalMs = 1000);
+
+        // Serve GET /metrics on 127.0.0.1:port
+        bool startHttp(uint16_t port);
+
+        void stop();
+        bool isRunning() const { return m_isRunning; }
+
+    private:
+        const TrackingMetrics& m_metrics;
+
+        std::unique_ptr<std::thread> m_thread;
+        std::atomic<bool> m_isRunning{false};
+        std::atomic<bool> m_shouldStop{false};
+
+        std::string m_path;
+        int m_intervalMs = 1000;
+
+#ifdef _WIN32
+        uintptr_t m_listenSocket = ~static_cast<uintptr_t>(0);
+#else
+        int m_listenSocket = -1;
+#endif
+
+        void fileLoop();
+        void httpLoop();
+        void closeListenSocket();
+    };
+
+} // namespace htk::core
+
+#endif // METRICSEXPORTER_H
@@ -0,0 +1,136 @@
+#include "Pose.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace htk::core {
+
+namespace {
+
+constexpr float kDegToRad = 3.14159265358979f / 180.0f;
+constexpr float kRadToDeg = 180.0f / 3.14159265358979f;
+constexpr float kHalfPi = 1.57079632679490f;
+constexpr float kPi = 3.14159265358979f;
+
+// atan2 to within 1e-5 radians (Abramowitz and Stegun 4.4.49 on the
+// octant, then unfolded), several times cheaper than std::atan2
+float fastAtan2(float y, float x) {
+    const float ax = std::fabs(x), ay = std::fabs(y);
+    const float big = std::max(ax, ay);
+    if (big == 0.0f) {
+        return 0.0f;
+    }
+    const float a = std::min(ax, ay) / big;
+
+    // Polynomial in a^2, evaluated in pairs (Estrin) to keep the chain short
+    const float s = a * a, s2 = s * s;
+    float r = a * ((0.9998660f - 0.3302995f * s) + s2 * ((0.1801410f - 0.0851330f * s) + s2 * 0.0208351f));
+    r = ay > ax ? kHalfPi - r : r;
+    r = x < 0.0f ? kPi - r : r;
+    return std::copysign(r, y);
+}
+
+// asin to within 2e-8 radians (Abramowitz and Stegun 4.4.46): a square
+// root and a polynomial, no division
+float fastAsin(float x) {
+    const float a = std::fabs(x);
+    const float a2 = a * a, a4 = a2 * a2;
+    const float p = ((1.5707963050f - 0.2145988016f * a) + a2 * (0.0889789874f - 0.0501743046f * a)) +
+                    a4 * ((0.0308918810f - 0.0170881256f * a) + a2 * (0.0066700901f - 0.0012624911f * a));
+    return std::copysign(kHalfPi - std::sqrt(1.0f - a) * p, x);
+}
+
+// Ry * Rx * Rz multiplied out on the half angles: no intermediate
+// quaternion products
+Eigen::Quaternionf composeHalfAngles(float cy, float sy, float cp, float sp, float cr, float sr) {
+    return Eigen::Quaternionf(cy * cp * cr + sy * sp * sr,   // w
+                              cy * sp * cr + sy * cp * sr,   // x
+                              sy * cp * cr - cy * sp * sr,   // y
+                              cy * cp * sr - sy * sp * cr);  // z
+}
+
+// Half of an angle given as a direction points along the direction plus
+// the x axis, both at unit length: (|v| + x, y), left unnormalized
+void halfAngle(const Eigen::Vector2f& direction, float& c, float& s) {
+    c = std::sqrt(direction.x() * direction.x() + direction.y() * direction.y()) + direction.x();
+    s = direction.y();
+}
+
+} // namespace
+
+TrackingData Pose::toTrackingData() const {
+    TrackingData data;
+    rotationToEuler(rotation, data.yaw, data.pitch, data.roll);
+    data.x = translation.x();
+    data.y = translation.y();
+    data.z = translation.z();
+    data.timestamp  = timestamp;
+    data.confidence = confidence;
+    data.isValid    = isValid;
+    return data;
+}
+
+Pose Pose::fromTrackingData(const TrackingData& data) {
+    Pose pose;
+    pose.rotation    = rotationFromEuler(data.yaw, data.pitch, data.roll);
+    pose.translation = Eigen::Vector3f(data.x, data.y, data.z);
+    pose.timestamp   = data.timestamp;
+    pose.confidence  = data.confidence;
+    pose.isValid     = data.isValid;
+    return pose;
+}
+
+Eigen::Quaternionf rotationFromEuler(float yaw, float pitch, float roll) {
+    const float hy = 0.5f * yaw * kDegToRad;
+    const float hp = 0.5f * pitch * kDegToRad;
+    const float hr = 0.5f * roll * kDegToRad;
+    return composeHalfAngles(std::cos(hy), std::sin(hy), std::cos(hp), std::sin(hp), std::cos(hr), std::sin(hr));
+}
+
+Eigen::Quaternionf rotationFromDirections(const Eigen::Vector2f& yaw, const Eigen::Vector2f& pitch,
+                                          const Eigen::Vector2f& roll) {
+    float cy, sy, cp, sp, cr, sr;
+    halfAngle(yaw, cy, sy);
+    halfAngle(pitch, cp, sp);
+    halfAngle(roll, cr, sr);
+
+    // Each unnormalized pair only scales the product: normalize once
+    const Eigen::Quaternionf q = composeHalfAngles(cy, sy, cp, sp, cr, sr);
+    const float inverse = 1.0f / std::sqrt(q.w() * q.w() + q.x() * q.x() + q.y() * q.y() + q.z() * q.z());
+    return Eigen::Quaternionf(q.w() * inverse, q.x() * inverse, q.y() * inverse, q.z() * inverse);
+}
+
+void rotationToEuler(const Eigen::Quaternionf& rotation, float& yaw, float& pitch, float& roll) {
+    // R = Ry(yaw) * Rx(pitch) * Rz(roll), reading only the five matrix
+    // entries needed straight off the quaternion
+    const float w = rotation.w(), x = rotation.x(), y = rotation.y(), z = rotation.z();
+    const float r02 = 2.0f * (x * z + w * y);
+    const float r12 = 2.0f * (y * z - w * x);
+    const float r22 = 1.0f - 2.0f * (x * x + y * y);
+    const float r10 = 2.0f * (x * y + w * z);
+    const float r11 = 1.0f - 2.0f * (x * x + z * z);
+
+    pitch = fastAsin(std::clamp(-r12, -1.0f, 1.0f)) * kRadToDeg;
+    yaw   = fastAtan2(r02, r22) * kRadToDeg;
+    roll  = fastAtan2(r10, r11) * kRadToDeg;
+}
+
+Eigen::Vector3f rotationBetween(const Eigen::Quaternionf& from, const Eigen::Quaternionf& to) {
+    Eigen::Quaternionf delta = to * from.conjugate();
+    if (delta.w() < 0.0f) {
+        delta.coeffs() = -delta.coeffs();  // Shortest way round
+    }
+
+    const Eigen::AngleAxisf angleAxis(delta);
+    return angleAxis.axis() * angleAxis.angle();
+}
+
+Eigen::Quaternionf rotationFromVector(const Eigen::Vector3f& rotationVector) {
+    const float angle = rotationVector.norm();
+    if (angle < 1e-9f) {
+        return Eigen::Quaternionf::Identity();
+    }
+    return Eigen::Quaternionf(Eigen::AngleAxisf(angle, rotationVector / angle));
+}
+
+} // namespace htk::core
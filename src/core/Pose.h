@@ -0,0 +1,105 @@
+#ifndef POSE_H
+#define POSE_H
+
+#include "TrackingData.h"
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include <cmath>
+#include <cstdint>
+
+namespace htk::core {
+
+    // Internal pose representation. Rotations stay quaternions through
+    // filtering, prediction, fusion and centering; Euler angles only exist
+    // in TrackingData at the output boundary.
+    //
+    // Rotation: yaw about y, then pitch about x, then roll about z
+    // (R = Ry * Rx * Rz). Translation: mm in camera coordinates as seen in
+    // the image (x right, y down, z away from the camera).
+    struct Pose {
+        Eigen::Quaternionf rotation = Eigen::Quaternionf::Identity();
+        Eigen::Vector3f translation = Eigen::Vector3f::Zero();  // mm
+
+        uint64_t timestamp = 0;  // Microseconds since epoch
+        float confidence = 0.0f;
+        bool isValid = false;
+
+        void reset() {
+            rotation.setIdentity();
+            translation.setZero();
+            confidence = 0.0f;
+            isValid = false;
+        }
+
+        // Boundary conversions
+        TrackingData toTrackingData() const;
+        static Pose fromTrackingData(const TrackingData& data);
+    };
+
+    // Degrees in, unit quaternion out (and back)
+    Eigen::Quaternionf rotationFromEuler(float yaw, float pitch, float roll);
+    void rotationToEuler(const Eigen::Quaternionf& rotation, float& yaw, float& pitch, float& roll);
+
+    // The same rotation straight from what the tracker measures: each
+    // angle as a direction (cos, sin) times any positive length, e.g. yaw
+    // from a ray's slope as (1, -x). Square roots only, no trig. Angles
+    // must be short of +-180 degrees.
+    Eigen::Quaternionf rotationFromDirections(const Eigen::Vector2f& yaw, const Eigen::Vector2f& pitch,
+                                              const Eigen::Vector2f& roll);
+
+    // The per-frame quaternion arithmetic below is spelled out on scalars.
+    // Eigen's packet versions reload quaternions that were just written
+    // lane by lane, and the store-forwarding stall costs more than the
+    // arithmetic itself.
+
+    // a * b: b's rotation, then a's
+    inline Eigen::Quaternionf multiply(const Eigen::Quaternionf& a, const Eigen::Quaternionf& b) {
+        return Eigen::Quaternionf(a.w() * b.w() - a.x() * b.x() - a.y() * b.y() - a.z() * b.z(),
+                                  a.w() * b.x() + a.x() * b.w() + a.y() * b.z() - a.z() * b.y(),
+                                  a.w() * b.y() - a.x() * b.z() + a.y() * b.w() + a.z() * b.x(),
+                                  a.w() * b.z() + a.x() * b.y() - a.y() * b.x() + a.z() * b.w());
+    }
+
+    // Unit quaternion q applied to v
+    inline Eigen::Vector3f rotate(const Eigen::Quaternionf& q, const Eigen::Vector3f& v) {
+        // v + 2w (u x v) + 2 u x (u x v), with t = 2 (u x v)
+        const float tx = 2.0f * (q.y() * v.z() - q.z() * v.y());
+        const float ty = 2.0f * (q.z() * v.x() - q.x() * v.z());
+        const float tz = 2.0f * (q.x() * v.y() - q.y() * v.x());
+        return Eigen::Vector3f(v.x() + q.w() * tx + q.y() * tz - q.z() * ty,
+                               v.y() + q.w() * ty + q.z() * tx - q.x() * tz,
+                               v.z() + q.w() * tz + q.x() * ty - q.y() * tx);
+    }
+
+    // Per-frame blend from toward to (normalized lerp, the shorter way
+    // round). Close enough to slerp for the small steps between frames.
+    inline Eigen::Quaternionf blendRotation(const Eigen::Quaternionf& from, const Eigen::Quaternionf& to, float t) {
+        // Both are unit length, so the blend's length follows from their
+        // dot product alone, worked out alongside the blend itself
+        const float dot = from.w() * to.w() + from.x() * to.x() + from.y() * to.y() + from.z() * to.z();
+        const float u = 1.0f - t;
+        const float v = dot < 0.0f ? -t : t;
+        const float inverse = 1.0f / std::sqrt(u * u + t * t + 2.0f * u * t * std::fabs(dot));
+        return Eigen::Quaternionf((u * from.w() + v * to.w()) * inverse, (u * from.x() + v * to.x()) * inverse,
+                                  (u * from.y() + v * to.y()) * inverse, (u * from.z() + v * to.z()) * inverse);
+    }
+
+    // First-order rotation for a small rotation vector (radians): no exp
+    // map, a few percent short at half a radian
+    inline Eigen::Quaternionf rotationStep(const Eigen::Vector3f& rotationVector) {
+        const float x = 0.5f * rotationVector.x(), y = 0.5f * rotationVector.y(), z = 0.5f * rotationVector.z();
+        const float inverse = 1.0f / std::sqrt(1.0f + x * x + y * y + z * z);
+        return Eigen::Quaternionf(inverse, x * inverse, y * inverse, z * inverse);
+    }
+
+    // Rotation vector (axis * angle, radians) taking from to to
+    Eigen::Vector3f rotationBetween(const Eigen::Quaternionf& from, const Eigen::Quaternionf& to);
+
+    // Quaternion for a rotation vector (axis * angle, radians)
+    Eigen::Quaternionf rotationFromVector(const Eigen::Vector3f& rotationVector);
+
+} // namespace htk::core
+
+#endif // POSE_H
@@ -0,0 +1,81 @@
+#include "PoseFusion.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace htk::core {
+
+Pose PoseFusion::toPrimaryFrame(const CameraEstimate& estimate) {
+    Pose result = estimate.pose;
+
+    if (!estimate.isMounted) {
+        return result;
+    }
+
+    // The head as seen from this camera, then from the primary camera
+    result.rotation    = multiply(estimate.mount, result.rotation);
+    result.translation = rotate(estimate.mount, result.translation) + estimate.mountOffset;
+    return result;
+}
+
+Pose PoseFusion::fuse(const CameraEstimate* estimates, size_t count) const {
+    Pose result;
+
+    if (count == 0) {
+        return result;
+    }
+
+    // Freshness is judged against the newest estimate
+    uint64_t newest = 0;
+    for (size_t i = 0; i < count; ++i) {
+        newest = std::max(newest, estimates[i].pose.timestamp);
+    }
+    result.timestamp = newest;
+
+    // Weighted quaternion mean: close rotations average well component-wise
+    // once they all sit in the same hemisphere, then renormalize
+    float totalWeight = 0.0f;
+    float rotationSum[4] = {0.0f, 0.0f, 0.0f, 0.0f};  // w, x, y, z
+    Eigen::Vector3f translationSum = Eigen::Vector3f::Zero();
+
+    for (size_t i = 0; i < count; ++i) {
+        const Pose& raw = estimates[i].pose;
+        if (!raw.isValid || raw.confidence <= 0.0f || newest - raw.timestamp > m_maxAgeUs) {
+            continue;
+        }
+
+        // Into the primary frame (toPrimaryFrame, without copying the pose)
+        const CameraEstimate& estimate = estimates[i];
+        const Eigen::Quaternionf q = estimate.isMounted ? multiply(estimate.mount, raw.rotation) : raw.rotation;
+        const Eigen::Vector3f translation = estimate.isMounted
+            ? Eigen::Vector3f(rotate(estimate.mount, raw.translation) + estimate.mountOffset)
+            : raw.translation;
+        const float w = raw.confidence;
+
+        const float dot = q.w() * rotationSum[0] + q.x() * rotationSum[1] + q.y() * rotationSum[2] +
+                          q.z() * rotationSum[3];
+        const float signedWeight = dot < 0.0f ? -w : w;
+
+        rotationSum[0] += signedWeight * q.w();
+        rotationSum[1] += signedWeight * q.x();
+        rotationSum[2] += signedWeight * q.y();
+        rotationSum[3] += signedWeight * q.z();
+        translationSum += w * translation;
+        totalWeight    += w;
+        result.confidence = std::max(result.confidence, raw.confidence);
+    }
+
+    if (totalWeight <= 0.0f) {
+        return result;
+    }
+
+    const float inverse = 1.0f / std::sqrt(rotationSum[0] * rotationSum[0] + rotationSum[1] * rotationSum[1] +
+                                           rotationSum[2] * rotationSum[2] + rotationSum[3] * rotationSum[3]);
+    result.rotation = Eigen::Quaternionf(rotationSum[0] * inverse, rotationSum[1] * inverse,
+                                         rotationSum[2] * inverse, rotationSum[3] * inverse);
+    result.translation = translationSum * (1.0f / totalWeight);
+    result.isValid = true;
+    return result;
+}
+
+} // namespace htk::core
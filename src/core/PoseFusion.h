@@ -0,0 +1,49 @@
+#ifndef POSEFUSION_H
+#define POSEFUSION_H
+
+#include "Pose.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace htk::core {
+
+    // One camera's pose estimate plus how that camera is mounted relative
+    // to the primary camera: the rotation taking its estimate into the
+    // primary frame, and where it sits in that frame
+    struct CameraEstimate {
+        Pose pose;
+        Eigen::Quaternionf mount = Eigen::Quaternionf::Identity();
+        Eigen::Vector3f mountOffset = Eigen::Vector3f::Zero();  // mm
+        bool isMounted = false;
+
+        // Degrees and mm; the rotation is built once here instead of on
+        // every fuse()
+        void setMount(float yaw, float pitch, const Eigen::Vector3f& offset = Eigen::Vector3f::Zero()) {
+            mount = rotationFromEuler(yaw, pitch, 0.0f);
+            mountOffset = offset;
+            isMounted = yaw != 0.0f || pitch != 0.0f || !offset.isZero(0.0f);
+        }
+    };
+
+    // Confidence-weighted fusion of per-camera pose estimates into one pose
+    // in the primary camera's frame
+    class PoseFusion {
+    public:
+        PoseFusion() = default;
+
+        // Estimates older than this (relative to the newest) are ignored
+        void setMaxAge(uint64_t micros) { m_maxAgeUs = micros; }
+
+        Pose fuse(const CameraEstimate* estimates, size_t count) const;
+
+        // Move one estimate from its camera frame into the primary frame
+        static Pose toPrimaryFrame(const CameraEstimate& estimate);
+
+    private:
+        uint64_t m_maxAgeUs = 100000;
+    };
+
+} // namespace htk::core
+
+#endif // POSEFUSION_H
@@ -0,0 +1,114 @@
+#include "Realtime.h"
+
+#ifdef __linux__
+#include <alloca.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace htk::core::realtime {
+
+#ifdef __linux__
+
+RealtimeStatus applyToCurrentThread(int priority, bool roundRobin, const std::vector<int>& cpus) {
+    RealtimeStatus status;
+    const int policy = roundRobin ? SCHED_RR : SCHED_FIFO;
+
+    sched_param param{};
+    param.sched_priority = std::clamp(priority, sched_get_priority_min(policy), sched_get_priority_max(policy));
+
+    const int err = pthread_setschedparam(pthread_self(), policy, &param);
+    if (err == 0) {
+        status.scheduled = true;
+    } else if (err == EPERM) {
+        status.message = "real-time scheduling not permitted (needs CAP_SYS_NICE or an rtprio limit), "
+                         "running at normal priority";
+    } else {
+        status.message = std::string("pthread_setschedparam failed: ") + std::strerror(err);
+    }
+
+    if (!cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+            }
+        }
+
+        const int affinityErr = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (affinityErr == 0) {
+            status.pinned = true;
+        } else {
+            if (!status.message.empty()) {
+                status.message += "; ";
+            }
+            status.message += std::string("CPU pinning failed: ") + std::strerror(affinityErr);
+        }
+    }
+
+    return status;
+}
+
+bool lockMemory(std::string& error) {
+    // With a finite memlock limit, MCL_FUTURE turns every allocation past
+    // the limit into a failure, so lock only what is mapped now
+    rlimit limit{};
+    const bool unlimited = geteuid() == 0 ||
+        (getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur == RLIM_INFINITY);
+    const int flags = unlimited ? (MCL_CURRENT | MCL_FUTURE) : MCL_CURRENT;
+
+    if (mlockall(flags) != 0) {
+        error = errno == ENOMEM || errno == EPERM
+            ? "memory locking not permitted (raise the memlock limit or grant CAP_IPC_LOCK)"
+            : std::string("mlockall failed: ") + std::strerror(errno);
+        return false;
+    }
+
+    if (!unlimited) {
+        error = "memlock limit is finite: locked current pages only";
+    }
+    return true;
+}
+
+void unlockMemory() {
+    munlockall();
+}
+
+void prefaultStack(size_t bytes) {
+    volatile char* stack = static_cast<volatile char*>(alloca(bytes));
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    for (size_t i = 0; i < bytes; i += page) {
+        stack[i] = 0;
+    }
+}
+
+#else
+
+RealtimeStatus applyToCurrentThread(int, bool, const std::vector<int>&) {
+    RealtimeStatus status;
+    status.message = "real-time scheduling is only supported on Linux";
+    return status;
+}
+
+bool lockMemory(std::string& error) {
+    error = "memory locking is only supported on Linux";
+    return false;
+}
+
+void unlockMemory() {
+}
+
+void prefaultStack(size_t) {
+}
+
+#endif
+
+} // namespace htk::core::realtime
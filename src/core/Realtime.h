@@ -0,0 +1,55 @@
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace htk::core {
+
+    // Opt-in real-time mode for the tracking and capture threads (Linux)
+    struct RealtimeSettings {
+        bool enabled = false;
+        bool roundRobin = false;        // SCHED_RR instead of SCHED_FIFO
+        int trackingPriority = 10;      // Update thread, 1-99
+        int capturePriority  = 9;       // Camera worker threads
+        std::vector<int> trackingCpus;  // Empty = any CPU
+        std::vector<int> captureCpus;
+        bool lockMemory = true;         // mlockall() the process
+    };
+
+    // What a thread actually got; message explains anything missing
+    struct RealtimeStatus {
+        bool scheduled = false;
+        bool pinned = false;
+        bool memoryLocked = false;
+        std::string message;
+
+        // Capture threads (camera watchdogs and extra camera workers), as
+        // reported with the update thread's status: how many have started
+        // and how many of those got the capture priority
+        int captureThreads = 0;
+        int captureScheduled = 0;
+    };
+
+    namespace realtime {
+
+        // Switch the calling thread to real-time scheduling and pin it to
+        // cpus (if any). Missing privileges leave the thread as it was and
+        // say so in the status.
+        RealtimeStatus applyToCurrentThread(int priority, bool roundRobin, const std::vector<int>& cpus);
+
+        // Lock current and future pages of the process. Only locks future
+        // pages when the memlock limit can't make later allocations fail.
+        bool lockMemory(std::string& error);
+        void unlockMemory();
+
+        // Touch the calling thread's stack so page faults happen now rather
+        // than on the first deep call in the loop
+        void prefaultStack(size_t bytes = 256 * 1024);
+
+    } // namespace realtime
+
+} // namespace htk::core
+
+#endif // REALTIME_H
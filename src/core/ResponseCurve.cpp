@@ -0,0 +1,192 @@
+#include "ResponseCurve.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace htk::core {
+
+namespace {
+
+// Monotone cubic (Fritsch-Carlson) through sorted control points, so a
+// rising curve never overshoots into a dip between points
+class MonotoneSpline {
+public:
+    explicit MonotoneSpline(std::vector<std::pair<float, float>> points)
+        : m_points(std::move(points))
+    {
+        std::sort(m_points.begin(), m_points.end());
+        const size_t n = m_points.size();
+        m_tangents.assign(n, 0.0f);
+        if (n < 2) {
+            return;
+        }
+
+        std::vector<float> secants(n - 1);
+        for (size_t k = 0; k + 1 < n; ++k) {
+            const float dx = m_points[k + 1].first - m_points[k].first;
+            secants[k] = dx > 0.0f ? (m_points[k + 1].second - m_points[k].second) / dx : 0.0f;
+        }
+
+        m_tangents[0] = secants[0];
+        m_tangents[n - 1] = secants[n - 2];
+        for (size_t k = 1; k + 1 < n; ++k) {
+            m_tangents[k] = secants[k - 1] * secants[k] > 0.0f
+                ? 0.5f * (secants[k - 1] + secants[k])
+                : 0.0f;
+        }
+
+        for (size_t k = 0; k + 1 < n; ++k) {
+            if (secants[k] == 0.0f) {
+                m_tangents[k] = m_tangents[k + 1] = 0.0f;
+                continue;
+            }
+            const float a = m_tangents[k] / secants[k];
+            const float b = m_tangents[k + 1] / secants[k];
+            const float h = a * a + b * b;
+            if (h > 9.0f) {
+                const float tau = 3.0f / std::sqrt(h);
+                m_tangents[k]     = tau * a * secants[k];
+                m_tangents[k + 1] = tau * b * secants[k];
+            }
+        }
+    }
+
+    float operator()(float x) const {
+        const size_t n = m_points.size();
+        if (n == 0) {
+            return x;
+        }
+        if (n == 1) {
+            return m_points[0].second;
+        }
+
+        // Linear extrapolation past the ends
+        if (x <= m_points.front().first) {
+            return m_points.front().second + m_tangents.front() * (x - m_points.front().first);
+        }
+        if (x >= m_points.back().first) {
+            return m_points.back().second + m_tangents.back() * (x - m_points.back().first);
+        }
+
+        size_t k = 0;
+        while (x > m_points[k + 1].first) {
+            ++k;
+        }
+
+        const float x0 = m_points[k].first,     y0 = m_points[k].second;
+        const float x1 = m_points[k + 1].first, y1 = m_points[k + 1].second;
+        const float h = x1 - x0;
+        const float t = (x - x0) / h;
+        const float t2 = t * t, t3 = t2 * t;
+
+        return (2 * t3 - 3 * t2 + 1) * y0 + (t3 - 2 * t2 + t) * h * m_tangents[k] +
+               (-2 * t3 + 3 * t2) * y1 + (t3 - t2) * h * m_tangents[k + 1];
+    }
+
+private:
+    std::vector<std::pair<float, float>> m_points;
+    std::vector<float> m_tangents;
+};
+
+} // namespace
+
+void ResponseTable::compile(const ResponseCurve& curve, PoseAxis axis) {
+    // An unconfigured axis must not clamp: uncentered Z is the camera
+    // distance, well past the default range
+    passThrough = curve.isIdentity();
+    if (passThrough) {
+        return;
+    }
+
+    const float range = curve.inputRange > 0.0f ? curve.inputRange : ResponseCurve::defaultRange(axis);
+    const float deadzone = std::clamp(curve.deadzone, 0.0f, range * 0.99f);
+
+    std::vector<std::pair<float, float>> points = curve.points;
+    if (curve.symmetric && !points.empty()) {
+        // Mirrored curves must pass through the origin
+        points.erase(std::remove_if(points.begin(), points.end(),
+                                    [](const auto& p) { return p.first <= 0.0f; }),
+                     points.end());
+        points.insert(points.begin(), {0.0f, 0.0f});
+    }
+    const MonotoneSpline spline(std::move(points));
+
+    inputMin = -range;
+    invStep  = static_cast<float>(kSize) / (2.0f * range);
+
+    for (int i = 0; i <= kSize; ++i) {
+        const float input = inputMin + static_cast<float>(i) / invStep;
+
+        // Deadzone rescales the rest of the range so there is no step at its edge
+        const float magnitude = std::max(std::fabs(input) - deadzone, 0.0f) * range / (range - deadzone);
+        const float shaped = std::copysign(magnitude, input);
+
+        const float output = curve.symmetric
+            ? std::copysign(spline(magnitude), input)
+            : spline(shaped);
+
+        values[i] = output * curve.sensitivity;
+    }
+}
+
+ResponseMapper::ResponseMapper() {
+    // Identity tables until configured
+    auto tables = std::make_unique<TableSet>();
+    for (int axis = 0; axis < kPoseAxisCount; ++axis) {
+        (*tables)[axis].compile(m_curves[axis], static_cast<PoseAxis>(axis));
+    }
+    m_active = std::move(tables);
+}
+
+ResponseMapper::~ResponseMapper() {
+    delete m_pending.exchange(nullptr);
+    delete m_retired.exchange(nullptr);
+}
+
+void ResponseMapper::setCurve(PoseAxis axis, const ResponseCurve& curve) {
+    std::lock_guard<std::mutex> lock(m_curvesMutex);
+    m_curves[static_cast<int>(axis)] = curve;
+
+    // The set the tracking thread swapped out last time is freed here, not there
+    delete m_retired.exchange(nullptr, std::memory_order_acquire);
+
+    // Compile the whole set here, off the tracking thread
+    auto tables = std::make_unique<TableSet>();
+    for (int i = 0; i < kPoseAxisCount; ++i) {
+        (*tables)[i].compile(m_curves[i], static_cast<PoseAxis>(i));
+    }
+
+    // Replaces (and frees) any set the tracking thread hasn't picked up yet
+    delete m_pending.exchange(tables.release(), std::memory_order_acq_rel);
+}
+
+ResponseCurve ResponseMapper::getCurve(PoseAxis axis) const {
+    std::lock_guard<std::mutex> lock(m_curvesMutex);
+    return m_curves[static_cast<int>(axis)];
+}
+
+void ResponseMapper::applyPending() {
+    // Only one set is handed back at a time. setCurve() collects it before
+    // publishing the next, so this only waits when racing that call.
+    if (m_retired.load(std::memory_order_acquire) != nullptr) {
+        return;
+    }
+    if (TableSet* updated = m_pending.exchange(nullptr, std::memory_order_acquire)) {
+        m_retired.store(m_active.release(), std::memory_order_release);
+        m_active.reset(updated);
+    }
+}
+
+TrackingData ResponseMapper::apply(const TrackingData& data) {
+    const TableSet& tables = *m_active;
+    TrackingData result = data;
+    result.yaw   = tables[0].evaluate(data.yaw);
+    result.pitch = tables[1].evaluate(data.pitch);
+    result.roll  = tables[2].evaluate(data.roll);
+    result.x     = tables[3].evaluate(data.x);
+    result.y     = tables[4].evaluate(data.y);
+    result.z     = tables[5].evaluate(data.z);
+    return result;
+}
+
+} // namespace htk::core
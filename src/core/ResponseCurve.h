@@ -0,0 +1,106 @@
+#ifndef RESPONSECURVE_H
+#define RESPONSECURVE_H
+
+#include "TrackingData.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace htk::core {
+
+    enum class PoseAxis { Yaw = 0, Pitch, Roll, X, Y, Z };
+    constexpr int kPoseAxisCount = 6;
+
+    // Per-axis mapping from centered pose to output, as configured by the user
+    struct ResponseCurve {
+        // Spline control points (input, output). With symmetric set, only
+        // inputs >= 0 are given and negative inputs mirror them. Empty means
+        // a straight line.
+        std::vector<std::pair<float, float>> points;
+        bool symmetric = true;
+
+        float deadzone    = 0.0f;  // |input| below this maps to 0
+        float sensitivity = 1.0f;  // Output multiplier
+        float inputRange  = 0.0f;  // Table covers [-range, range]; 0 = axis default
+
+        // Nothing configured: the axis passes through unchanged, at any range
+        bool isIdentity() const {
+            return points.empty() && deadzone == 0.0f && sensitivity == 1.0f;
+        }
+
+        // Degrees for rotations, millimeters for translations
+        static float defaultRange(PoseAxis axis) {
+            return static_cast<int>(axis) < 3 ? 180.0f : 500.0f;
+        }
+    };
+
+    // Dense lookup table compiled from a ResponseCurve
+    struct ResponseTable {
+        static constexpr int kSize = 1024;
+
+        float inputMin = 0.0f;
+        float invStep  = 0.0f;
+        std::array<float, kSize + 1> values{};  // +1 so i + 1 is always valid
+        bool passThrough = false;               // Identity curve: no table, no clamp
+
+        void compile(const ResponseCurve& curve, PoseAxis axis);
+
+        // Clamped table lookup with linear interpolation
+        float evaluate(float input) const {
+            if (passThrough) {
+                return input;
+            }
+            const float t = std::min(std::max((input - inputMin) * invStep, 0.0f),
+                                     static_cast<float>(kSize) - 1e-3f);
+            const int i = static_cast<int>(t);
+            const float frac = t - static_cast<float>(i);
+            return values[i] + frac * (values[i + 1] - values[i]);
+        }
+    };
+
+    // Maps centered poses through the per-axis tables. setCurve() compiles on
+    // the caller's thread and hands the finished tables over through one
+    // atomic pointer; applyPending() (tracking thread, at a frame start)
+    // swaps them in and hands the old set back to be freed by the next
+    // setCurve(), so curve edits never stall tracking or free memory on it.
+    class ResponseMapper {
+    public:
+        ResponseMapper();
+        ~ResponseMapper();
+
+        ResponseMapper(const ResponseMapper&) = delete;
+        ResponseMapper& operator=(const ResponseMapper&) = delete;
+
+        // Control side (any thread)
+        void setCurve(PoseAxis axis, const ResponseCurve& curve);
+        ResponseCurve getCurve(PoseAxis axis) const;
+
+        // Tracking thread
+        void applyPending();
+        TrackingData apply(const TrackingData& data);
+
+    private:
+        using TableSet = std::array<ResponseTable, kPoseAxisCount>;
+
+        // Control side copy of the configuration
+        std::array<ResponseCurve, kPoseAxisCount> m_curves;
+        mutable std::mutex m_curvesMutex;
+
+        // Compiled tables waiting for the tracking thread
+        std::atomic<TableSet*> m_pending{nullptr};
+
+        // Tables the tracking thread swapped out, for the control side to free
+        std::atomic<TableSet*> m_retired{nullptr};
+
+        // Tables in use (tracking thread only)
+        std::unique_ptr<TableSet> m_active;
+    };
+
+} // namespace htk::core
+
+#endif // RESPONSECURVE_H
@@ -0,0 +1,109 @@
+#ifndef SESSIONFORMAT_H
+#define SESSIONFORMAT_H
+
+#include "TrackingData.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+namespace htk::core {
+
+    // One recorded frame: output pose, stage costs and detection rect
+    struct SessionSample {
+        TrackingData data;
+        FrameTiming timing;
+
+        // Detection rect in camera pixels (0 when nothing detected)
+        int32_t rectX = 0;
+        int32_t rectY = 0;
+        int32_t rectW = 0;
+        int32_t rectH = 0;
+    };
+
+    // Session file layout (.htks)
+    //
+    //   SessionFileHeader            fixed 64 bytes, little endian
+    //   record*                      variable length, delta encoded
+    //
+    // Record:
+    //   u8      flags                kRecordMarker always set; a zero byte ends the stream
+    //   varint  timestamp delta      microseconds since previous record
+    //   6 x     zigzag varint        quantized pose delta (yaw, pitch, roll, x, y, z)
+    //   u8      confidence           0..255
+    //   4 x     varint               capture, detect, pose, output stage cost in microseconds
+    //   4 x     zigzag varint        rect delta (x, y, w, h), only if kFlagRect
+    namespace session {
+
+        constexpr char kMagic[8] = {'H', 'T', 'K', 'S', 'E', 'S', 'S', '1'};
+        constexpr uint16_t kVersion = 1;
+
+        constexpr uint8_t kRecordMarker = 0x80;
+        constexpr uint8_t kFlagValid    = 0x01;
+        constexpr uint8_t kFlagRect     = 0x02;
+
+        // Quantization steps: 0.01 degree, 0.1 mm
+        constexpr float kAngleScale       = 100.0f;
+        constexpr float kTranslationScale = 10.0f;
+
+        // Upper bound of one encoded record, used to keep headroom in the map
+        constexpr size_t kMaxRecordSize = 1 + 10 + 6 * 5 + 1 + 4 * 5 + 4 * 5;
+
+        struct SessionFileHeader {
+            char magic[8];
+            uint16_t version;
+            uint16_t headerSize;
+            float angleScale;
+            float translationScale;
+            uint32_t reserved0;
+            uint64_t startTimestamp;  // Microseconds since epoch of first record baseline
+            uint8_t reserved[32];
+        };
+        static_assert(sizeof(SessionFileHeader) == 64, "session header must stay 64 bytes");
+
+        // Quantized state the deltas are taken against
+        struct QuantizedState {
+            uint64_t timestamp = 0;
+            int32_t pose[6] = {0, 0, 0, 0, 0, 0};
+            int32_t rect[4] = {0, 0, 0, 0};
+        };
+
+        inline int32_t quantize(float value, float scale) {
+            return static_cast<int32_t>(std::lround(value * scale));
+        }
+
+        inline uint32_t zigzag(int32_t v) {
+            return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+        }
+
+        inline int32_t unzigzag(uint32_t v) {
+            return static_cast<int32_t>(v >> 1) ^ -static_cast<int32_t>(v & 1);
+        }
+
+        inline uint8_t* writeVarint(uint8_t* out, uint64_t v) {
+            while (v >= 0x80) {
+                *out++ = static_cast<uint8_t>(v | 0x80);
+                v >>= 7;
+            }
+            *out++ = static_cast<uint8_t>(v);
+            return out;
+        }
+
+        // Returns nullptr if the varint runs past end
+        inline const uint8_t* readVarint(const uint8_t* in, const uint8_t* end, uint64_t& v) {
+            v = 0;
+            for (int shift = 0; in < end && shift < 64; shift += 7) {
+                const uint8_t byte = *in++;
+                v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) {
+                    return in;
+                }
+            }
+            return nullptr;
+        }
+
+    } // namespace session
+
+} // namespace htk::core
+
+#endif // SESSIONFORMAT_H
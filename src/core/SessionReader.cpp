@@ -0,0 +1,118 @@
+#include "SessionReader.h"
+
+#include <fstream>
+#include <iostream>
+#include <cstring>
+
+namespace htk::core {
+
+using namespace session;
+
+bool SessionReader::open(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        std::cerr << "Failed to open session file " << path << std::endl;
+        return false;
+    }
+
+    const std::streamsize size = file.tellg();
+    if (size < static_cast<std::streamsize>(sizeof(SessionFileHeader))) {
+        std::cerr << "Session file too small: " << path << std::endl;
+        return false;
+    }
+
+    m_buffer.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(m_buffer.data()), size)) {
+        std::cerr << "Failed to read session file " << path << std::endl;
+        return false;
+    }
+
+    std::memcpy(&m_header, m_buffer.data(), sizeof(m_header));
+    if (std::memcmp(m_header.magic, kMagic, sizeof(kMagic)) != 0) {
+        std::cerr << "Not a session file: " << path << std::endl;
+        return false;
+    }
+    if (m_header.version != kVersion) {
+        std::cerr << "Unsupported session version " << m_header.version << std::endl;
+        return false;
+    }
+
+    rewind();
+    return true;
+}
+
+void SessionReader::rewind() {
+    m_readPos = m_header.headerSize;
+    m_prev = QuantizedState{};
+    m_prev.timestamp = m_header.startTimestamp;
+}
+
+bool SessionReader::next(SessionSample& sample) {
+    const uint8_t* const begin = m_buffer.data();
+    const uint8_t* const end   = begin + m_buffer.size();
+    const uint8_t* in          = begin + m_readPos;
+
+    if (in >= end || (*in & kRecordMarker) == 0) {
+        return false;
+    }
+
+    const uint8_t flags = *in++;
+    uint64_t v = 0;
+
+    if ((in = readVarint(in, end, v)) == nullptr) return false;
+    const uint64_t timestamp = m_prev.timestamp + v;
+
+    int32_t pose[6];
+    for (int i = 0; i < 6; ++i) {
+        if ((in = readVarint(in, end, v)) == nullptr) return false;
+        pose[i] = m_prev.pose[i] + unzigzag(static_cast<uint32_t>(v));
+    }
+
+    if (in >= end) return false;
+    const uint8_t confidence = *in++;
+
+    uint32_t stages[4];
+    for (uint32_t& stage : stages) {
+        if ((in = readVarint(in, end, v)) == nullptr) return false;
+        stage = static_cast<uint32_t>(v);
+    }
+
+    int32_t rect[4] = { m_prev.rect[0], m_prev.rect[1], m_prev.rect[2], m_prev.rect[3] };
+    if (flags & kFlagRect) {
+        for (int i = 0; i < 4; ++i) {
+            if ((in = readVarint(in, end, v)) == nullptr) return false;
+            rect[i] += unzigzag(static_cast<uint32_t>(v));
+        }
+    }
+
+    // Record complete: commit decoder state
+    m_prev.timestamp = timestamp;
+    std::memcpy(m_prev.pose, pose, sizeof(pose));
+    std::memcpy(m_prev.rect, rect, sizeof(rect));
+    m_readPos = static_cast<size_t>(in - begin);
+
+    TrackingData& data = sample.data;
+    data.timestamp  = timestamp;
+    data.isValid    = (flags & kFlagValid) != 0;
+    data.confidence = confidence / 255.0f;
+    data.yaw   = pose[0] / m_header.angleScale;
+    data.pitch = pose[1] / m_header.angleScale;
+    data.roll  = pose[2] / m_header.angleScale;
+    data.x     = pose[3] / m_header.translationScale;
+    data.y     = pose[4] / m_header.translationScale;
+    data.z     = pose[5] / m_header.translationScale;
+
+    sample.timing.captureUs = stages[0];
+    sample.timing.detectUs  = stages[1];
+    sample.timing.poseUs    = stages[2];
+    sample.timing.outputUs  = stages[3];
+
+    sample.rectX = rect[0];
+    sample.rectY = rect[1];
+    sample.rectW = rect[2];
+    sample.rectH = rect[3];
+    return true;
+}
+
+} // namespace htk::core
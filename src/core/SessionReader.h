@@ -0,0 +1,40 @@
+#ifndef SESSIONREADER_H
+#define SESSIONREADER_H
+
+#include "SessionFormat.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace htk::core {
+
+    // Sequential decoder for .htks files written by SessionRecorder.
+    // Tolerates files cut short by a crash: decoding stops at the first
+    // incomplete or zeroed record.
+    class SessionReader {
+    public:
+        SessionReader() = default;
+
+        // Load and validate a session file
+        bool open(const std::string& path);
+
+        // Decode the next sample; false at end of stream
+        bool next(SessionSample& sample);
+
+        // Restart decoding from the first record
+        void rewind();
+
+        const session::SessionFileHeader& header() const { return m_header; }
+        size_t fileSize() const { return m_buffer.size(); }
+
+    private:
+        std::vector<uint8_t> m_buffer;
+        session::SessionFileHeader m_header{};
+        size_t m_readPos = 0;
+        session::QuantizedState m_prev;
+    };
+
+} // namespace htk::core
+
+#endif // SESSIONREADER_H
@@ -0,0 +1,369 @@
+#include "SessionRecorder.h"
+#include "Instrumentation.h"
+
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace htk::core {
+
+using namespace session;
+
+namespace {
+
+#ifndef _WIN32
+// How often the grower checks whether the next chunk is due
+constexpr auto kGrowPoll = std::chrono::milliseconds(250);
+#endif
+
+size_t pageSize() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    const long size = ::sysconf(_SC_PAGESIZE);
+    return size > 0 ? static_cast<size_t>(size) : 4096;
+#endif
+}
+
+// Write to every page once so later stores find it mapped and writable.
+// Reading isn't enough (MAP_POPULATE only read-faults): the first store to
+// a shared file page still faults to mark it dirty. Each byte is written
+// back as read, so this is safe over data already in the file.
+void pretouch(uint8_t* begin, size_t size) {
+    const size_t page = pageSize();
+    for (size_t offset = 0; offset < size; offset += page) {
+        volatile uint8_t* byte = begin + offset;
+        *byte = *byte;
+    }
+}
+
+} // namespace
+
+SessionRecorder::SessionRecorder() = default;
+
+SessionRecorder::~SessionRecorder() {
+    close();
+}
+
+bool SessionRecorder::open(const std::string& path, size_t chunkSize) {
+    close();
+
+    // Whole pages, so each chunk can be mapped at its own file offset
+    const size_t page = pageSize();
+    m_chunkSize   = std::max(chunkSize, sizeof(SessionFileHeader) + kMaxRecordSize);
+    m_chunkSize   = (m_chunkSize + page - 1) / page * page;
+    m_writePos    = 0;
+    m_sampleCount = 0;
+    m_prev        = QuantizedState{};
+
+#ifdef _WIN32
+    m_hFile = CreateFileA(
+        path.c_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ,
+        NULL,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL
+    );
+
+    if (m_hFile == INVALID_HANDLE_VALUE) {
+        std::cerr << "Failed to create session file " << path
+                  << ". Error: " << GetLastError() << std::endl;
+        return false;
+    }
+#else
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        std::cerr << "Failed to create session file " << path
+                  << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Address space for the whole recording, so chunks map in place and
+    // the buffer never moves
+    void* reserved = ::mmap(nullptr, kReservedSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (reserved == MAP_FAILED) {
+        std::cerr << "Failed to reserve session mapping: " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    m_base = static_cast<uint8_t*>(reserved);
+    m_reserved = kReservedSize;
+    m_mapped.store(0, std::memory_order_relaxed);
+#endif
+
+    // First chunk mapped and touched here, on the caller's thread
+    if (!mapFile(m_chunkSize)) {
+        close();
+        return false;
+    }
+
+    // Header
+    SessionFileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version          = kVersion;
+    header.headerSize       = sizeof(SessionFileHeader);
+    header.angleScale       = kAngleScale;
+    header.translationScale = kTranslationScale;
+    header.startTimestamp   = 0;
+
+    std::memcpy(m_base, &header, sizeof(header));
+    m_writePos = sizeof(header);
+
+#ifndef _WIN32
+    m_capacity = m_mapped.load(std::memory_order_relaxed);
+    m_written.store(m_writePos, std::memory_order_relaxed);
+    m_stopGrower = false;
+    m_grower = std::thread(&SessionRecorder::growerLoop, this);
+#endif
+
+    std::cout << "Recording session to " << path << std::endl;
+    return true;
+}
+
+bool SessionRecorder::append(const SessionSample& sample) {
+    if (m_base == nullptr) {
+        return false;
+    }
+
+    // Rare: this chunk is full
+    if (m_writePos + kMaxRecordSize > m_capacity && !extend()) {
+        close();
+        return false;
+    }
+
+    const TrackingData& data = sample.data;
+
+    // First sample anchors the timestamp deltas
+    if (m_sampleCount == 0) {
+        m_prev.timestamp = data.timestamp;
+        reinterpret_cast<SessionFileHeader*>(m_base)->startTimestamp = data.timestamp;
+    }
+
+    const int32_t pose[6] = {
+        quantize(data.yaw,   kAngleScale),
+        quantize(data.pitch, kAngleScale),
+        quantize(data.roll,  kAngleScale),
+        quantize(data.x,     kTranslationScale),
+        quantize(data.y,     kTranslationScale),
+        quantize(data.z,     kTranslationScale)
+    };
+    const int32_t rect[4] = { sample.rectX, sample.rectY, sample.rectW, sample.rectH };
+    const bool rectChanged = std::memcmp(rect, m_prev.rect, sizeof(rect)) != 0;
+
+    uint8_t* out = m_base + m_writePos;
+
+    uint8_t flags = kRecordMarker;
+    if (data.isValid) flags |= kFlagValid;
+    if (rectChanged)  flags |= kFlagRect;
+    *out++ = flags;
+
+    // Timestamps are monotonic in practice; clamp a backwards system clock step
+    const uint64_t dt = data.timestamp > m_prev.timestamp ? data.timestamp - m_prev.timestamp : 0;
+    out = writeVarint(out, dt);
+
+    for (int i = 0; i < 6; ++i) {
+        out = writeVarint(out, zigzag(pose[i] - m_prev.pose[i]));
+        m_prev.pose[i] = pose[i];
+    }
+
+    *out++ = static_cast<uint8_t>(std::lround(std::clamp(data.confidence, 0.0f, 1.0f) * 255.0f));
+
+    out = writeVarint(out, sample.timing.captureUs);
+    out = writeVarint(out, sample.timing.detectUs);
+    out = writeVarint(out, sample.timing.poseUs);
+    out = writeVarint(out, sample.timing.outputUs);
+
+    if (rectChanged) {
+        for (int i = 0; i < 4; ++i) {
+            out = writeVarint(out, zigzag(rect[i] - m_prev.rect[i]));
+            m_prev.rect[i] = rect[i];
+        }
+    }
+
+    m_prev.timestamp += dt;
+    m_writePos = static_cast<size_t>(out - m_base);
+    ++m_sampleCount;
+#ifndef _WIN32
+    m_written.store(m_writePos, std::memory_order_relaxed);
+#endif
+    return true;
+}
+
+bool SessionRecorder::extend() {
+#ifdef _WIN32
+    return mapFile(m_capacity + m_chunkSize);
+#else
+    // Normally the grower has mapped the next chunk already
+    m_capacity = m_mapped.load(std::memory_order_acquire);
+    if (m_writePos + kMaxRecordSize <= m_capacity) {
+        return true;
+    }
+
+    // It fell behind: extend here rather than drop samples
+    std::lock_guard<std::mutex> lock(m_growMutex);
+    const size_t mapped = m_mapped.load(std::memory_order_relaxed);
+    if (m_writePos + kMaxRecordSize > mapped && !mapFile(mapped + m_chunkSize)) {
+        return false;
+    }
+    m_capacity = m_mapped.load(std::memory_order_relaxed);
+    return true;
+#endif
+}
+
+#ifndef _WIN32
+void SessionRecorder::growerLoop() {
+    HTK_THREAD_NAME("htk recorder");
+
+    std::unique_lock<std::mutex> lock(m_growMutex);
+    while (!m_growWake.wait_for(lock, kGrowPoll, [this] { return m_stopGrower; })) {
+        // Map the next chunk once the current one is half used
+        const size_t mapped = m_mapped.load(std::memory_order_relaxed);
+        if (m_written.load(std::memory_order_relaxed) + m_chunkSize / 2 > mapped &&
+            mapped + m_chunkSize <= m_reserved && !mapFile(mapped + m_chunkSize)) {
+            return;  // append() retries, and closes the recording if that fails too
+        }
+    }
+}
+#endif
+
+void SessionRecorder::close() {
+    const size_t finalSize = m_writePos;
+    const bool wasOpen = m_writePos > 0;  // Header written
+
+#ifndef _WIN32
+    if (m_grower.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_growMutex);
+            m_stopGrower = true;
+        }
+        m_growWake.notify_all();
+        m_grower.join();
+    }
+#endif
+
+    unmapFile();
+
+#ifdef _WIN32
+    if (m_hFile != INVALID_HANDLE_VALUE) {
+        // Drop the unused tail of the last chunk
+        LARGE_INTEGER size;
+        size.QuadPart = static_cast<LONGLONG>(finalSize);
+        if (SetFilePointerEx(m_hFile, size, NULL, FILE_BEGIN)) {
+            SetEndOfFile(m_hFile);
+        }
+        CloseHandle(m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (m_fd >= 0) {
+        // Drop the unused tail of the last chunk
+        if (::ftruncate(m_fd, static_cast<off_t>(finalSize)) != 0) {
+            std::cerr << "Failed to trim session file: " << std::strerror(errno) << std::endl;
+        }
+        ::close(m_fd);
+        m_fd = -1;
+    }
+#endif
+
+    if (wasOpen) {
+        std::cout << "Session recording closed (" << m_sampleCount << " samples, "
+                  << finalSize << " bytes)" << std::endl;
+    }
+
+    m_writePos = 0;
+}
+
+bool SessionRecorder::mapFile(size_t capacity) {
+#ifdef _WIN32
+    unmapFile();
+
+    // Mapping a file larger than its size grows it
+    m_hMapFile = CreateFileMappingA(
+        m_hFile,
+        NULL,
+        PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<uint64_t>(capacity) >> 32),
+        static_cast<DWORD>(capacity & 0xffffffffu),
+        NULL
+    );
+
+    if (m_hMapFile == NULL) {
+        std::cerr << "Failed to map session file. Error: " << GetLastError() << std::endl;
+        return false;
+    }
+
+    m_base = static_cast<uint8_t*>(MapViewOfFile(m_hMapFile, FILE_MAP_ALL_ACCESS, 0, 0, capacity));
+    if (m_base == nullptr) {
+        std::cerr << "Failed to map session file view. Error: " << GetLastError() << std::endl;
+        CloseHandle(m_hMapFile);
+        m_hMapFile = nullptr;
+        return false;
+    }
+
+    // The new view starts untouched: everything from the page being written on
+    const size_t from = m_writePos / pageSize() * pageSize();
+    pretouch(m_base + from, capacity - from);
+    m_capacity = capacity;
+#else
+    // Called before the grower starts, or with m_growMutex held
+    const size_t mapped = m_mapped.load(std::memory_order_relaxed);
+    if (capacity > m_reserved) {
+        std::cerr << "Session file reached its " << (m_reserved >> 20) << " MB limit" << std::endl;
+        return false;
+    }
+
+    if (::ftruncate(m_fd, static_cast<off_t>(capacity)) != 0) {
+        std::cerr << "Failed to extend session file: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Only the new chunk, in place after the last one: the writer keeps
+    // using the mapped part undisturbed
+    void* chunk = ::mmap(m_base + mapped, capacity - mapped, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_FIXED, m_fd, static_cast<off_t>(mapped));
+    if (chunk == MAP_FAILED) {
+        std::cerr << "Failed to map session file: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    pretouch(m_base + mapped, capacity - mapped);
+    m_mapped.store(capacity, std::memory_order_release);
+#endif
+
+    return true;
+}
+
+void SessionRecorder::unmapFile() {
+#ifdef _WIN32
+    if (m_base != nullptr) {
+        UnmapViewOfFile(m_base);
+    }
+    if (m_hMapFile != nullptr) {
+        CloseHandle(m_hMapFile);
+        m_hMapFile = nullptr;
+    }
+#else
+    // The file's chunks and the rest of the reservation together
+    if (m_base != nullptr) {
+        ::munmap(m_base, m_reserved);
+    }
+    m_reserved = 0;
+    m_mapped.store(0, std::memory_order_relaxed);
+#endif
+
+    m_base = nullptr;
+    m_capacity = 0;
+}
+
+} // namespace htk::core
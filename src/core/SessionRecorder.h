@@ -0,0 +1,96 @@
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include "SessionFormat.h"
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace htk::core {
+
+    // Appends SessionSamples to a delta-encoded .htks file through a
+    // memory-mapped buffer. append() only encodes into mapped memory; the
+    // file is extended in large chunks (roughly one per hour of tracking at
+    // the default size) whose pages are written once up front, so append()
+    // doesn't fault on first touch. A page the kernel has since written
+    // back can still take one minor fault when append() next writes to it.
+    //
+    // On POSIX the file is mapped into a fixed address range reserved at
+    // open(), and a background thread maps and pre-touches the next chunk
+    // while the current one still has room: the tracking thread never maps
+    // anything. On Windows growth remaps the file from append().
+    class SessionRecorder {
+    public:
+        SessionRecorder();
+        ~SessionRecorder();
+
+        SessionRecorder(const SessionRecorder&) = delete;
+        SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+        // Create/truncate the file and map the first chunk
+        bool open(const std::string& path, size_t chunkSize = kDefaultChunkSize);
+
+        // Encode one sample (call from the tracking thread)
+        bool append(const SessionSample& sample);
+
+        // Trim the file to the written length and unmap
+        void close();
+
+        bool isOpen() const { return m_base != nullptr; }
+        uint64_t sampleCount() const { return m_sampleCount; }
+        size_t bytesWritten() const { return m_writePos; }
+
+        static constexpr size_t kDefaultChunkSize = 8 * 1024 * 1024;
+
+        // Address space reserved for the mapping (POSIX): the longest
+        // recording, over a hundred hours at the default rate
+        static constexpr size_t kReservedSize = size_t(1) << 30;
+
+    private:
+        uint8_t* m_base = nullptr;
+        size_t m_capacity = 0;
+        size_t m_writePos = 0;
+        size_t m_chunkSize = kDefaultChunkSize;
+        uint64_t m_sampleCount = 0;
+
+        session::QuantizedState m_prev;
+
+#ifdef _WIN32
+        HANDLE m_hFile = INVALID_HANDLE_VALUE;
+        HANDLE m_hMapFile = nullptr;
+#else
+        int m_fd = -1;
+        size_t m_reserved = 0;
+
+        // Chunks are mapped ahead of the writer by m_grower
+        std::thread m_grower;
+        std::mutex m_growMutex;            // Held while extending the mapping
+        std::condition_variable m_growWake;
+        bool m_stopGrower = false;
+        std::atomic<size_t> m_mapped{0};   // Mapped and pre-touched (grower -> writer)
+        std::atomic<size_t> m_written{0};  // m_writePos (writer -> grower)
+
+        void growerLoop();
+#endif
+
+        // Make room for the next record once the mapped part is full
+        bool extend();
+
+        // Extend the file and its mapping to the given size
+        bool mapFile(size_t capacity);
+        void unmapFile();
+    };
+
+} // namespace htk::core
+
+#endif // SESSIONRECORDER_H
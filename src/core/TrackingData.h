@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <chrono>
+#include <ctime>
 
 namespace htk::core {
 
@@ -41,6 +42,38 @@ namespace htk::core {
         }
     };
 
+    // Per-frame pipeline stage costs (microseconds)
+    struct FrameTiming {
+        uint32_t captureUs = 0;  // Blocked on / reading the camera
+        uint32_t detectUs  = 0;  // Face detection
+        uint32_t poseUs    = 0;  // Pose estimation and smoothing
+        uint32_t outputUs  = 0;  // Centering and output sinks
+
+        // CPU time detection took on every thread it ran on; above detectUs
+        // when detectors run in parallel
+        uint32_t detectCpuUs = 0;
+
+        // Helper to get a monotonic timestamp for stage measurements
+        static uint64_t steadyMicros() {
+            auto now = std::chrono::steady_clock::now();
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                now.time_since_epoch()
+            ).count());
+        }
+
+        // CPU time used by the calling thread (wall clock where the platform
+        // has no per-thread clock)
+        static uint64_t threadCpuMicros() {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+            timespec now{};
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+            return static_cast<uint64_t>(now.tv_sec) * 1000000u + static_cast<uint64_t>(now.tv_nsec) / 1000u;
+#else
+            return steadyMicros();
+#endif
+        }
+    };
+
 } // namespace htk::core
 
 #endif // TRACKINGDATA_H
\ No newline at end of file
@@ -0,0 +1,353 @@
+#include "TrackingMetrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace htk::core {
+
+namespace {
+
+// Smoothing weights per sample (roughly 1/alpha samples of memory)
+constexpr float kRateAlpha     = 0.02f;  // Miss rate
+constexpr float kIntervalAlpha = 0.05f;  // Frame intervals
+constexpr float kMeanAlpha     = 0.2f;   // Slow pose mean for stillness
+constexpr float kJitterAlpha   = 0.05f;  // Jitter variance
+
+// Residual from the slow mean below which the head counts as still
+constexpr float kStillAngle       = 1.5f;  // Degrees
+constexpr float kStillTranslation = 5.0f;  // Millimeters
+
+// Output rate falls to zero once nothing was delivered for this long
+constexpr uint64_t kOutputTimeoutUs = 1000000;
+
+const char* const kAxisNames[6] = {"yaw", "pitch", "roll", "x", "y", "z"};
+
+} // namespace
+
+TrackingMetrics::TrackingMetrics() {
+    for (auto& f : m_publishedFloats) {
+        f.store(0.0f, std::memory_order_relaxed);
+    }
+    for (auto& c : m_publishedCounters) {
+        c.store(0, std::memory_order_relaxed);
+    }
+}
+
+void TrackingMetrics::setNominalFps(float fps) {
+    m_working.nominalFps = fps;
+    publish();
+}
+
+void TrackingMetrics::onCameraFrame(uint64_t arrivalUs, bool duplicate) {
+    if (duplicate) {
+        ++m_working.framesDuplicated;
+        publish();
+        return;
+    }
+
+    ++m_working.framesCaptured;
+
+    if (m_lastArrivalUs != 0 && arrivalUs > m_lastArrivalUs) {
+        const float interval = static_cast<float>(arrivalUs - m_lastArrivalUs);
+
+        // A gap of N nominal periods means N-1 frames never reached us
+        if (m_working.nominalFps > 0.0f) {
+            const float nominalUs = 1e6f / m_working.nominalFps;
+            if (interval > 1.5f * nominalUs) {
+                m_working.framesDropped += static_cast<uint64_t>(std::lround(interval / nominalUs)) - 1;
+            }
+        }
+
+        m_inputIntervalUs = m_inputIntervalUs > 0.0f
+            ? m_inputIntervalUs + kIntervalAlpha * (interval - m_inputIntervalUs)
+            : interval;
+        m_working.inputFps = 1e6f / m_inputIntervalUs;
+    }
+    m_lastArrivalUs = arrivalUs;
+
+    if (m_lastOutputUs != 0 && arrivalUs - m_lastOutputUs > kOutputTimeoutUs) {
+        m_working.outputFps = 0.0f;
+        m_outputIntervalUs = 0.0f;
+    }
+
+    publish();
+}
+
+void TrackingMetrics::onDetection(bool detected, bool gated, bool coasting) {
+    if (detected) {
+        ++m_working.detections;
+    } else {
+        ++m_working.misses;
+    }
+    if (gated) {
+        ++m_working.framesGated;
+    }
+    if (coasting) {
+        ++m_working.framesCoasted;
+    }
+
+    m_working.missRate  += kRateAlpha * ((detected ? 0.0f : 1.0f) - m_working.missRate);
+    m_working.gateRatio += kRateAlpha * ((gated ? 1.0f : 0.0f) - m_working.gateRatio);
+    publish();
+}
+
+void TrackingMetrics::onOutput(const TrackingData& data, uint64_t steadyUs) {
+    ++m_working.outputs;
+
+    if (m_lastOutputUs != 0 && steadyUs > m_lastOutputUs) {
+        const float interval = static_cast<float>(steadyUs - m_lastOutputUs);
+        m_outputIntervalUs = m_outputIntervalUs > 0.0f
+            ? m_outputIntervalUs + kIntervalAlpha * (interval - m_outputIntervalUs)
+            : interval;
+        m_working.outputFps = 1e6f / m_outputIntervalUs;
+    }
+    m_lastOutputUs = steadyUs;
+
+    // Jitter: residual against a slow mean, accumulated only while still
+    const float axes[6] = { data.yaw, data.pitch, data.roll, data.x, data.y, data.z };
+
+    if (!m_haveAxisMean) {
+        for (int i = 0; i < 6; ++i) {
+            m_axisMean[i] = axes[i];
+        }
+        m_haveAxisMean = true;
+    } else {
+        float residual[6];
+        bool still = true;
+        for (int i = 0; i < 6; ++i) {
+            residual[i] = axes[i] - m_axisMean[i];
+            m_axisMean[i] += kMeanAlpha * residual[i];
+            still = still && std::fabs(residual[i]) < (i < 3 ? kStillAngle : kStillTranslation);
+        }
+
+        if (still) {
+            for (int i = 0; i < 6; ++i) {
+                m_axisVariance[i] += kJitterAlpha * (residual[i] * residual[i] - m_axisVariance[i]);
+                m_working.jitter[i] = std::sqrt(m_axisVariance[i]);
+            }
+        }
+    }
+
+    publish();
+}
+
+void TrackingMetrics::onReacquire(uint32_t gapUs) {
+    const float gapMs = static_cast<float>(gapUs) / 1000.0f;
+    m_working.reacquireMs = m_working.reacquisitions == 0
+        ? gapMs
+        : m_working.reacquireMs + kRateAlpha * (gapMs - m_working.reacquireMs);
+    ++m_working.reacquisitions;
+    publish();
+}
+
+void TrackingMetrics::onCameraStall(bool started) {
+    if (started) {
+        ++m_working.cameraStalls;
+    }
+    ++m_working.framesStalled;
+    publish();
+}
+
+void TrackingMetrics::onCameraReconnect(uint32_t outageUs) {
+    m_working.reconnectMs = static_cast<float>(outageUs) / 1000.0f;
+    ++m_working.cameraReconnects;
+    publish();
+}
+
+void TrackingMetrics::onWakeup(uint32_t lateUs) {
+    int bucket = 0;
+    while (bucket < MetricsSnapshot::kWakeBuckets - 1 && lateUs > MetricsSnapshot::kWakeBoundsUs[bucket]) {
+        ++bucket;
+    }
+
+    ++m_working.wakeLatency[bucket];
+    m_working.wakeLatencySumUs += lateUs;
+    m_working.wakeLatencyMaxUs = std::max(m_working.wakeLatencyMaxUs, static_cast<float>(lateUs));
+    publish();
+}
+
+void TrackingMetrics::reset() {
+    const float nominalFps = m_working.nominalFps;
+
+    m_working = MetricsSnapshot{};
+    m_working.nominalFps = nominalFps;
+    m_lastArrivalUs = m_lastOutputUs = 0;
+    m_inputIntervalUs = m_outputIntervalUs = 0.0f;
+    m_haveAxisMean = false;
+    for (int i = 0; i < 6; ++i) {
+        m_axisMean[i] = m_axisVariance[i] = 0.0f;
+    }
+
+    publish();
+}
+
+void TrackingMetrics::publish() {
+    const float floats[kFloatFields] = {
+        m_working.jitter[0], m_working.jitter[1], m_working.jitter[2],
+        m_working.jitter[3], m_working.jitter[4], m_working.jitter[5],
+        m_working.missRate, m_working.inputFps, m_working.outputFps, m_working.nominalFps,
+        m_working.gateRatio, m_working.wakeLatencyMaxUs, m_working.reacquireMs,
+        m_working.reconnectMs
+    };
+    uint64_t counters[kCounterFields] = {
+        m_working.framesCaptured, m_working.framesDropped, m_working.framesDuplicated,
+        m_working.detections, m_working.misses, m_working.outputs, m_working.framesGated,
+        m_working.framesCoasted, m_working.reacquisitions, m_working.cameraStalls,
+        m_working.framesStalled, m_working.cameraReconnects
+    };
+    for (int i = 0; i < MetricsSnapshot::kWakeBuckets; ++i) {
+        counters[12 + i] = m_working.wakeLatency[i];
+    }
+    counters[12 + MetricsSnapshot::kWakeBuckets] = m_working.wakeLatencySumUs;
+
+    // Single writer: odd sequence while the fields are in flux
+    const uint32_t seq = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (int i = 0; i < kFloatFields; ++i) {
+        m_publishedFloats[i].store(floats[i], std::memory_order_relaxed);
+    }
+    for (int i = 0; i < kCounterFields; ++i) {
+        m_publishedCounters[i].store(counters[i], std::memory_order_relaxed);
+    }
+
+    m_sequence.store(seq + 2, std::memory_order_release);
+}
+
+MetricsSnapshot TrackingMetrics::snapshot() const {
+    float floats[kFloatFields];
+    uint64_t counters[kCounterFields];
+    uint32_t before = 0, after = 0;
+
+    do {
+        before = m_sequence.load(std::memory_order_acquire);
+        for (int i = 0; i < kFloatFields; ++i) {
+            floats[i] = m_publishedFloats[i].load(std::memory_order_relaxed);
+        }
+        for (int i = 0; i < kCounterFields; ++i) {
+            counters[i] = m_publishedCounters[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = m_sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) != 0 || before != after);
+
+    MetricsSnapshot result;
+    for (int i = 0; i < 6; ++i) {
+        result.jitter[i] = floats[i];
+    }
+    result.missRate   = floats[6];
+    result.inputFps   = floats[7];
+    result.outputFps  = floats[8];
+    result.nominalFps = floats[9];
+    result.gateRatio  = floats[10];
+    result.wakeLatencyMaxUs = floats[11];
+    result.reacquireMs      = floats[12];
+    result.reconnectMs      = floats[13];
+
+    result.framesCaptured   = counters[0];
+    result.framesDropped    = counters[1];
+    result.framesDuplicated = counters[2];
+    result.detections       = counters[3];
+    result.misses           = counters[4];
+    result.outputs          = counters[5];
+    result.framesGated      = counters[6];
+    result.framesCoasted    = counters[7];
+    result.reacquisitions   = counters[8];
+    result.cameraStalls     = counters[9];
+    result.framesStalled    = counters[10];
+    result.cameraReconnects = counters[11];
+    for (int i = 0; i < MetricsSnapshot::kWakeBuckets; ++i) {
+        result.wakeLatency[i] = counters[12 + i];
+    }
+    result.wakeLatencySumUs = counters[12 + MetricsSnapshot::kWakeBuckets];
+    return result;
+}
+
+std::string TrackingMetrics::formatPrometheus(const MetricsSnapshot& m) {
+    std::string out;
+    out.reserve(4096);
+    char line[160];
+
+    auto metric = [&](const char* name, const char* type, const char* help) {
+        std::snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+        out += line;
+    };
+    auto gauge = [&](const char* name, double value) {
+        std::snprintf(line, sizeof(line), "%s %.6g\n", name, value);
+        out += line;
+    };
+    auto counter = [&](const char* name, uint64_t value) {
+        std::snprintf(line, sizeof(line), "%s %llu\n", name, static_cast<unsigned long long>(value));
+        out += line;
+    };
+
+    metric("htk_jitter_rms", "gauge", "Pose jitter while the head is still (degrees or mm).");
+    for (int i = 0; i < 6; ++i) {
+        std::snprintf(line, sizeof(line), "htk_jitter_rms{axis=\"%s\"} %.6g\n", kAxisNames[i], m.jitter[i]);
+        out += line;
+    }
+
+    metric("htk_detection_miss_rate", "gauge", "Rolling fraction of frames without a face detection.");
+    gauge("htk_detection_miss_rate", m.missRate);
+    metric("htk_detection_gate_ratio", "gauge", "Rolling fraction of frames that reused the last detection as static.");
+    gauge("htk_detection_gate_ratio", m.gateRatio);
+    metric("htk_input_fps", "gauge", "Unique camera frames per second.");
+    gauge("htk_input_fps", m.inputFps);
+    metric("htk_output_fps", "gauge", "Poses delivered to outputs per second.");
+    gauge("htk_output_fps", m.outputFps);
+    metric("htk_nominal_fps", "gauge", "Frame rate requested from the camera.");
+    gauge("htk_nominal_fps", m.nominalFps);
+
+    metric("htk_frames_captured_total", "counter", "Unique camera frames captured.");
+    counter("htk_frames_captured_total", m.framesCaptured);
+    metric("htk_frames_dropped_total", "counter", "Camera frames missing from the nominal cadence.");
+    counter("htk_frames_dropped_total", m.framesDropped);
+    metric("htk_frames_duplicated_total", "counter", "Camera frames delivered twice.");
+    counter("htk_frames_duplicated_total", m.framesDuplicated);
+    metric("htk_detections_total", "counter", "Frames with a face detection.");
+    counter("htk_detections_total", m.detections);
+    metric("htk_misses_total", "counter", "Frames without a face detection.");
+    counter("htk_misses_total", m.misses);
+    metric("htk_frames_gated_total", "counter", "Frames that skipped detection because the face region was static.");
+    counter("htk_frames_gated_total", m.framesGated);
+    metric("htk_frames_coasted_total", "counter", "Frames bridged with an extrapolated pose after a miss.");
+    counter("htk_frames_coasted_total", m.framesCoasted);
+    metric("htk_reacquisitions_total", "counter", "Times the face was detected again after a miss.");
+    counter("htk_reacquisitions_total", m.reacquisitions);
+    metric("htk_reacquire_ms", "gauge", "Rolling time from losing the face to detecting it again.");
+    gauge("htk_reacquire_ms", m.reacquireMs);
+    metric("htk_camera_stalls_total", "counter", "Times the camera stopped delivering frames.");
+    counter("htk_camera_stalls_total", m.cameraStalls);
+    metric("htk_frames_stalled_total", "counter", "Updates without a camera frame, bridged with a coasted pose.");
+    counter("htk_frames_stalled_total", m.framesStalled);
+    metric("htk_camera_reconnects_total", "counter", "Times the camera was reopened after failing.");
+    counter("htk_camera_reconnects_total", m.cameraReconnects);
+    metric("htk_camera_reconnect_ms", "gauge", "Outage before the last camera reconnect.");
+    gauge("htk_camera_reconnect_ms", m.reconnectMs);
+    metric("htk_outputs_total", "counter", "Poses delivered to outputs.");
+    counter("htk_outputs_total", m.outputs);
+
+    metric("htk_wakeup_latency_us", "histogram", "How late the tracking thread woke from its frame sleep.");
+    uint64_t cumulative = 0;
+    for (int i = 0; i < MetricsSnapshot::kWakeBuckets; ++i) {
+        cumulative += m.wakeLatency[i];
+        if (i + 1 < MetricsSnapshot::kWakeBuckets) {
+            std::snprintf(line, sizeof(line), "htk_wakeup_latency_us_bucket{le=\"%u\"} %llu\n",
+                          MetricsSnapshot::kWakeBoundsUs[i], static_cast<unsigned long long>(cumulative));
+        } else {
+            std::snprintf(line, sizeof(line), "htk_wakeup_latency_us_bucket{le=\"+Inf\"} %llu\n",
+                          static_cast<unsigned long long>(cumulative));
+        }
+        out += line;
+    }
+    counter("htk_wakeup_latency_us_sum", m.wakeLatencySumUs);
+    counter("htk_wakeup_latency_us_count", cumulative);
+    metric("htk_wakeup_latency_max_us", "gauge", "Worst tracking thread wake-up latency seen.");
+    gauge("htk_wakeup_latency_max_us", m.wakeLatencyMaxUs);
+
+    return out;
+}
+
+} // namespace htk::core
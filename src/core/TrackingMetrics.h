@@ -0,0 +1,113 @@
+#ifndef TRACKINGMETRICS_H
+#define TRACKINGMETRICS_H
+
+#include "TrackingData.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace htk::core {
+
+    // Point-in-time copy of the rolling tracking-quality metrics
+    struct MetricsSnapshot {
+        // Per-axis jitter while the head is still (RMS; yaw/pitch/roll in
+        // degrees, x/y/z in mm)
+        float jitter[6] = {0, 0, 0, 0, 0, 0};
+
+        float missRate  = 0.0f;  // Rolling fraction of frames without a detection
+        float gateRatio = 0.0f;  // Rolling fraction of frames that skipped detection as static
+        float reacquireMs = 0.0f; // Rolling time from losing the face to detecting it again
+        float reconnectMs = 0.0f; // Last camera outage that ended in a reconnect
+        float inputFps  = 0.0f;  // Unique camera frames per second
+        float outputFps = 0.0f;  // Poses delivered to outputs per second
+        float nominalFps = 0.0f; // What the camera was asked for
+
+        // Cumulative counters
+        uint64_t framesCaptured   = 0;
+        uint64_t framesDropped    = 0;  // Gaps in the camera frame cadence
+        uint64_t framesDuplicated = 0;  // Same image delivered twice
+        uint64_t detections       = 0;
+        uint64_t misses           = 0;
+        uint64_t framesGated      = 0;  // Detection skipped, face region unchanged
+        uint64_t framesCoasted    = 0;  // Face missed, pose extrapolated
+        uint64_t reacquisitions   = 0;  // Face found again after a miss
+        uint64_t cameraStalls     = 0;  // Times the camera stopped delivering
+        uint64_t framesStalled    = 0;  // Updates without a camera frame
+        uint64_t cameraReconnects = 0;  // Camera reopened after failing
+        uint64_t outputs          = 0;
+
+        // Scheduling jitter: how late the tracking thread woke up from its
+        // frame-pacing sleep, as a histogram in microseconds
+        static constexpr int kWakeBuckets = 8;
+        static constexpr uint32_t kWakeBoundsUs[kWakeBuckets - 1] = { 50, 100, 200, 500, 1000, 2000, 5000 };
+        uint64_t wakeLatency[kWakeBuckets] = {};  // Per bucket, last one is beyond 5 ms
+        uint64_t wakeLatencySumUs = 0;
+        float wakeLatencyMaxUs = 0.0f;
+    };
+
+    // Rolling tracking-quality metrics. All on*() calls come from the tracking
+    // thread; snapshot() may be called from any thread without locking.
+    class TrackingMetrics {
+    public:
+        TrackingMetrics();
+
+        void setNominalFps(float fps);
+
+        // A camera frame arrived (steady clock microseconds)
+        void onCameraFrame(uint64_t arrivalUs, bool duplicate);
+
+        // Detection outcome for the frame; gated when the previous detection
+        // was reused because the face region didn't change, coasting when a
+        // miss was bridged with an extrapolated pose
+        void onDetection(bool detected, bool gated = false, bool coasting = false);
+
+        // The face was detected again after being missing this long
+        void onReacquire(uint32_t gapUs);
+
+        // A pose was delivered to the outputs
+        void onOutput(const TrackingData& data, uint64_t steadyUs);
+
+        // An update had no camera frame because the camera stalled; started
+        // on the first update of a stall
+        void onCameraStall(bool started);
+
+        // The camera came back after being reopened, outageUs after its
+        // last frame
+        void onCameraReconnect(uint32_t outageUs);
+
+        // The tracking thread woke this long after it asked to
+        void onWakeup(uint32_t lateUs);
+
+        // Copy of the latest published values
+        MetricsSnapshot snapshot() const;
+
+        void reset();
+
+        // Prometheus text exposition format
+        static std::string formatPrometheus(const MetricsSnapshot& snapshot);
+
+    private:
+        // Tracking-thread state
+        MetricsSnapshot m_working;
+        uint64_t m_lastArrivalUs = 0;
+        uint64_t m_lastOutputUs  = 0;
+        float m_inputIntervalUs  = 0.0f;
+        float m_outputIntervalUs = 0.0f;
+        float m_axisMean[6]      = {0, 0, 0, 0, 0, 0};
+        float m_axisVariance[6]  = {0, 0, 0, 0, 0, 0};
+        bool m_haveAxisMean      = false;
+
+        // Published copy (seqlock over relaxed atomics)
+        static constexpr int kFloatFields   = 14;
+        static constexpr int kCounterFields = 12 + MetricsSnapshot::kWakeBuckets + 1;
+        std::atomic<uint32_t> m_sequence{0};
+        std::atomic<float> m_publishedFloats[kFloatFields];
+        std::atomic<uint64_t> m_publishedCounters[kCounterFields];
+
+        void publish();
+    };
+
+} // namespace htk::core
+
+#endif // TRACKINGMETRICS_H
@@ -0,0 +1,112 @@
+#include "WorkerPool.h"
+#include "Instrumentation.h"
+#include "TrackingData.h"
+
+#include <algorithm>
+
+namespace htk::core {
+
+WorkerPool::WorkerPool(int threads)
+    : m_threadCount(std::max(0, threads))
+{
+}
+
+WorkerPool::~WorkerPool() {
+    stopThreads();
+}
+
+void WorkerPool::setThreadCount(int threads) {
+    threads = std::max(0, threads);
+    if (threads == m_threadCount) {
+        return;
+    }
+
+    // Started threads are sized for the old count; the next run() starts anew
+    stopThreads();
+    m_threadCount = threads;
+}
+
+void WorkerPool::stopThreads() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+    m_stop = false;
+}
+
+void WorkerPool::run(int count, void (*function)(void*, int), void* context) {
+    m_batchCpuUs = 0;
+    if (count <= 0) {
+        return;
+    }
+    if (count == 1 || m_threadCount == 0) {
+        for (int i = 0; i < count; ++i) {
+            function(context, i);
+        }
+        return;
+    }
+
+    if (m_threads.empty()) {
+        m_threads.reserve(m_threadCount);
+        for (int i = 0; i < m_threadCount; ++i) {
+            m_threads.emplace_back(&WorkerPool::workerLoop, this);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_function = function;
+        m_context = context;
+        m_count = count;
+        m_next.store(0, std::memory_order_relaxed);
+        m_busy = m_threadCount;
+        ++m_batch;
+    }
+    m_wake.notify_all();
+
+    runJobs();
+
+    // Jobs are claimed, not assigned, so every index has run once the
+    // workers are all back
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busy == 0; });
+}
+
+void WorkerPool::runJobs() {
+    for (int i = m_next.fetch_add(1, std::memory_order_relaxed); i < m_count;
+         i = m_next.fetch_add(1, std::memory_order_relaxed)) {
+        m_function(m_context, i);
+    }
+}
+
+void WorkerPool::workerLoop() {
+    HTK_THREAD_NAME("htk worker");
+
+    unsigned seen = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [&] { return m_stop || m_batch != seen; });
+        if (m_stop) {
+            return;
+        }
+        seen = m_batch;
+
+        lock.unlock();
+        const uint64_t cpuStart = FrameTiming::threadCpuMicros();
+        runJobs();
+        const uint64_t cpuUs = FrameTiming::threadCpuMicros() - cpuStart;
+        lock.lock();
+
+        m_batchCpuUs += cpuUs;
+        if (--m_busy == 0) {
+            m_done.notify_one();
+        }
+    }
+}
+
+} // namespace htk::core
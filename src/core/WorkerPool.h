@@ -0,0 +1,70 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace htk::core {
+
+    // A few threads kept around to run one small batch of jobs at a time
+    // alongside the calling thread (the detector ensemble, the two eye
+    // searches). Unlike cv::parallel_for_, a batch allocates nothing: the
+    // job is passed by pointer and the threads only wait on a condition
+    // variable between batches. Threads start on the first run().
+    class WorkerPool {
+    public:
+        explicit WorkerPool(int threads);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        // Calls job(i) for every i in [0, count) and returns once all are
+        // done; the caller runs jobs too. One batch at a time, from one thread.
+        template <typename Job>
+        void run(int count, Job& job) {
+            run(count, [](void* context, int index) { (*static_cast<Job*>(context))(index); }, &job);
+        }
+
+        void run(int count, void (*function)(void*, int), void* context);
+
+        // Threads besides the caller; 0 runs every batch on the caller.
+        // Not while a batch is running.
+        void setThreadCount(int threads);
+        int threadCount() const { return m_threadCount; }
+
+        // CPU time the pool's threads spent on the last batch (the caller's
+        // own share is on the caller's clock)
+        uint64_t lastBatchCpuUs() const { return m_batchCpuUs; }
+
+    private:
+        int m_threadCount;
+        std::vector<std::thread> m_threads;
+
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+
+        // Current batch
+        void (*m_function)(void*, int) = nullptr;
+        void* m_context = nullptr;
+        int m_count = 0;
+        unsigned m_batch = 0;        // Bumped per batch, so workers see each once
+        std::atomic<int> m_next{0};  // Next job index to claim
+        int m_busy = 0;              // Workers still in the batch
+        uint64_t m_batchCpuUs = 0;   // Summed by the workers (under the mutex)
+        bool m_stop = false;
+
+        void workerLoop();
+        void runJobs();
+        void stopThreads();
+    };
+
+} // namespace htk::core
+
+#endif // WORKERPOOL_H
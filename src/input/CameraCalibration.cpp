@@ -0,0 +1,182 @@
+#include "CameraCalibration.h"
+
+#include <cmath>
+#include <iostream>
+
+namespace htk::input {
+
+CameraCalibration::CameraCalibration() {
+    setNominal(cv::Size(640, 480), 60.0f);
+}
+
+CameraCalibration CameraCalibration::nominal(cv::Size frameSize, float horizontalFovDeg) {
+    CameraCalibration result;
+    result.setNominal(frameSize, horizontalFovDeg);
+    return result;
+}
+
+void CameraCalibration::setNominal(cv::Size frameSize, float horizontalFovDeg) {
+    constexpr double degToRad = 3.14159265358979 / 180.0;
+    const double f = frameSize.width / 2.0 / std::tan(horizontalFovDeg * degToRad / 2.0);
+
+    m_cameraMatrix = cv::Matx33d(f,   0.0, frameSize.width  / 2.0,
+                                 0.0, f,   frameSize.height / 2.0,
+                                 0.0, 0.0, 1.0);
+    m_distortion.release();
+    m_imageSize = frameSize;
+    m_reprojectionError = 0.0;
+    m_isCalibrated = false;
+}
+
+bool CameraCalibration::load(const std::string& path) {
+    cv::FileStorage fs(path, cv::FileStorage::READ);
+    if (!fs.isOpened()) {
+        std::cerr << "Failed to open calibration file: " << path << std::endl;
+        return false;
+    }
+
+    cv::Mat cameraMatrix;
+    cv::Mat distortion;
+    int width = 0;
+    int height = 0;
+    fs["camera_matrix"] >> cameraMatrix;
+    fs["distortion_coefficients"] >> distortion;
+    fs["image_width"] >> width;
+    fs["image_height"] >> height;
+
+    if (cameraMatrix.rows != 3 || cameraMatrix.cols != 3 || width <= 0 || height <= 0) {
+        std::cerr << "Invalid calibration file: " << path << std::endl;
+        return false;
+    }
+
+    cameraMatrix.convertTo(cameraMatrix, CV_64F);
+    m_cameraMatrix = cv::Matx33d(cameraMatrix.ptr<double>());
+    if (!distortion.empty()) {
+        distortion.convertTo(m_distortion, CV_64F);
+    } else {
+        m_distortion.release();
+    }
+    m_imageSize = cv::Size(width, height);
+    fs["avg_reprojection_error"] >> m_reprojectionError;
+    m_isCalibrated = true;
+
+    std::cout << "Loaded camera calibration from: " << path << std::endl;
+    return true;
+}
+
+bool CameraCalibration::save(const std::string& path) const {
+    cv::FileStorage fs(path, cv::FileStorage::WRITE);
+    if (!fs.isOpened()) {
+        std::cerr << "Failed to write calibration file: " << path << std::endl;
+        return false;
+    }
+
+    fs << "image_width" << m_imageSize.width;
+    fs << "image_height" << m_imageSize.height;
+    fs << "camera_matrix" << cv::Mat(m_cameraMatrix);
+    const cv::Mat distortion = m_distortion.empty() ? cv::Mat(cv::Mat::zeros(1, 5, CV_64F)) : m_distortion;
+    fs << "distortion_coefficients" << distortion;
+    fs << "avg_reprojection_error" << m_reprojectionError;
+    return true;
+}
+
+bool CameraCalibration::calibrate(const std::vector<std::string>& imagePaths,
+                                  cv::Size boardSize, float squareSize,
+                                  CameraCalibration& result) {
+    std::vector<cv::Point3f> board;
+    for (int row = 0; row < boardSize.height; ++row) {
+        for (int col = 0; col < boardSize.width; ++col) {
+            board.emplace_back(col * squareSize, row * squareSize, 0.0f);
+        }
+    }
+
+    std::vector<std::vector<cv::Point3f>> objectPoints;
+    std::vector<std::vector<cv::Point2f>> imagePoints;
+    cv::Size imageSize;
+
+    for (const auto& path : imagePaths) {
+        const cv::Mat gray = cv::imread(path, cv::IMREAD_GRAYSCALE);
+        if (gray.empty()) {
+            std::cerr << "  skipped (unreadable): " << path << std::endl;
+            continue;
+        }
+        if (imageSize.area() == 0) {
+            imageSize = gray.size();
+        } else if (gray.size() != imageSize) {
+            std::cerr << "  skipped (different resolution): " << path << std::endl;
+            continue;
+        }
+
+        std::vector<cv::Point2f> corners;
+        const int flags = cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE | cv::CALIB_CB_FAST_CHECK;
+        if (!cv::findChessboardCorners(gray, boardSize, corners, flags)) {
+            std::cerr << "  skipped (no board found): " << path << std::endl;
+            continue;
+        }
+
+        cv::cornerSubPix(gray, corners, cv::Size(11, 11), cv::Size(-1, -1),
+                         cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.01));
+        imagePoints.push_back(std::move(corners));
+        objectPoints.push_back(board);
+    }
+
+    if (imagePoints.size() < 3) {
+        std::cerr << "Calibration needs at least 3 views with the board, got "
+                  << imagePoints.size() << std::endl;
+        return false;
+    }
+
+    cv::Mat cameraMatrix;
+    cv::Mat distortion;
+    std::vector<cv::Mat> rvecs;
+    std::vector<cv::Mat> tvecs;
+    const double rms = cv::calibrateCamera(objectPoints, imagePoints, imageSize,
+                                           cameraMatrix, distortion, rvecs, tvecs);
+
+    result.m_cameraMatrix = cv::Matx33d(cameraMatrix.ptr<double>());
+    result.m_distortion = distortion;
+    result.m_imageSize = imageSize;
+    result.m_reprojectionError = rms;
+    result.m_isCalibrated = true;
+    return true;
+}
+
+CameraCalibration CameraCalibration::scaledTo(cv::Size frameSize) const {
+    if (frameSize == m_imageSize || m_imageSize.area() == 0) {
+        return *this;
+    }
+
+    // Intrinsics scale with resolution; distortion is in normalized
+    // coordinates and doesn't change
+    const double sx = static_cast<double>(frameSize.width)  / m_imageSize.width;
+    const double sy = static_cast<double>(frameSize.height) / m_imageSize.height;
+
+    CameraCalibration result = *this;
+    result.m_cameraMatrix(0, 0) *= sx;
+    result.m_cameraMatrix(0, 2) *= sx;
+    result.m_cameraMatrix(1, 1) *= sy;
+    result.m_cameraMatrix(1, 2) *= sy;
+    result.m_imageSize = frameSize;
+    return result;
+}
+
+void CameraCalibration::undistortPoints(const cv::Point2f* pixels, cv::Point2f* normalized, int count) const {
+    if (m_distortion.empty()) {
+        // Pinhole only: no iteration needed
+        const float fx = static_cast<float>(m_cameraMatrix(0, 0));
+        const float fy = static_cast<float>(m_cameraMatrix(1, 1));
+        const float cx = static_cast<float>(m_cameraMatrix(0, 2));
+        const float cy = static_cast<float>(m_cameraMatrix(1, 2));
+        for (int i = 0; i < count; ++i) {
+            normalized[i] = cv::Point2f((pixels[i].x - cx) / fx, (pixels[i].y - cy) / fy);
+        }
+        return;
+    }
+
+    // Headers over the caller's arrays, so nothing is allocated per call
+    const cv::Mat src(1, count, CV_32FC2, const_cast<cv::Point2f*>(pixels));
+    cv::Mat dst(1, count, CV_32FC2, normalized);
+    cv::undistortPoints(src, dst, m_cameraMatrix, m_distortion);
+}
+
+} // namespace htk::input
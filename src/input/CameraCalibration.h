@@ -0,0 +1,56 @@
+#ifndef CAMERACALIBRATION_H
+#define CAMERACALIBRATION_H
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+namespace htk::input {
+
+    // Camera intrinsics and lens distortion. Only the handful of points the
+    // pose needs are undistorted; the frame itself is never remapped.
+    //
+    // Files use OpenCV's calibration layout (camera_matrix,
+    // distortion_coefficients, image_width, image_height), so output of
+    // other OpenCV calibration tools loads as well.
+    class CameraCalibration {
+    public:
+        // Nominal 60 degree lens at 640x480, no distortion
+        CameraCalibration();
+
+        // Pinhole guess for an uncalibrated camera
+        static CameraCalibration nominal(cv::Size frameSize, float horizontalFovDeg = 60.0f);
+
+        bool load(const std::string& path);
+        bool save(const std::string& path) const;
+
+        // Calibrate from checkerboard photos. boardSize counts inner
+        // corners, squareSize is in mm. Needs at least 3 usable views.
+        static bool calibrate(const std::vector<std::string>& imagePaths,
+                              cv::Size boardSize, float squareSize,
+                              CameraCalibration& result);
+
+        // Same lens at another capture resolution (same aspect ratio)
+        CameraCalibration scaledTo(cv::Size frameSize) const;
+
+        // Pixel positions to undistorted normalized coordinates (x/z, y/z)
+        void undistortPoints(const cv::Point2f* pixels, cv::Point2f* normalized, int count) const;
+
+        bool isCalibrated() const { return m_isCalibrated; }
+        cv::Size imageSize() const { return m_imageSize; }
+        const cv::Matx33d& cameraMatrix() const { return m_cameraMatrix; }
+        double reprojectionError() const { return m_reprojectionError; }
+
+    private:
+        cv::Matx33d m_cameraMatrix;
+        cv::Mat m_distortion;  // Empty = none
+        cv::Size m_imageSize;
+        double m_reprojectionError = 0.0;
+        bool m_isCalibrated = false;
+
+        void setNominal(cv::Size frameSize, float horizontalFovDeg);
+    };
+
+} // namespace htk::input
+
+#endif // CAMERACALIBRATION_H
@@ -0,0 +1,104 @@
+#include "CameraSource.h"
+
+#include <cmath>
+#include <iostream>
+
+namespace htk::input {
+
+namespace {
+
+// CAP_PROP_GAIN range of typical UVC webcams
+constexpr double kMaxGain = 255.0;
+
+// Backends disagree on exposure units and on the auto/manual switch:
+// V4L2 takes 100 µs units and 1 = manual (3 = auto), DirectShow and
+// Media Foundation take log2 seconds and 0.25 = manual (0.75 = auto)
+bool isV4L2(const cv::VideoCapture& camera) {
+    return camera.getBackendName() == "V4L2";
+}
+
+} // namespace
+
+CameraSource::CameraSource(int cameraIndex)
+    : m_cameraIndex(cameraIndex)
+    , m_nominalFps(0.0f)
+{
+}
+
+CameraSource::~CameraSource() {
+    close();
+}
+
+bool CameraSource::open() {
+    m_camera.open(m_cameraIndex);
+    if (!m_camera.isOpened()) {
+        std::cerr << "Failed to open camera " << m_cameraIndex << std::endl;
+        return false;
+    }
+    m_isManualExposure = false;
+
+    // Set camera properties
+    m_camera.set(cv::CAP_PROP_FRAME_WIDTH, 640);
+    m_camera.set(cv::CAP_PROP_FRAME_HEIGHT, 480);
+    m_camera.set(cv::CAP_PROP_FPS, 30);
+
+    // Some backends report 0 when they can't tell; assume what we asked for
+    m_nominalFps = static_cast<float>(m_camera.get(cv::CAP_PROP_FPS));
+    if (m_nominalFps <= 0.0f) {
+        m_nominalFps = 30.0f;
+    }
+
+    return true;
+}
+
+bool CameraSource::read(cv::Mat& frame) {
+    return m_camera.read(frame);
+}
+
+bool CameraSource::grab() {
+    // grab() dequeues the buffer without retrieve()'s decode/convert cost
+    return m_camera.grab();
+}
+
+void CameraSource::close() {
+    if (m_camera.isOpened()) {
+        // Many drivers keep controls after release; don't leave the camera dim
+        restoreAutoExposure();
+        m_camera.release();
+    }
+}
+
+void CameraSource::setManualExposure(double seconds, double gain) {
+    if (!m_camera.isOpened()) {
+        return;
+    }
+
+    const bool v4l2 = isV4L2(m_camera);
+    if (!m_isManualExposure) {
+        m_autoExposureMode = m_camera.get(cv::CAP_PROP_AUTO_EXPOSURE);
+        m_autoGain = m_camera.get(cv::CAP_PROP_GAIN);
+        m_camera.set(cv::CAP_PROP_AUTO_EXPOSURE, v4l2 ? 1.0 : 0.25);
+        m_isManualExposure = true;
+    }
+
+    // log2 steps are coarse: round down so the cap still holds
+    const double exposure = v4l2 ? std::round(seconds * 1e4) : std::floor(std::log2(seconds));
+    m_camera.set(cv::CAP_PROP_EXPOSURE, exposure);
+    m_camera.set(cv::CAP_PROP_GAIN, std::round(gain * kMaxGain));
+}
+
+void CameraSource::restoreAutoExposure() {
+    if (!m_isManualExposure || !m_camera.isOpened()) {
+        return;
+    }
+
+    m_camera.set(cv::CAP_PROP_AUTO_EXPOSURE, m_autoExposureMode);
+    m_camera.set(cv::CAP_PROP_GAIN, m_autoGain);
+    m_isManualExposure = false;
+}
+
+std::string CameraSource::describe() const {
+    return "camera " + std::to_string(m_cameraIndex);
+}
+
+} // namespace htk::input
@@ -0,0 +1,41 @@
+#ifndef CAMERASOURCE_H
+#define CAMERASOURCE_H
+
+#include "FrameSource.h"
+
+namespace htk::input {
+
+    // Live camera through cv::VideoCapture (640x480 @ 30 FPS requested)
+    class CameraSource : public FrameSource {
+    public:
+        explicit CameraSource(int cameraIndex);
+        ~CameraSource() override;
+
+        bool open() override;
+        bool read(cv::Mat& frame) override;
+        bool grab() override;
+        void close() override;
+        bool isOpened() const override { return m_camera.isOpened(); }
+        float nominalFps() const override { return m_nominalFps; }
+        std::string describe() const override;
+
+        bool hasExposureControl() const override { return m_camera.isOpened(); }
+        void setManualExposure(double seconds, double gain) override;
+        void restoreAutoExposure() override;
+
+        int cameraIndex() const { return m_cameraIndex; }
+
+    private:
+        cv::VideoCapture m_camera;
+        int m_cameraIndex;
+        float m_nominalFps;
+
+        // Driver settings from before manual exposure, restored on close
+        bool m_isManualExposure = false;
+        double m_autoExposureMode = 0.0;
+        double m_autoGain = 0.0;
+    };
+
+} // namespace htk::input
+
+#endif // CAMERASOURCE_H
@@ -0,0 +1,115 @@
+#include "CameraWorker.h"
+#include "../core/Instrumentation.h"
+
+#include <iostream>
+
+namespace htk::input {
+
+CameraWorker::CameraWorker() = default;
+
+CameraWorker::~CameraWorker() {
+    stop();
+    m_tracker.shutdown();
+}
+
+bool CameraWorker::initialize(std::unique_ptr<FrameSource> source) {
+    return m_tracker.initialize(std::move(source));
+}
+
+void CameraWorker::start() {
+    if (m_isRunning) {
+        return;
+    }
+
+    m_shouldStop = false;
+    m_isRunning = true;
+    m_thread = std::make_unique<std::thread>(&CameraWorker::run, this);
+}
+
+void CameraWorker::stop() {
+    m_shouldStop = true;
+
+    if (m_thread && m_thread->joinable()) {
+        m_thread->join();
+    }
+    m_thread.reset();
+
+    m_isRunning = false;
+    m_isTracking = false;
+}
+
+void CameraWorker::setSmoothing(float factor) {
+    m_smoothing.store(factor, std::memory_order_relaxed);
+    m_settingsChanged.store(true, std::memory_order_release);
+}
+
+void CameraWorker::setCoastTime(float seconds) {
+    m_coastTime.store(seconds, std::memory_order_relaxed);
+    m_settingsChanged.store(true, std::memory_order_release);
+}
+
+htk::core::Pose CameraWorker::getPose() const {
+    std::lock_guard<std::mutex> lock(m_latestMutex);
+    return m_latest;
+}
+
+int CameraWorker::getRealtimeStatus(htk::core::RealtimeStatus statuses[2]) const {
+    int count = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_latestMutex);
+        if (m_hasRealtimeStatus) {
+            statuses[count++] = m_realtimeStatus;
+        }
+    }
+    if (m_tracker.getCaptureRealtime(statuses[count])) {
+        ++count;
+    }
+    return count;
+}
+
+void CameraWorker::run() {
+    HTK_THREAD_NAME("camera worker");
+
+    if (m_realtime.enabled) {
+        const htk::core::RealtimeStatus status = htk::core::realtime::applyToCurrentThread(
+            m_realtime.capturePriority, m_realtime.roundRobin, m_realtime.captureCpus);
+        if (!status.message.empty()) {
+            std::cerr << "Camera worker: " << status.message << std::endl;
+        }
+        htk::core::realtime::prefaultStack();
+
+        std::lock_guard<std::mutex> lock(m_latestMutex);
+        m_realtimeStatus = status;
+        m_hasRealtimeStatus = true;
+    }
+
+    while (!m_shouldStop) {
+        if (m_settingsChanged.exchange(false, std::memory_order_acquire)) {
+            m_tracker.setSmoothing(m_smoothing.load(std::memory_order_relaxed));
+            m_tracker.setCoastTime(m_coastTime.load(std::memory_order_relaxed));
+        }
+
+        if (m_isIdle) {
+            // The source blocks until the next frame, which paces the loop;
+            // a dead one returns at once, so don't spin on it
+            if (!m_tracker.idle()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            continue;
+        }
+
+        if (!m_tracker.update()) {
+            // Source gone or at end: don't spin
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+
+        const htk::core::Pose& pose = m_tracker.getPose();
+        m_isTracking = pose.isValid;
+
+        std::lock_guard<std::mutex> lock(m_latestMutex);
+        m_latest = pose;
+    }
+}
+
+} // namespace htk::input
@@ -0,0 +1,78 @@
+#ifndef CAMERAWORKER_H
+#define CAMERAWORKER_H
+
+#include "WebcamTracker.h"
+#include "FrameSource.h"
+#include "../core/Pose.h"
+#include "../core/Realtime.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace htk::input {
+
+    // Runs capture, detection and pose estimation for one additional camera
+    // on its own thread and publishes the latest estimate for fusion
+    class CameraWorker {
+    public:
+        CameraWorker();
+        ~CameraWorker();
+
+        CameraWorker(const CameraWorker&) = delete;
+        CameraWorker& operator=(const CameraWorker&) = delete;
+
+        bool initialize(std::unique_ptr<FrameSource> source);
+
+        // Thread lifecycle
+        void start();
+        void stop();
+
+        // Warm standby: keep draining frames without detection
+        void setIdle(bool idle) { m_isIdle = idle; }
+
+        // Latest published estimate (timestamp says how fresh it is)
+        htk::core::Pose getPose() const;
+
+        // Capture priority/CPUs from settings apply when the thread starts
+        void setRealtime(const htk::core::RealtimeSettings& settings) { m_realtime = settings; }
+
+        // What the worker thread and its source's capture thread got, once
+        // started (realtime only); returns how many statuses were filled
+        int getRealtimeStatus(htk::core::RealtimeStatus statuses[2]) const;
+
+        // Filter settings, picked up by the worker thread before its next frame
+        void setSmoothing(float factor);
+        void setCoastTime(float seconds);
+        void setCalibration(const CameraCalibration& calibration) { m_tracker.setCalibration(calibration); }
+        void setExposureSettings(const ExposureSettings& settings) { m_tracker.setExposureSettings(settings); }
+        bool isTracking() const { return m_isTracking; }
+        bool isRunning() const { return m_isRunning; }
+
+    private:
+        WebcamTracker m_tracker;
+        htk::core::RealtimeSettings m_realtime;
+
+        std::unique_ptr<std::thread> m_thread;
+        std::atomic<bool> m_isRunning{false};
+        std::atomic<bool> m_shouldStop{false};
+        std::atomic<bool> m_isIdle{false};
+        std::atomic<bool> m_isTracking{false};
+
+        std::atomic<float> m_smoothing{0.5f};
+        std::atomic<float> m_coastTime{0.5f};
+        std::atomic<bool> m_settingsChanged{false};
+
+        htk::core::Pose m_latest;
+        mutable std::mutex m_latestMutex;
+
+        htk::core::RealtimeStatus m_realtimeStatus;  // Guarded by m_latestMutex
+        bool m_hasRealtimeStatus = false;
+
+        void run();
+    };
+
+} // namespace htk::input
+
+#endif // CAMERAWORKER_H
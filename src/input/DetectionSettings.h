@@ -0,0 +1,35 @@
+#ifndef DETECTIONSETTINGS_H
+#define DETECTIONSETTINGS_H
+
+namespace htk::input {
+
+    // How much work WebcamTracker spends on face detection per frame
+    struct DetectionSettings {
+        int interval = 1;           // Run detection every N frames (reuse the last rect in between)
+        float scale = 1.0f;         // Detection resolution relative to the camera frame
+        float searchMargin = 0.0f;  // Search around the last face, in face widths per side (0 = full frame)
+
+        // Reuse the last detection while the face region's mean grey-level
+        // change since then stays below this (0 = always detect)
+        float motionThreshold = 2.0f;
+
+        // Refine each detection to sub-pixel position and scale by matching
+        // the face against a template of an earlier detection
+        bool refine = true;
+
+        // Also run profile cascades (left and mirrored) alongside the frontal
+        // one, in parallel, around the tracked face; the whole frame is only
+        // searched after repeated misses there
+        bool ensemble = true;
+
+        bool operator==(const DetectionSettings& other) const {
+            return interval == other.interval && scale == other.scale &&
+                   searchMargin == other.searchMargin && motionThreshold == other.motionThreshold &&
+                   refine == other.refine && ensemble == other.ensemble;
+        }
+        bool operator!=(const DetectionSettings& other) const { return !(*this == other); }
+    };
+
+} // namespace htk::input
+
+#endif // DETECTIONSETTINGS_H
@@ -0,0 +1,138 @@
+#include "ExposureController.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace htk::input {
+
+namespace {
+
+constexpr float kIntervalAlpha = 0.1f;
+
+// A frame is slow when it took this many nominal periods, and camera-
+// limited when the tracker spent at least this share of it waiting
+constexpr float kSlowFactor = 1.3f;
+constexpr float kWaitShare  = 0.5f;
+
+// Take over after this many slow frames in a row (about two thirds of a
+// second at a halved 30 FPS); give back if the rate still isn't restored
+// this many frames after taking over
+constexpr int kEngageFrames  = 10;
+constexpr int kGiveUpFrames  = 60;
+
+// Cameras take a few frames to show a new setting
+constexpr int kSettleFrames = 4;
+
+// Brightness loop, in stops (log2) from the target
+constexpr float kDeadbandStops = 0.15f;
+constexpr float kMaxStepStops  = 0.5f;
+constexpr double kGainPerStop  = 0.15;
+
+constexpr double kMinExposure = 1e-4;
+constexpr double kStartGain   = 0.3;
+
+} // namespace
+
+void ExposureController::reset(float nominalFps) {
+    m_periodUs = 1e6f / (nominalFps > 0.0f ? nominalFps : 30.0f);
+    m_intervalUs = m_periodUs;
+    m_isEngaged = false;
+    m_gaveUp = false;
+    m_slowFrames = 0;
+    m_engagedFrames = 0;
+    m_settleFrames = 0;
+    m_exposure = 0.0;
+    m_gain = 0.0;
+}
+
+double ExposureController::exposureCap() const {
+    return std::max(kMinExposure, static_cast<double>(m_settings.headroom * m_periodUs) * 1e-6);
+}
+
+ExposureRequest ExposureController::update(uint64_t intervalUs, uint64_t waitUs, float brightness) {
+    ExposureRequest request;
+    if (intervalUs == 0) {
+        return request;
+    }
+    const float interval = static_cast<float>(intervalUs);
+    m_intervalUs += kIntervalAlpha * (interval - m_intervalUs);
+
+    // Switched off while in control: hand the camera back
+    if (!m_settings.enabled) {
+        if (m_isEngaged) {
+            m_isEngaged = false;
+            request.changed = true;
+        }
+        return request;
+    }
+
+    const bool slow = interval > kSlowFactor * m_periodUs &&
+                      static_cast<float>(waitUs) >= kWaitShare * interval;
+    m_slowFrames = slow ? m_slowFrames + 1 : 0;
+
+    if (!m_isEngaged) {
+        if (m_gaveUp || m_slowFrames < kEngageFrames) {
+            return request;
+        }
+
+        std::cout << "Camera at " << measuredFps() << " FPS instead of " << 1e6f / m_periodUs
+                  << " (auto exposure); capping exposure at " << exposureCap() * 1000.0 << " ms" << std::endl;
+        m_isEngaged = true;
+        m_engagedFrames = 0;
+        m_slowFrames = 0;
+        m_exposure = exposureCap();
+        m_gain = kStartGain;
+    } else {
+        ++m_engagedFrames;
+
+        // Still slow long after taking over: the exposure wasn't the cause,
+        // or the camera ignores manual settings
+        if (m_slowFrames >= kEngageFrames && m_engagedFrames >= kGiveUpFrames) {
+            std::cerr << "Camera still at " << measuredFps() << " FPS with capped exposure, "
+                      << "returning to auto exposure" << std::endl;
+            m_isEngaged = false;
+            m_gaveUp = true;
+            request.changed = true;
+            return request;
+        }
+
+        if (m_settleFrames > 0) {
+            --m_settleFrames;
+            return request;
+        }
+
+        const float error = std::log2(m_settings.targetBrightness / std::max(brightness, 1.0f));
+        if (std::abs(error) < kDeadbandStops) {
+            return request;
+        }
+
+        // Brighter: exposure up to the cap, then gain. Darker: gain first.
+        const float stops = std::clamp(error, -kMaxStepStops, kMaxStepStops);
+        const double cap = exposureCap();
+        double exposure = m_exposure;
+        double gain = m_gain;
+        if (stops > 0.0f && exposure < cap) {
+            exposure = std::min(cap, exposure * std::exp2(stops));
+        } else if (stops > 0.0f || gain > 0.0) {
+            gain = std::clamp(gain + kGainPerStop * stops, 0.0, 1.0);
+        } else {
+            exposure = std::max(kMinExposure, exposure * std::exp2(stops));
+        }
+
+        if (exposure == m_exposure && gain == m_gain) {
+            return request;  // Out of range either way
+        }
+        m_exposure = exposure;
+        m_gain = gain;
+    }
+
+    m_settleFrames = kSettleFrames;
+    request.changed = true;
+    request.manual = true;
+    request.exposureSeconds = m_exposure;
+    request.gain = m_gain;
+    return request;
+}
+
+} // namespace htk::input
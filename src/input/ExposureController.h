@@ -0,0 +1,66 @@
+#ifndef EXPOSURECONTROLLER_H
+#define EXPOSURECONTROLLER_H
+
+#include <cstdint>
+
+namespace htk::input {
+
+    struct ExposureSettings {
+        bool enabled = true;
+        float targetBrightness = 110.0f;  // Mean grey level of the face (0..255)
+        float headroom = 0.8f;            // Exposure cap, fraction of the frame period
+    };
+
+    // What the camera should be set to; nothing to do unless changed
+    struct ExposureRequest {
+        bool changed = false;
+        bool manual = false;           // false: back to the camera's auto exposure
+        double exposureSeconds = 0.0;
+        double gain = 0.0;             // 0..1 of the device's range
+    };
+
+    // Keeps auto exposure from trading frame rate for brightness. Watches
+    // the real frame interval, and once the camera keeps delivering well
+    // below its nominal rate while the tracker waits on it, takes manual
+    // control: exposure capped below the frame period, the face kept at
+    // the target brightness with gain (exposure first, up to the cap, since
+    // gain adds noise). Pure logic, frame measurements in and camera
+    // settings out, so it runs the same against a real or simulated camera.
+    class ExposureController {
+    public:
+        void setSettings(const ExposureSettings& settings) { m_settings = settings; }
+        const ExposureSettings& getSettings() const { return m_settings; }
+
+        // New or reopened camera: back to watching in auto exposure
+        void reset(float nominalFps);
+
+        // One delivered frame: time since the previous one and how long the
+        // tracker waited for it (microseconds), and the face brightness
+        // (or the frame's, without a face)
+        ExposureRequest update(uint64_t intervalUs, uint64_t waitUs, float brightness);
+
+        bool isEngaged() const { return m_isEngaged; }
+        float measuredFps() const { return m_intervalUs > 0.0f ? 1e6f / m_intervalUs : 0.0f; }
+        double exposureSeconds() const { return m_exposure; }
+        double gain() const { return m_gain; }
+
+    private:
+        ExposureSettings m_settings;
+        float m_periodUs = 1e6f / 30.0f;
+        float m_intervalUs = 0.0f;  // Smoothed frame interval
+
+        bool m_isEngaged = false;
+        bool m_gaveUp = false;      // Camera ignored manual exposure; stay out of its way
+        int m_slowFrames = 0;       // Consecutive camera-limited slow frames
+        int m_engagedFrames = 0;
+        int m_settleFrames = 0;     // Frames left before the last change shows
+
+        double m_exposure = 0.0;
+        double m_gain = 0.0;
+
+        double exposureCap() const;
+    };
+
+} // namespace htk::input
+
+#endif // EXPOSURECONTROLLER_H
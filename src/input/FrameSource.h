@@ -0,0 +1,62 @@
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+
+#include "../core/Realtime.h"
+
+namespace htk::input {
+
+    // Where WebcamTracker gets its frames from: a live camera, a replayed
+    // video file, or anything else that produces BGR frames
+    class FrameSource {
+    public:
+        virtual ~FrameSource() = default;
+
+        // Open the device/file and negotiate the frame mode
+        virtual bool open() = 0;
+
+        // Read the next BGR frame (blocks until one is available)
+        virtual bool read(cv::Mat& frame) = 0;
+
+        // Advance one frame without decoding it (warm standby)
+        virtual bool grab() = 0;
+
+        virtual void close() = 0;
+        virtual bool isOpened() const = 0;
+
+        // Frame rate the source delivers at (0 if unknown)
+        virtual float nominalFps() const = 0;
+
+        // Presentation time of the last frame (microseconds) for sources
+        // that aren't paced by the wall clock, 0 to use arrival time
+        virtual uint64_t mediaTimeUs() const { return 0; }
+
+        // Capture health, for sources that watch their device (WatchdogSource):
+        // whether the last read() failed because frames stopped arriving
+        // rather than because the source ended
+        virtual bool isStalled() const { return false; }
+
+        // Duration of a reconnect that completed since the last call, from
+        // the last frame before the outage to the first one after (0 = none)
+        virtual uint32_t takeReconnectTime() { return 0; }
+
+        // Scheduling of the source's own capture thread, for sources that
+        // read on one (WatchdogSource): false until that thread has started
+        virtual bool getCaptureRealtime(htk::core::RealtimeStatus& /*status*/) const { return false; }
+
+        // Sensor exposure, for live cameras: manual exposure time (seconds)
+        // and gain (0..1 of the device's range), or back to auto exposure
+        virtual bool hasExposureControl() const { return false; }
+        virtual void setManualExposure(double /*seconds*/, double /*gain*/) {}
+        virtual void restoreAutoExposure() {}
+
+        // Human-readable name for logs
+        virtual std::string describe() const = 0;
+    };
+
+} // namespace htk::input
+
+#endif // FRAMESOURCE_H
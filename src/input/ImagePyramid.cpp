@@ -0,0 +1,58 @@
+#include "ImagePyramid.h"
+#include <algorithm>
+
+namespace htk::input {
+
+void ImagePyramid::reset(const cv::Mat& frame) {
+    m_frame = &frame;
+    m_built = 0;
+}
+
+const cv::Mat& ImagePyramid::level(int index) {
+    index = std::clamp(index, 0, kMaxLevels - 1);
+
+    // cvtColor/pyrDown reuse the buffer while the frame size is steady
+    for (; m_built <= index; ++m_built) {
+        if (m_built == 0) {
+            if (m_frame->channels() == 1) {
+                m_frame->copyTo(m_levels[0]);
+            } else {
+                cv::cvtColor(*m_frame, m_levels[0], cv::COLOR_BGR2GRAY);
+            }
+        } else {
+            cv::pyrDown(m_levels[m_built - 1], m_levels[m_built], levelSize(m_built));
+        }
+    }
+    return m_levels[index];
+}
+
+int ImagePyramid::levelFor(double scale) const {
+    for (int index = kMaxLevels - 1; index > 0; --index) {
+        if (scaleOf(index) >= scale) {
+            return index;
+        }
+    }
+    return 0;
+}
+
+double ImagePyramid::scaleOf(int index) const {
+    if (m_frame == nullptr || m_frame->cols == 0) {
+        return 1.0;
+    }
+    return static_cast<double>(levelSize(index).width) / m_frame->cols;
+}
+
+cv::Size ImagePyramid::levelSize(int index) const {
+    if (m_frame == nullptr) {
+        return cv::Size();
+    }
+
+    // pyrDown's size: halved, rounded up
+    cv::Size size = m_frame->size();
+    for (int i = 0; i < index; ++i) {
+        size = cv::Size((size.width + 1) / 2, (size.height + 1) / 2);
+    }
+    return size;
+}
+
+} // namespace htk::input
@@ -0,0 +1,42 @@
+#ifndef IMAGEPYRAMID_H
+#define IMAGEPYRAMID_H
+
+#include <opencv2/opencv.hpp>
+
+namespace htk::input {
+
+    // Grayscale pyramid of the current frame, shared by everything that
+    // wants the frame smaller (detection, motion gate) or in grey (refinement,
+    // eye search), so no resampling is done twice in a frame. Levels are
+    // built on first use, each from the one above, into buffers that are
+    // reused from frame to frame.
+    class ImagePyramid {
+    public:
+        static constexpr int kMaxLevels = 5;
+
+        // Starts a new frame; nothing is converted until a level is asked
+        // for. The frame must stay untouched until the next reset.
+        void reset(const cv::Mat& frame);
+
+        // Level 0 is the full-size grayscale frame, each further level half
+        // the size of the one above. Read-only, valid until the next reset.
+        const cv::Mat& level(int index);
+
+        // Deepest level still at least scale times the frame size
+        int levelFor(double scale) const;
+
+        // Width of a level relative to level 0
+        double scaleOf(int index) const;
+
+        // Size of a level, whether or not it has been built
+        cv::Size levelSize(int index) const;
+
+    private:
+        const cv::Mat* m_frame = nullptr;
+        cv::Mat m_levels[kMaxLevels];
+        int m_built = 0;
+    };
+
+} // namespace htk::input
+
+#endif // IMAGEPYRAMID_H
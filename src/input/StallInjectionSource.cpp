@@ -0,0 +1,65 @@
+#include "StallInjectionSource.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+namespace htk::input {
+
+namespace {
+
+std::chrono::steady_clock::duration seconds(float s) {
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<float>(std::max(0.0f, s)));
+}
+
+} // namespace
+
+StallInjectionSource::StallInjectionSource(std::unique_ptr<FrameSource> source, float every, float length,
+                                           bool disconnect)
+    : m_source(std::move(source))
+    , m_every(seconds(std::max(every, 0.1f)))
+    , m_length(seconds(length))
+    , m_disconnect(disconnect)
+{
+    m_nextFault = Clock::now() + m_every;
+}
+
+bool StallInjectionSource::open() {
+    // An unplugged camera can't be reopened until the outage is over
+    if (Clock::now() < m_faultEnd) {
+        return false;
+    }
+    return m_source->open();
+}
+
+bool StallInjectionSource::read(cv::Mat& frame) {
+    return beforeRead() && m_source->read(frame);
+}
+
+bool StallInjectionSource::grab() {
+    return beforeRead() && m_source->grab();
+}
+
+std::string StallInjectionSource::describe() const {
+    return m_source->describe() + (m_disconnect ? " (injected disconnects)" : " (injected stalls)");
+}
+
+bool StallInjectionSource::beforeRead() {
+    const auto now = Clock::now();
+    if (now >= m_nextFault) {
+        m_faultEnd = now + m_length;
+        m_nextFault = m_faultEnd + m_every;
+        std::cerr << "Injecting " << (m_disconnect ? "disconnect" : "stall") << " on "
+                  << m_source->describe() << std::endl;
+
+        if (!m_disconnect) {
+            std::this_thread::sleep_until(m_faultEnd);
+            return true;
+        }
+    }
+
+    return now >= m_faultEnd;
+}
+
+} // namespace htk::input
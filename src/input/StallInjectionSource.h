@@ -0,0 +1,50 @@
+#ifndef STALLINJECTIONSOURCE_H
+#define STALLINJECTIONSOURCE_H
+
+#include "FrameSource.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace htk::input {
+
+    // Fault injection for exercising the capture watchdog: wraps a source
+    // and, every `every` seconds, either blocks in read() for `length`
+    // seconds (a hung driver) or fails reads and reopens for that long (an
+    // unplugged camera). Wrap it in a WatchdogSource to see the tracker
+    // coast and reconnect.
+    class StallInjectionSource : public FrameSource {
+    public:
+        StallInjectionSource(std::unique_ptr<FrameSource> source, float every, float length,
+                             bool disconnect = false);
+
+        bool open() override;
+        bool read(cv::Mat& frame) override;
+        bool grab() override;
+        void close() override { m_source->close(); }
+        bool isOpened() const override { return m_source->isOpened(); }
+        float nominalFps() const override { return m_source->nominalFps(); }
+        uint64_t mediaTimeUs() const override { return m_source->mediaTimeUs(); }
+        bool hasExposureControl() const override { return m_source->hasExposureControl(); }
+        void setManualExposure(double seconds, double gain) override { m_source->setManualExposure(seconds, gain); }
+        void restoreAutoExposure() override { m_source->restoreAutoExposure(); }
+        std::string describe() const override;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        std::unique_ptr<FrameSource> m_source;
+        Clock::duration m_every;
+        Clock::duration m_length;
+        bool m_disconnect;
+        Clock::time_point m_nextFault;
+        Clock::time_point m_faultEnd;
+
+        // Inject the fault if one is due; false while "unplugged"
+        bool beforeRead();
+    };
+
+} // namespace htk::input
+
+#endif // STALLINJECTIONSOURCE_H
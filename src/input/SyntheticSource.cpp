@@ -0,0 +1,242 @@
+#include "SyntheticSource.h"
+#include "CameraCalibration.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <thread>
+
+namespace htk::input {
+
+namespace {
+
+constexpr float kTwoPi = 6.28318530718f;
+constexpr float kDegToRad = kTwoPi / 360.0f;
+constexpr float kRadToDeg = 360.0f / kTwoPi;
+
+// Same face width the pose estimator assumes, so errors come from
+// detection and filtering only
+constexpr float kFaceWidthMm = 150.0f;
+
+// Schematic frontal face: dark eye band and mouth on a lighter oval,
+// tilted by angle degrees (clockwise in the image)
+void drawFace(cv::Mat& frame, cv::Point2f center, float width, float angle) {
+    const float c = std::cos(angle * kDegToRad);
+    const float s = std::sin(angle * kDegToRad);
+    const auto at = [&](float dx, float dy) {
+        return cv::Point(cvRound(center.x + (dx * c - dy * s) * width),
+                         cvRound(center.y + (dx * s + dy * c) * width));
+    };
+    const auto size = [&](float w, float h) {
+        return cv::Size(std::max(1, cvRound(w * width)), std::max(1, cvRound(h * width)));
+    };
+
+    cv::ellipse(frame, at(0.0f, -0.45f), size(0.52f, 0.40f), angle, 180, 360, cv::Scalar(40, 45, 60), cv::FILLED);
+    cv::ellipse(frame, at(0.0f, 0.0f), size(0.48f, 0.62f), angle, 0, 360, cv::Scalar(150, 170, 205), cv::FILLED);
+    for (float side : {-1.0f, 1.0f}) {
+        cv::ellipse(frame, at(side * 0.19f, -0.20f), size(0.12f, 0.03f), angle, 0, 360, cv::Scalar(50, 55, 70), cv::FILLED);
+        cv::ellipse(frame, at(side * 0.19f, -0.09f), size(0.10f, 0.05f), angle, 0, 360, cv::Scalar(35, 35, 40), cv::FILLED);
+    }
+    cv::ellipse(frame, at(0.0f, 0.10f), size(0.05f, 0.12f), angle, 0, 360, cv::Scalar(175, 195, 225), cv::FILLED);
+    cv::ellipse(frame, at(0.0f, 0.30f), size(0.16f, 0.04f), angle, 0, 360, cv::Scalar(60, 60, 120), cv::FILLED);
+}
+
+} // namespace
+
+bool parseSyntheticMode(const std::string& text, SyntheticSettings& settings) {
+    int width = 0, height = 0;
+    float fps = 0.0f;
+    if (std::sscanf(text.c_str(), "%dx%d@%f", &width, &height, &fps) != 3 ||
+        width < 64 || height < 48 || fps <= 0.0f) {
+        std::cerr << "Bad synthetic mode '" << text << "' (expected <width>x<height>@<fps>)" << std::endl;
+        return false;
+    }
+    settings.resolution = cv::Size(width, height);
+    settings.fps = fps;
+    return true;
+}
+
+SyntheticSource::SyntheticSource(SyntheticSettings settings)
+    : m_settings(std::move(settings))
+{
+    // Seeded: the same settings always produce the same frames
+    std::mt19937 rng(m_settings.seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const auto range = [&](float lo, float hi) { return lo + (hi - lo) * unit(rng); };
+
+    const float amplitudes[4][2] = {{40.0f, 140.0f}, {20.0f, 70.0f}, {50.0f, 150.0f}, {5.0f, 20.0f}};
+    const float frequencies[4][2] = {{0.1f, 0.4f}, {0.1f, 0.4f}, {0.05f, 0.2f}, {0.1f, 0.3f}};
+    for (int axis = 0; axis < 4; ++axis) {
+        m_amplitude[axis] = range(amplitudes[axis][0], amplitudes[axis][1]);
+        m_frequency[axis] = range(frequencies[axis][0], frequencies[axis][1]);
+        m_phase[axis] = range(0.0f, kTwoPi);
+    }
+    m_baseZ = range(550.0f, 700.0f);
+
+    const CameraCalibration lens = CameraCalibration::nominal(m_settings.resolution);
+    m_focal = static_cast<float>(lens.cameraMatrix()(0, 0));
+    m_principal = cv::Point2f(static_cast<float>(lens.cameraMatrix()(0, 2)),
+                              static_cast<float>(lens.cameraMatrix()(1, 2)));
+}
+
+SyntheticSource::~SyntheticSource() {
+    close();
+}
+
+bool SyntheticSource::open() {
+    if (!m_settings.facePath.empty()) {
+        m_face = cv::imread(m_settings.facePath, cv::IMREAD_COLOR);
+        if (m_face.empty()) {
+            std::cerr << "Failed to read face image " << m_settings.facePath << std::endl;
+            return false;
+        }
+    }
+
+    // Smooth grey clutter: seeded noise at 1/16 size, scaled up
+    const cv::Size noiseSize(std::max(2, m_settings.resolution.width / 16),
+                             std::max(2, m_settings.resolution.height / 16));
+    cv::Mat noise(noiseSize, CV_8UC3);
+    std::mt19937 rng(m_settings.seed * 7919u);
+    std::uniform_int_distribution<int> grey(70, 110);
+    for (int y = 0; y < noise.rows; ++y) {
+        uchar* row = noise.ptr<uchar>(y);
+        for (int x = 0; x < noise.cols * 3; ++x) {
+            row[x] = static_cast<uchar>(grey(rng));
+        }
+    }
+    cv::resize(noise, m_background, m_settings.resolution, 0, 0, cv::INTER_CUBIC);
+
+    m_frameIndex = -1;
+    m_droppedFrames = 0;
+    m_startTime = std::chrono::steady_clock::now();
+    m_isOpen = true;
+    return true;
+}
+
+bool SyntheticSource::read(cv::Mat& frame) {
+    if (!advance()) {
+        return false;
+    }
+    render(frame, m_frameIndex);
+    return true;
+}
+
+bool SyntheticSource::grab() {
+    return advance();
+}
+
+void SyntheticSource::close() {
+    m_isOpen = false;
+}
+
+uint64_t SyntheticSource::mediaTimeUs() const {
+    // Paced behaves like a camera: arrival time it is
+    if (m_settings.paced || m_frameIndex < 0) {
+        return 0;
+    }
+
+    // Offset by a second so the first frame isn't mistaken for "no time"
+    return 1000000 + static_cast<uint64_t>(m_frameIndex * 1e6 / m_settings.fps);
+}
+
+std::string SyntheticSource::describe() const {
+    char text[64];
+    std::snprintf(text, sizeof(text), "synthetic %dx%d@%g", m_settings.resolution.width,
+                  m_settings.resolution.height, m_settings.fps);
+    return text;
+}
+
+bool SyntheticSource::advance() {
+    if (!m_isOpen) {
+        return false;
+    }
+
+    int next = m_frameIndex + 1;
+    if (m_settings.paced) {
+        using namespace std::chrono;
+        const auto due = m_startTime + duration_cast<steady_clock::duration>(duration<double>(next / m_settings.fps));
+        const auto now = steady_clock::now();
+        if (due > now) {
+            std::this_thread::sleep_until(due);
+        } else {
+            // Reader fell behind: hand out the newest frame, like a camera
+            const int newest = static_cast<int>(duration<double>(now - m_startTime).count() * m_settings.fps);
+            if (newest > next) {
+                m_droppedFrames += static_cast<uint64_t>(newest - next);
+                next = newest;
+            }
+        }
+    }
+
+    if (m_settings.frames > 0 && next >= m_settings.frames) {
+        return false;
+    }
+    m_frameIndex = next;
+    return true;
+}
+
+void SyntheticSource::headAt(int frameIndex, Eigen::Vector3f& position, float& roll) const {
+    const float t = static_cast<float>(frameIndex / static_cast<double>(m_settings.fps));
+    float value[4];
+    for (int axis = 0; axis < 4; ++axis) {
+        value[axis] = m_amplitude[axis] * std::sin(kTwoPi * m_frequency[axis] * t + m_phase[axis]);
+    }
+    position = Eigen::Vector3f(value[0], value[1], m_baseZ + value[2]);
+    roll = value[3];
+}
+
+htk::core::Pose SyntheticSource::groundTruth(int frameIndex) const {
+    Eigen::Vector3f position;
+    float roll = 0.0f;
+    headAt(frameIndex, position, roll);
+
+    // Head bearing from the camera, mirrored like the tracker reports it
+    htk::core::Pose pose;
+    pose.rotation = htk::core::rotationFromEuler(-std::atan(position.x() / position.z()) * kRadToDeg,
+                                                 -std::atan(position.y() / position.z()) * kRadToDeg, roll);
+    pose.translation = position;
+    pose.confidence = 1.0f;
+    pose.isValid = true;
+    return pose;
+}
+
+void SyntheticSource::render(cv::Mat& frame, int frameIndex) {
+    Eigen::Vector3f position;
+    float roll = 0.0f;
+    headAt(frameIndex, position, roll);
+
+    const cv::Point2f center(m_principal.x + m_focal * position.x() / position.z(),
+                             m_principal.y + m_focal * position.y() / position.z());
+    const float width = m_focal * kFaceWidthMm / position.z();
+
+    // Reuses the caller's buffer when it is the right size
+    m_background.copyTo(frame);
+
+    // The user's roll shows up mirrored in the image
+    if (m_face.empty()) {
+        drawFace(frame, center, width, -roll);
+        return;
+    }
+
+    // Photo: scaled, rotated and placed in one warp, limited to the area
+    // the face can cover
+    const float height = width * m_face.rows / m_face.cols;
+    const int reach = cvRound(std::hypot(width, height) / 2.0f) + 1;
+    const cv::Rect area = cv::Rect(cvRound(center.x) - reach, cvRound(center.y) - reach, 2 * reach, 2 * reach) &
+                          cv::Rect(0, 0, frame.cols, frame.rows);
+    if (area.area() == 0) {
+        return;
+    }
+
+    const cv::Point2f textureCenter(m_face.cols / 2.0f, m_face.rows / 2.0f);
+    m_transform = cv::getRotationMatrix2D(textureCenter, roll, width / m_face.cols);
+    m_transform.at<double>(0, 2) += center.x - area.x - textureCenter.x;
+    m_transform.at<double>(1, 2) += center.y - area.y - textureCenter.y;
+
+    cv::Mat target = frame(area);
+    cv::warpAffine(m_face, target, m_transform, area.size(), cv::INTER_LINEAR, cv::BORDER_TRANSPARENT);
+}
+
+} // namespace htk::input
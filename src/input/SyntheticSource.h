@@ -0,0 +1,84 @@
+#ifndef SYNTHETICSOURCE_H
+#define SYNTHETICSOURCE_H
+
+#include "FrameSource.h"
+#include "../core/Pose.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace htk::input {
+
+    struct SyntheticSettings {
+        cv::Size resolution{640, 480};
+        float fps = 30.0f;
+        bool paced = true;        // Real-time cadence; false renders as fast as read
+        int frames = 0;           // Stop after this many (0 = endless)
+        uint32_t seed = 1;        // Picks the trajectory and background
+        std::string facePath;     // Face photo to render (empty = drawn face)
+    };
+
+    // "<width>x<height>@<fps>", e.g. 1920x1080@240
+    bool parseSyntheticMode(const std::string& text, SyntheticSettings& settings);
+
+    // Renders a face moving along a known, seeded 6DOF trajectory straight
+    // into memory, at any resolution and frame rate, through a nominal 60
+    // degree lens. Paced mode behaves like a camera that drops frames when
+    // the reader falls behind; unpaced mode is deterministic for offline
+    // accuracy and throughput runs.
+    class SyntheticSource : public FrameSource {
+    public:
+        explicit SyntheticSource(SyntheticSettings settings);
+        ~SyntheticSource() override;
+
+        bool open() override;
+        bool read(cv::Mat& frame) override;
+        bool grab() override;
+        void close() override;
+        bool isOpened() const override { return m_isOpen; }
+        float nominalFps() const override { return m_settings.fps; }
+        uint64_t mediaTimeUs() const override;
+        std::string describe() const override;
+
+        // Index of the frame returned by the last read()/grab()
+        int frameIndex() const { return m_frameIndex; }
+
+        // Frames skipped because the reader fell behind (paced mode)
+        uint64_t droppedFrames() const { return m_droppedFrames; }
+
+        // Exact pose of frame n as the single-camera tracker reports it:
+        // bearing of the head from the camera, roll, position in mm
+        htk::core::Pose groundTruth(int frameIndex) const;
+
+    private:
+        SyntheticSettings m_settings;
+        bool m_isOpen = false;
+        int m_frameIndex = -1;
+        uint64_t m_droppedFrames = 0;
+        std::chrono::steady_clock::time_point m_startTime;
+
+        // Trajectory: sinusoids per axis, drawn from the seed
+        float m_amplitude[4] = {0, 0, 0, 0};  // x, y, z (mm), roll (degrees)
+        float m_frequency[4] = {0, 0, 0, 0};  // Hz
+        float m_phase[4] = {0, 0, 0, 0};
+        float m_baseZ = 600.0f;
+
+        // Lens
+        float m_focal = 0.0f;
+        cv::Point2f m_principal;
+
+        cv::Mat m_background;
+        cv::Mat m_face;       // Photo texture, empty for the drawn face
+        cv::Mat m_transform;  // Texture to frame, 2x3
+
+        // Next frame to deliver; waits for it in paced mode
+        bool advance();
+
+        void headAt(int frameIndex, Eigen::Vector3f& position, float& roll) const;
+        void render(cv::Mat& frame, int frameIndex);
+    };
+
+} // namespace htk::input
+
+#endif // SYNTHETICSOURCE_H
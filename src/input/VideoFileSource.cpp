@@ -0,0 +1,137 @@
+#include "VideoFileSource.h"
+
+#include <iostream>
+#include <thread>
+
+namespace htk::input {
+
+namespace {
+
+// Further behind than this (paused, or the machine slept) the clock restarts
+// instead of decoding its way through the backlog
+constexpr int kMaxDroppedFrames = 30;
+
+} // namespace
+
+VideoFileSource::VideoFileSource(std::string path, bool paced, bool loop)
+    : m_path(std::move(path))
+    , m_paced(paced)
+    , m_loop(loop)
+    , m_nominalFps(0.0f)
+    , m_frameIndex(-1)
+{
+}
+
+VideoFileSource::~VideoFileSource() {
+    close();
+}
+
+bool VideoFileSource::open() {
+    m_video.open(m_path);
+    if (!m_video.isOpened()) {
+        std::cerr << "Failed to open video " << m_path << std::endl;
+        return false;
+    }
+
+    m_nominalFps = static_cast<float>(m_video.get(cv::CAP_PROP_FPS));
+    if (m_nominalFps <= 0.0f) {
+        m_nominalFps = 30.0f;
+    }
+
+    m_frameIndex = -1;
+    m_nextFrameTime = std::chrono::steady_clock::now();
+    return true;
+}
+
+bool VideoFileSource::read(cv::Mat& frame) {
+    if (!dropFrames(waitForFrameTime())) {
+        return false;
+    }
+
+    if (!m_video.read(frame) || frame.empty()) {
+        if (!rewindIfLooping() || !m_video.read(frame) || frame.empty()) {
+            return false;
+        }
+    }
+
+    ++m_frameIndex;
+    return true;
+}
+
+bool VideoFileSource::grab() {
+    return dropFrames(waitForFrameTime()) && grabNext();
+}
+
+bool VideoFileSource::grabNext() {
+    if (!m_video.grab()) {
+        if (!rewindIfLooping() || !m_video.grab()) {
+            return false;
+        }
+    }
+
+    ++m_frameIndex;
+    return true;
+}
+
+uint64_t VideoFileSource::mediaTimeUs() const {
+    // Paced and looping replays behave like a camera: arrival time it is
+    if (m_paced || m_loop || m_frameIndex < 0) {
+        return 0;
+    }
+
+    // Offset by a second so the first frame isn't mistaken for "no time"
+    return 1000000 + static_cast<uint64_t>(m_frameIndex * 1e6 / m_nominalFps);
+}
+
+void VideoFileSource::close() {
+    if (m_video.isOpened()) {
+        m_video.release();
+    }
+}
+
+int VideoFileSource::waitForFrameTime() {
+    if (!m_paced) {
+        return 0;
+    }
+
+    using namespace std::chrono;
+    const auto period = duration_cast<steady_clock::duration>(duration<double>(1.0 / m_nominalFps));
+    const auto now = steady_clock::now();
+
+    if (m_nextFrameTime > now) {
+        std::this_thread::sleep_until(m_nextFrameTime);
+        m_nextFrameTime += period;
+        return 0;
+    }
+
+    // Reader fell behind: the frames that came due meanwhile are gone, as
+    // they would be from a camera, and the file stays on wall time
+    const auto overdue = (now - m_nextFrameTime) / period;
+    if (overdue > kMaxDroppedFrames) {
+        m_nextFrameTime = now + period;
+        return 0;
+    }
+    m_nextFrameTime += (overdue + 1) * period;
+    return static_cast<int>(overdue);
+}
+
+bool VideoFileSource::dropFrames(int count) {
+    for (int i = 0; i < count; ++i) {
+        if (!grabNext()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool VideoFileSource::rewindIfLooping() {
+    if (!m_loop) {
+        return false;
+    }
+
+    m_video.set(cv::CAP_PROP_POS_FRAMES, 0);
+    m_frameIndex = -1;
+    return true;
+}
+
+} // namespace htk::input
@@ -0,0 +1,54 @@
+#ifndef VIDEOFILESOURCE_H
+#define VIDEOFILESOURCE_H
+
+#include "FrameSource.h"
+
+#include <chrono>
+#include <string>
+
+namespace htk::input {
+
+    // Replays a recorded video as if it were a camera. Paced mode releases
+    // frames at the file's frame rate; unpaced mode decodes as fast as the
+    // caller reads (offline evaluation).
+    class VideoFileSource : public FrameSource {
+    public:
+        explicit VideoFileSource(std::string path, bool paced = true, bool loop = false);
+        ~VideoFileSource() override;
+
+        bool open() override;
+        bool read(cv::Mat& frame) override;
+        bool grab() override;
+        void close() override;
+        bool isOpened() const override { return m_video.isOpened(); }
+        float nominalFps() const override { return m_nominalFps; }
+        uint64_t mediaTimeUs() const override;
+        std::string describe() const override { return "video " + m_path; }
+
+        // Index of the frame returned by the last read()/grab()
+        int frameIndex() const { return m_frameIndex; }
+
+    private:
+        cv::VideoCapture m_video;
+        std::string m_path;
+        bool m_paced;
+        bool m_loop;
+        float m_nominalFps;
+        int m_frameIndex;
+        std::chrono::steady_clock::time_point m_nextFrameTime;
+
+        // Block until the next frame is due (paced mode); returns how many
+        // frames came due while the reader was late, to be dropped
+        int waitForFrameTime();
+        bool dropFrames(int count);
+
+        // Next frame without decoding it, rewinding when looping
+        bool grabNext();
+
+        // Rewind at end of file when looping
+        bool rewindIfLooping();
+    };
+
+} // namespace htk::input
+
+#endif // VIDEOFILESOURCE_H
@@ -0,0 +1,276 @@
+#include "WatchdogSource.h"
+#include "../core/Instrumentation.h"
+#include "../core/TrackingData.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+namespace htk::input {
+
+namespace {
+
+// Never call a frame late before this, whatever the frame rate
+constexpr uint64_t kMinStallUs = 150000;
+
+// Cameras take a while to deliver the first frame after opening
+constexpr uint64_t kFirstFrameGraceUs = 2000000;
+
+// Reopen backoff
+constexpr int kMinBackoffMs = 250;
+constexpr int kMaxBackoffMs = 2000;
+
+uint64_t steadyMicros() {
+    return htk::core::FrameTiming::steadyMicros();
+}
+
+} // namespace
+
+WatchdogSource::WatchdogSource(std::unique_ptr<FrameSource> source, float stallFactor,
+                               htk::core::RealtimeSettings realtime)
+    : m_source(std::move(source))
+    , m_stallFactor(std::max(1.5f, stallFactor))
+    , m_realtime(std::move(realtime))
+{
+    m_description = m_source ? m_source->describe() : "none";
+}
+
+WatchdogSource::~WatchdogSource() {
+    close();
+}
+
+bool WatchdogSource::open() {
+    close();
+
+    if (!m_source || !m_source->open()) {
+        return false;
+    }
+
+    m_nominalFps = m_source->nominalFps() > 0.0f ? m_source->nominalFps() : 30.0f;
+    m_description = m_source->describe();
+    m_hasExposureControl = m_source->hasExposureControl();
+    m_exposurePending = m_manualExposure = false;
+
+    m_latestIsFrame = false;
+    m_latestSequence = m_consumedSequence = 0;
+    m_deliveredUs = steadyMicros() + kFirstFrameGraceUs;
+    m_isStalled = false;
+    m_grabOnly = false;
+    m_reconnectUs = 0;
+    m_hasRealtimeStatus = false;
+
+    m_shouldStop = false;
+    m_isRunning = true;
+    m_thread = std::make_unique<std::thread>(&WatchdogSource::captureLoop, this);
+    return true;
+}
+
+bool WatchdogSource::read(cv::Mat& frame) {
+    m_grabOnly = false;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!waitForFrame(lock, true)) {
+        return false;
+    }
+
+    // The caller's old buffer goes back to the capture side for reuse
+    std::swap(frame, m_latest);
+    m_mediaTimeUs = m_latestMediaUs;
+    return true;
+}
+
+bool WatchdogSource::grab() {
+    m_grabOnly = true;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return waitForFrame(lock, false);
+}
+
+bool WatchdogSource::waitForFrame(std::unique_lock<std::mutex>& lock, bool needPixels) {
+    const auto fresh = [&]() {
+        return m_shouldStop || (m_latestSequence != m_consumedSequence && (m_latestIsFrame || !needPixels));
+    };
+
+    // Late once it is stallFactor periods overdue; while already stalled,
+    // come back once per period so the caller keeps its cadence
+    const uint64_t periodUs = static_cast<uint64_t>(1e6f / m_nominalFps);
+    const uint64_t deadlineUs = m_isStalled
+        ? steadyMicros() + periodUs
+        : m_deliveredUs + std::max(kMinStallUs, static_cast<uint64_t>(m_stallFactor * static_cast<float>(periodUs)));
+
+    const auto deadline = std::chrono::steady_clock::time_point(std::chrono::microseconds(deadlineUs));
+    if (!m_frameReady.wait_until(lock, deadline, fresh) || m_shouldStop) {
+        if (!m_isStalled && !m_shouldStop) {
+            m_isStalled = true;
+            std::cerr << "Camera stalled: no frame from " << m_description << " for "
+                      << (steadyMicros() - std::min(steadyMicros(), m_deliveredUs)) / 1000 << " ms" << std::endl;
+        }
+        return false;
+    }
+
+    if (m_isStalled) {
+        std::cout << "Camera " << m_description << " delivering again" << std::endl;
+        m_isStalled = false;
+    }
+    m_consumedSequence = m_latestSequence;
+    m_deliveredUs = m_latestArrivalUs;
+    return true;
+}
+
+void WatchdogSource::setManualExposure(double seconds, double gain) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_manualExposure = true;
+    m_exposureSeconds = seconds;
+    m_exposureGain = gain;
+    m_exposurePending = true;
+}
+
+void WatchdogSource::restoreAutoExposure() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_manualExposure = false;
+    m_exposurePending = true;
+}
+
+void WatchdogSource::applyExposure() {
+    bool manual = false;
+    double seconds = 0.0;
+    double gain = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_exposurePending) {
+            return;
+        }
+        m_exposurePending = false;
+        manual = m_manualExposure;
+        seconds = m_exposureSeconds;
+        gain = m_exposureGain;
+    }
+
+    // Device calls outside the lock: they can be slow
+    if (manual) {
+        m_source->setManualExposure(seconds, gain);
+    } else {
+        m_source->restoreAutoExposure();
+    }
+}
+
+void WatchdogSource::close() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shouldStop = true;
+    }
+    m_frameReady.notify_all();
+
+    // Joins once the current read() returns; a hung driver holds this up,
+    // which is why only shutdown paths close the source
+    if (m_thread && m_thread->joinable()) {
+        m_thread->join();
+    }
+    m_thread.reset();
+
+    if (m_source) {
+        m_source->close();
+    }
+    m_isRunning = false;
+}
+
+bool WatchdogSource::getCaptureRealtime(htk::core::RealtimeStatus& status) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_hasRealtimeStatus) {
+        status = m_realtimeStatus;
+    }
+    return m_hasRealtimeStatus;
+}
+
+void WatchdogSource::captureLoop() {
+    HTK_THREAD_NAME("capture");
+
+    if (m_realtime.enabled) {
+        const htk::core::RealtimeStatus status = htk::core::realtime::applyToCurrentThread(
+            m_realtime.capturePriority, m_realtime.roundRobin, m_realtime.captureCpus);
+        if (!status.message.empty()) {
+            std::cerr << "Capture thread (" << m_description << "): " << status.message << std::endl;
+        }
+        htk::core::realtime::prefaultStack();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_realtimeStatus = status;
+        m_hasRealtimeStatus = true;
+    }
+
+    cv::Mat buffer;
+    uint64_t lastFrameUs = steadyMicros();
+
+    while (!m_shouldStop) {
+        applyExposure();
+
+        const bool grabOnly = m_grabOnly;
+        const bool ok = grabOnly ? m_source->grab() : m_source->read(buffer);
+        if (m_shouldStop) {
+            break;
+        }
+        if (!ok || (!grabOnly && buffer.empty())) {
+            lastFrameUs = reconnect(lastFrameUs);
+            continue;
+        }
+
+        const uint64_t nowUs = steadyMicros();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!grabOnly) {
+                std::swap(buffer, m_latest);
+            }
+            m_latestIsFrame = !grabOnly;
+            m_latestMediaUs = m_source->mediaTimeUs();
+            m_latestArrivalUs = nowUs;
+            ++m_latestSequence;
+        }
+        m_frameReady.notify_one();
+        lastFrameUs = nowUs;
+    }
+}
+
+uint64_t WatchdogSource::reconnect(uint64_t lastFrameUs) {
+    std::cerr << "Lost " << m_description << ", reconnecting in the background" << std::endl;
+
+    int backoffMs = kMinBackoffMs;
+    while (!m_shouldStop) {
+        m_source->close();
+
+        // Sleep in short steps so close() isn't held up by the backoff
+        for (int waited = 0; waited < backoffMs && !m_shouldStop; waited += 50) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        if (m_shouldStop) {
+            break;
+        }
+
+        cv::Mat probe;
+        if (m_source->open() && m_source->read(probe) && !probe.empty()) {
+            const uint64_t nowUs = steadyMicros();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                std::swap(probe, m_latest);
+                m_latestIsFrame = true;
+                m_latestMediaUs = m_source->mediaTimeUs();
+                m_latestArrivalUs = nowUs;
+                ++m_latestSequence;
+
+                // The reopened device starts in auto exposure again
+                m_exposurePending = m_exposurePending || m_manualExposure;
+            }
+            m_frameReady.notify_one();
+
+            m_reconnectUs = static_cast<uint32_t>(std::min<uint64_t>(nowUs - lastFrameUs, UINT32_MAX));
+            std::cout << "Reconnected " << m_description << " after "
+                      << (nowUs - lastFrameUs) / 1000 << " ms" << std::endl;
+            return nowUs;
+        }
+
+        backoffMs = std::min(backoffMs * 2, kMaxBackoffMs);
+    }
+    return lastFrameUs;
+}
+
+} // namespace htk::input
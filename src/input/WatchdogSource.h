@@ -0,0 +1,103 @@
+#ifndef WATCHDOGSOURCE_H
+#define WATCHDOGSOURCE_H
+
+#include "FrameSource.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace htk::input {
+
+    // Guards a source that can hang (USB cameras). A capture thread does the
+    // blocking reads; read() waits for its next frame only until the frame
+    // is clearly late against the negotiated FPS, then reports a stall so
+    // the tracker can coast instead of freezing. When the device fails the
+    // capture thread reopens it in the background with backoff.
+    class WatchdogSource : public FrameSource {
+    public:
+        // A frame is late after stallFactor frame periods (at least 150 ms).
+        // With realtime enabled, the capture thread runs at its capture
+        // priority on its capture CPUs.
+        explicit WatchdogSource(std::unique_ptr<FrameSource> source, float stallFactor = 3.0f,
+                                htk::core::RealtimeSettings realtime = {});
+        ~WatchdogSource() override;
+
+        bool open() override;
+        bool read(cv::Mat& frame) override;
+        bool grab() override;
+        void close() override;
+        bool isOpened() const override { return m_isRunning; }
+        float nominalFps() const override { return m_nominalFps; }
+        uint64_t mediaTimeUs() const override { return m_mediaTimeUs; }
+        std::string describe() const override { return m_description; }
+
+        bool isStalled() const override { return m_isStalled; }
+        uint32_t takeReconnectTime() override { return m_reconnectUs.exchange(0); }
+        bool getCaptureRealtime(htk::core::RealtimeStatus& status) const override;
+
+        // Queued for the capture thread, which owns the device; reapplied
+        // after a reconnect
+        bool hasExposureControl() const override { return m_hasExposureControl; }
+        void setManualExposure(double seconds, double gain) override;
+        void restoreAutoExposure() override;
+
+    private:
+        std::unique_ptr<FrameSource> m_source;  // Capture thread only once running
+        float m_stallFactor;
+        htk::core::RealtimeSettings m_realtime;
+        float m_nominalFps = 0.0f;
+        std::string m_description;
+
+        std::unique_ptr<std::thread> m_thread;
+        std::atomic<bool> m_isRunning{false};
+        std::atomic<bool> m_shouldStop{false};
+        std::atomic<bool> m_grabOnly{false};
+        std::atomic<uint32_t> m_reconnectUs{0};
+
+        // Hand-off: the capture thread fills its own buffer and swaps it
+        // with m_latest, read() swaps m_latest with the caller's frame
+        mutable std::mutex m_mutex;
+        std::condition_variable m_frameReady;
+        cv::Mat m_latest;
+        bool m_latestIsFrame = false;   // false after a grab()
+        uint64_t m_latestSequence = 0;
+        uint64_t m_latestMediaUs = 0;
+        uint64_t m_latestArrivalUs = 0;
+
+        // What the capture thread got when it started (realtime only)
+        htk::core::RealtimeStatus m_realtimeStatus;
+        bool m_hasRealtimeStatus = false;
+
+        // Exposure wanted by the reader, applied between reads
+        bool m_hasExposureControl = false;
+        bool m_exposurePending = false;
+        bool m_manualExposure = false;
+        double m_exposureSeconds = 0.0;
+        double m_exposureGain = 0.0;
+
+        // Reader side
+        uint64_t m_consumedSequence = 0;
+        uint64_t m_deliveredUs = 0;     // Arrival of the last frame handed out
+        uint64_t m_mediaTimeUs = 0;
+        bool m_isStalled = false;
+
+        void captureLoop();
+
+        // Hand the queued exposure setting to the device (capture thread)
+        void applyExposure();
+
+        // Wait for a fresh frame (or grab) until it is late
+        bool waitForFrame(std::unique_lock<std::mutex>& lock, bool needPixels);
+
+        // Close, back off, reopen; returns the arrival time of the first
+        // frame after it (or lastFrameUs when stopping)
+        uint64_t reconnect(uint64_t lastFrameUs);
+    };
+
+} // namespace htk::input
+
+#endif // WATCHDOGSOURCE_H
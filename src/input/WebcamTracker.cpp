@@ -1,33 +1,198 @@
 #include "WebcamTracker.h"
+#include "CameraSource.h"
+#include "WatchdogSource.h"
+#include "../core/Instrumentation.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace htk::input {
 
+namespace {
+
+// Side of the face thumbnail the motion gate compares
+constexpr int kThumbSize = 16;
+
+// Detection scales within this of a pyramid level run on the level as is
+constexpr double kMinResample = 0.97;
+
+// Pyramid level the whole-frame brightness is measured on (relative size)
+constexpr double kBrightnessScale = 0.125;
+
+// Ensemble: search margin around the tracked face when the CPU governor
+// doesn't set one, misses there before the whole frame is searched, and
+// how often a whole-frame search runs the profile cascades as well (the
+// frontal one alone otherwise)
+constexpr float kEnsembleMargin    = 0.5f;
+constexpr int   kEscalateMisses    = 3;
+constexpr int   kFullEnsembleEvery = 4;
+
+// Profile cascade weights aren't on the frontal cascade's scale: a face
+// found only in profile is at most this confident
+constexpr float kMaxProfileConfidence = 0.5f;
+
+// Re-detect at least this often even when nothing seems to move, so slow
+// drift below the threshold can't pile up
+constexpr int kMaxStaticFrames = 30;
+
+// Coasting velocity decays with this time constant, so a lost face drifts
+// at most velocity * tau from where it was last seen
+constexpr float kCoastTau = 0.15f;
+
+// Detections further apart than this say nothing about velocity
+constexpr uint64_t kMaxVelocityGapUs = 250000;
+
+// Physical width the cascade's face box spans on an adult head
+constexpr float kFaceWidthMm = 150.0f;
+
+constexpr float kRadToDeg = 180.0f / 3.14159265358979f;
+
+// Cascade level weight (final stage sum) mapped to confidence: a logistic
+// centred where weak, flickering detections sit, so clean faces saturate
+// near 1 and marginal ones drop towards the floor
+constexpr double kWeightMidpoint = 1.0;
+constexpr double kWeightSpread   = 0.75;
+constexpr float  kMinConfidence  = 0.05f;
+
+// Refinement template: the inner part of the face box (the edges carry
+// background), matched within a few percent of the face width around the
+// detection at three scales
+constexpr float kTemplateFraction = 0.6f;
+constexpr int   kMinTemplateSize  = 12;
+constexpr float kRefineSearch     = 0.06f;
+constexpr float kRefineScaleStep  = 0.03f;
+
+// Below this correlation, or further than this from the detection (in face
+// widths / relative scale), the template no longer describes the face
+// and is recaptured from the detection
+constexpr double kRefineMinScore = 0.7;
+constexpr float  kRefineMaxShift = 0.1f;
+constexpr float  kRefineMaxScale = 0.1f;
+
+// Eye search: the band of the face box the eyes sit in, eye sizes and
+// spacing relative to the face width, and the tilt the frontal cascade
+// can still see a face at
+constexpr float kEyeBandTop     = 0.2f;
+constexpr float kEyeBandBottom  = 0.55f;
+constexpr int   kMinEyeSize     = 12;
+constexpr float kMinEyeFraction = 0.12f;
+constexpr float kMaxEyeFraction = 0.4f;
+constexpr float kMinEyeSpacing  = 0.25f;
+constexpr float kMaxEyeSpacing  = 0.7f;
+constexpr float kMaxRollDeg     = 40.0f;
+
+// Vertex of the parabola through three samples, relative to the middle
+// one (-0.5..0.5)
+float parabolicPeak(float left, float center, float right) {
+    const float curvature = left - 2.0f * center + right;
+    if (curvature >= 0.0f) {
+        return 0.0f;  // Not a maximum
+    }
+    return std::clamp(0.5f * (left - right) / curvature, -0.5f, 0.5f);
+}
+
+float confidenceFromWeight(double weight) {
+    const double c = 1.0 / (1.0 + std::exp(-(weight - kWeightMidpoint) / kWeightSpread));
+    return std::max(kMinConfidence, static_cast<float>(c));
+}
+
+// rect grown by margin face sizes on every side
+cv::Rect expandRect(const cv::Rect& rect, float margin) {
+    const int mx = static_cast<int>(rect.width  * margin);
+    const int my = static_cast<int>(rect.height * margin);
+    return cv::Rect(rect.x - mx, rect.y - my, rect.width + 2 * mx, rect.height + 2 * my);
+}
+
+} // namespace
+
 WebcamTracker::WebcamTracker()
     : m_isInitialized(false)
     , m_isTracking(false)
+    , m_cameraIndex(-1)
     , m_smoothingFactor(0.5f)
 {
-    m_trackingData.reset();
-    m_centerPosition.reset();
+    for (auto& run : m_runs) {
+        run.faces.reserve(16);
+    }
+    for (auto& eyes : m_eyes) {
+        eyes.reserve(16);
+    }
 }
 
 WebcamTracker::~WebcamTracker() {
     shutdown();
 }
 
-    bool WebcamTracker::initialize(int cameraIndex) {
-    // Open camera
-    m_camera.open(cameraIndex);
-    if (!m_camera.isOpened()) {
-        std::cerr << "Failed to open camera " << cameraIndex << std::endl;
+bool WebcamTracker::initialize(int cameraIndex, const htk::core::RealtimeSettings& captureRealtime) {
+    // Already warm on this camera: keep the open device, loaded cascade
+    // and last tracking state instead of renegotiating everything
+    if (m_isInitialized && m_source && m_source->isOpened() && m_cameraIndex == cameraIndex) {
+        return true;
+    }
+
+    // Reopening the same camera after shutdown keeps face and filter state
+    // USB cameras can hang in read(); the watchdog keeps update() on time
+    auto camera = std::make_unique<WatchdogSource>(std::make_unique<CameraSource>(cameraIndex), 3.0f,
+                                                   captureRealtime);
+    if (!openSource(std::move(camera), m_cameraIndex == cameraIndex)) {
+        return false;
+    }
+
+    m_cameraIndex = cameraIndex;
+    return true;
+}
+
+bool WebcamTracker::initialize(std::unique_ptr<FrameSource> source) {
+    if (!openSource(std::move(source), false)) {
+        return false;
+    }
+
+    m_cameraIndex = -1;
+    return true;
+}
+
+bool WebcamTracker::openSource(std::unique_ptr<FrameSource> source, bool keepState) {
+    if (m_source) {
+        m_source->close();
+    }
+    m_source = std::move(source);
+    m_isInitialized = false;
+
+    if (!m_source || !m_source->open()) {
         return false;
     }
 
-    // Set camera properties
-    m_camera.set(cv::CAP_PROP_FRAME_WIDTH, 640);
-    m_camera.set(cv::CAP_PROP_FRAME_HEIGHT, 480);
-    m_camera.set(cv::CAP_PROP_FPS, 30);
+    m_nominalFps = m_source->nominalFps();
+    m_exposure.reset(m_nominalFps);
+    m_lastArrivalUs = 0;
+
+    // New source means previous face position and filter state are stale
+    if (!keepState) {
+        m_lastFaceRect = cv::Rect();
+        m_motionReference.release();
+        m_hasTemplate = false;
+        m_roll = Eigen::Vector2f::UnitX();
+        m_pose.reset();
+        m_isTracking = false;
+        m_isCoasting = false;
+        m_detectedUs = 0;
+        m_missStartUs = 0;
+    }
+
+    if (!loadCascade()) {
+        return false;
+    }
+
+    m_isInitialized = true;
+    std::cout << "Tracking from " << m_source->describe() << std::endl;
+    return true;
+}
+
+bool WebcamTracker::loadCascade() {
+    // The cascade survives source changes and shutdown, only load it once
+    if (!m_faceCascade.empty()) {
+        return true;
+    }
 
     // Cascade file
     std::vector<std::string> cascadePaths = {
@@ -37,38 +202,96 @@ WebcamTracker::~WebcamTracker() {
         "../../../resources/models/haarcascade_frontalface_default.xml"
     };
 
-    bool cascadeLoaded = false;
     for (const auto& path : cascadePaths) {
         if (m_faceCascade.load(path)) {
             std::cout << "Loaded face cascade from: " << path << std::endl;
-            cascadeLoaded = true;
-            break;
+            loadEyeCascade();
+            loadProfileCascade();
+            return true;
         }
     }
 
-    if (!cascadeLoaded) {
-        std::cerr << "Failed to load face cascade from any path" << std::endl;
-        std::cerr << "Tried:" << std::endl;
-        for (const auto& path : cascadePaths) {
-            std::cerr << "  - " << path << std::endl;
+    std::cerr << "Failed to load face cascade from any path" << std::endl;
+    std::cerr << "Tried:" << std::endl;
+    for (const auto& path : cascadePaths) {
+        std::cerr << "  - " << path << std::endl;
+    }
+    std::cerr << "Download from: https://github.com/opencv/opencv/tree/master/data/haarcascades" << std::endl;
+    return false;
+}
+
+void WebcamTracker::loadEyeCascade() {
+    // Optional: without it roll stays at zero
+    const std::vector<std::string> eyePaths = {
+        "resources/models/haarcascade_eye.xml",
+        "../resources/models/haarcascade_eye.xml",
+        "../../resources/models/haarcascade_eye.xml",
+        "../../../resources/models/haarcascade_eye.xml"
+    };
+
+    for (const auto& path : eyePaths) {
+        if (m_eyeCascades[0].load(path) && m_eyeCascades[1].load(path)) {
+            std::cout << "Loaded eye cascade from: " << path << std::endl;
+            return;
         }
-        std::cerr << "Download from: https://github.com/opencv/opencv/tree/master/data/haarcascades" << std::endl;
-        return false;
     }
+    std::cerr << "No eye cascade (haarcascade_eye.xml) found, roll will not be tracked" << std::endl;
+}
 
-    m_isInitialized = true;
-    std::cout << "Head-Tracking Kit initialized successfully" << std::endl;
-    return true;
+void WebcamTracker::loadProfileCascade() {
+    // Optional: without it only the frontal cascade runs
+    const std::vector<std::string> profilePaths = {
+        "resources/models/haarcascade_profileface.xml",
+        "../resources/models/haarcascade_profileface.xml",
+        "../../resources/models/haarcascade_profileface.xml",
+        "../../../resources/models/haarcascade_profileface.xml"
+    };
+
+    for (const auto& path : profilePaths) {
+        if (m_profileCascades[0].load(path) && m_profileCascades[1].load(path)) {
+            std::cout << "Loaded profile cascade from: " << path << std::endl;
+            return;
+        }
+    }
+    std::cerr << "No profile cascade (haarcascade_profileface.xml) found, "
+              << "faces turned far away will be lost" << std::endl;
 }
 
 bool WebcamTracker::update() {
-    if (!m_isInitialized || !m_camera.isOpened()) {
+    if (!m_isInitialized || !m_source->isOpened()) {
         return false;
     }
 
-    // Capture frame
-    if (!m_camera.read(m_currentFrame)) {
-        std::cerr << "Failed to read frame from camera" << std::endl;
+    using htk::core::FrameTiming;
+    const uint64_t captureStart = FrameTiming::steadyMicros();
+
+    // Capture frame. A stalled camera still produces an update: the pose
+    // coasts (or goes invalid) while the source reconnects in the background.
+    bool haveFrame = false;
+    {
+        HTK_ZONE("capture");
+        haveFrame = m_source->read(m_currentFrame);
+    }
+    m_reconnectUs = m_source->takeReconnectTime();
+    m_isStalled = !haveFrame && m_source->isStalled();
+
+    if (m_isStalled) {
+        const uint64_t nowUs = FrameTiming::steadyMicros();
+        m_frameTimeUs = nowUs;
+        m_isDuplicateFrame = false;
+        m_wasGated = false;
+        m_reacquireUs = 0;
+        m_lastArrivalUs = 0;
+        missFace();
+
+        m_pose.timestamp = htk::core::TrackingData::now();
+        m_frameTiming = FrameTiming{};
+        m_frameTiming.captureUs = static_cast<uint32_t>(nowUs - captureStart);
+        return true;
+    }
+
+    if (!haveFrame) {
+        std::cerr << "Failed to read frame from " << m_source->describe() << std::endl;
         return false;
     }
 
@@ -76,113 +299,721 @@ bool WebcamTracker::update() {
         return false;
     }
 
-    // Detect face
-    cv::Rect faceRect;
-    if (detectFace(m_currentFrame, faceRect)) {
+    const uint64_t detectStart = FrameTiming::steadyMicros();
+    const uint64_t detectCpuStart = FrameTiming::threadCpuMicros();
+    m_workerCpuUs = 0;
+    m_frameArrivalUs = detectStart;
+
+    // Motion is timed by the source's clock when it has one (offline
+    // replay), so results don't depend on how fast frames are processed
+    const uint64_t mediaTime = m_source->mediaTimeUs();
+    m_frameTimeUs = mediaTime != 0 ? mediaTime : detectStart;
+
+    // Levels are converted on first use this frame, then shared
+    m_pyramid.reset(m_currentFrame);
+
+    const uint64_t signature = frameSignature(m_currentFrame);
+    m_isDuplicateFrame = signature == m_frameSignature;
+    m_frameSignature = signature;
+
+    // Detect face, or reuse the last one on frames the detection interval
+    // skips and while the face region is static
+    cv::Rect faceRect = m_lastFaceRect;
+    const bool skipDetection = m_isTracking &&
+                               ++m_framesSinceDetection < m_detectionSettings.interval;
+    m_wasGated = !skipDetection && m_isTracking && isFaceRegionStatic();
+
+    bool detected = skipDetection || m_wasGated;
+    if (!detected) {
+        m_framesSinceDetection = 0;
+        detected = detectFace(faceRect);
+        if (detected) {
+            m_faceEstimate = refineFaceRect(faceRect);
+            estimateRoll(m_faceEstimate);
+            faceThumbnail(faceRect, m_motionReference);
+            m_staticFrames = 0;
+        }
+    }
+
+    const uint64_t poseStart = FrameTiming::steadyMicros();
+    const uint64_t detectCpuUs = FrameTiming::threadCpuMicros() - detectCpuStart + m_workerCpuUs;
+    const bool reacquired = detected && m_missStartUs != 0;
+    m_reacquireUs = reacquired ? static_cast<uint32_t>(m_frameTimeUs - m_missStartUs) : 0;
+
+    if (detected) {
         m_lastFaceRect = faceRect;
-        estimatePose(faceRect);
+        estimatePose(m_faceEstimate);
         m_isTracking = true;
-        m_trackingData.isValid = true;
-        m_trackingData.confidence = 1.0f;
+        m_isCoasting = false;
+        m_missStartUs = 0;
+        m_pose.isValid = true;
+        m_pose.confidence = m_faceConfidence;
+
+        if (!skipDetection) {
+            updateMotion(faceRect, m_frameTimeUs, reacquired);
+        }
     } else {
-        m_isTracking = false;
-        m_trackingData.isValid = false;
-        m_trackingData.confidence = 0.0f;
+        missFace();
     }
 
-    m_trackingData.timestamp = htk::core::TrackingData::now();
+    m_pose.timestamp = htk::core::TrackingData::now();
+
+    const uint64_t poseEnd = FrameTiming::steadyMicros();
+    m_frameTiming.captureUs = static_cast<uint32_t>(detectStart - captureStart);
+    m_frameTiming.detectUs  = static_cast<uint32_t>(poseStart - detectStart);
+    m_frameTiming.poseUs    = static_cast<uint32_t>(poseEnd - poseStart);
+    m_frameTiming.detectCpuUs = static_cast<uint32_t>(detectCpuUs);
 
+    controlExposure(detectStart - captureStart);
     return true;
 }
 
-bool WebcamTracker::detectFace(const cv::Mat& frame, cv::Rect& faceRect) {
-    // Convert to grayscale for better detection
-    cv::Mat gray;
-    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-    cv::equalizeHist(gray, gray);
-
-    // Detect faces
-    std::vector<cv::Rect> faces;
-    m_faceCascade.detectMultiScale(
-        gray,
-        faces,
-        1.1,  // Scale factor
-        3,    // Min neighbors
-        0,    // Flags
-        cv::Size(80, 80)  // Min size
+void WebcamTracker::missFace() {
+    if (m_missStartUs == 0) {
+        m_missStartUs = m_frameTimeUs;
+    }
+
+    // Brief misses keep the pose moving instead of freezing the view
+    m_isCoasting = m_detectedUs != 0 && m_coastTime > 0.0f &&
+                   static_cast<float>(m_frameTimeUs - m_missStartUs) < m_coastTime * 1e6f;
+    m_isTracking = false;
+
+    if (m_isCoasting) {
+        coast(m_frameTimeUs);
+    } else {
+        m_pose.isValid = false;
+        m_pose.confidence = 0.0f;
+        m_hasTemplate = false;
+        m_roll = Eigen::Vector2f::UnitX();
+    }
+}
+
+bool WebcamTracker::idle() {
+    if (!m_isInitialized || !m_source->isOpened()) {
+        return false;
+    }
+
+    // The gap while idle says nothing about the camera's frame rate
+    m_lastArrivalUs = 0;
+    return m_source->grab();
+}
+
+void WebcamTracker::controlExposure(uint64_t waitUs) {
+    const uint64_t intervalUs = m_lastArrivalUs != 0 ? m_frameArrivalUs - m_lastArrivalUs : 0;
+    m_lastArrivalUs = m_frameArrivalUs;
+    if (intervalUs == 0 || !m_source->hasExposureControl()) {
+        return;
+    }
+    HTK_ZONE("exposure");
+
+    // The face's brightness from its detection thumbnail; without a face,
+    // the whole frame's from a small pyramid level
+    const cv::Mat& sample = m_isTracking && !m_motionReference.empty()
+        ? m_motionReference
+        : m_pyramid.level(m_pyramid.levelFor(kBrightnessScale));
+    const float brightness = static_cast<float>(cv::mean(sample)[0]);
+
+    const ExposureRequest request = m_exposure.update(intervalUs, waitUs, brightness);
+    if (!request.changed) {
+        return;
+    }
+    if (request.manual) {
+        m_source->setManualExposure(request.exposureSeconds, request.gain);
+    } else {
+        m_source->restoreAutoExposure();
+    }
+}
+
+bool WebcamTracker::detectFace(cv::Rect& faceRect) {
+    HTK_ZONE("detect");
+
+    const cv::Size frameSize = m_currentFrame.size();
+    const cv::Rect fullFrame(0, 0, frameSize.width, frameSize.height);
+    const double scale = std::clamp(static_cast<double>(m_detectionSettings.scale), 0.1, 1.0);
+    const bool ensemble = m_detectionSettings.ensemble && !m_profileCascades[0].empty();
+
+    // The search area changes size every frame; detecting into a view of
+    // one full-size buffer keeps that from reallocating
+    if (m_detectBuffer.cols < frameSize.width || m_detectBuffer.rows < frameSize.height) {
+        m_detectBuffer.create(frameSize, CV_8UC1);
+    }
+
+    // Search passes, most likely area first, whole frame last
+    struct Pass {
+        cv::Rect area;
+        int minFace;
+        int maxFace;
+    };
+    Pass passes[3];
+    int passCount = 0;
+
+    if (m_isCoasting) {
+        // Re-acquiring: where and how big the face should be by now, widening
+        const cv::Rect predicted = predictFaceRect(m_frameTimeUs);
+        const int minFace = static_cast<int>(predicted.width * 0.7f);
+        const int maxFace = static_cast<int>(predicted.width * 1.5f);
+        passes[passCount++] = { expandRect(predicted, 0.5f) & fullFrame, minFace, maxFace };
+        passes[passCount++] = { expandRect(predicted, 1.5f) & fullFrame, minFace, maxFace };
+    } else if (m_isTracking && m_lastFaceRect.area() > 0 &&
+               (m_detectionSettings.searchMargin > 0.0f || ensemble)) {
+        // The ensemble always stays on the face's neighbourhood
+        const float margin = m_detectionSettings.searchMargin > 0.0f ? m_detectionSettings.searchMargin
+                                                                     : kEnsembleMargin;
+        passes[passCount++] = { expandRect(m_lastFaceRect, margin) & fullFrame, 0, 0 };
+    }
+    const int aroundFace = passCount;
+    passes[passCount++] = { fullFrame, 0, 0 };
+
+    for (int i = 0; i < passCount; ++i) {
+        const Pass& pass = passes[i];
+        if (pass.area.area() == 0) {
+            continue;
+        }
+
+        // Three detectors over the whole frame is the expensive case: only
+        // after the face has been missed around where it was a few times,
+        // and then (as while no face is tracked at all) on one whole-frame
+        // search in kFullEnsembleEvery, the frontal cascade alone on the rest
+        bool passEnsemble = ensemble;
+        if (ensemble && i == aroundFace) {
+            if (aroundFace > 0 && ++m_roiMisses < kEscalateMisses) {
+                return false;
+            }
+            passEnsemble = m_fullFrameSearches++ % kFullEnsembleEvery == 0;
+        }
+        if (detectInArea(pass.area, scale, pass.minFace, pass.maxFace, passEnsemble, faceRect)) {
+            m_roiMisses = 0;
+            m_fullFrameSearches = 0;
+            return true;
+        }
+        if (pass.area == fullFrame) {
+            break;
+        }
+    }
+    return false;
+}
+
+bool WebcamTracker::detectInArea(const cv::Rect& area, double scale, int minFace, int maxFace, bool ensemble,
+                                 cv::Rect& faceRect) {
+    // Start from the smallest pyramid level that still has the resolution
+    // asked for; only the rest of the way is resampled here, nothing at
+    // all when the scale is a power of two
+    const int index = m_pyramid.levelFor(scale);
+    const cv::Mat& level = m_pyramid.level(index);
+    const double levelScale = m_pyramid.scaleOf(index);
+    const double remaining = scale / levelScale;
+    const cv::Rect levelArea = cv::Rect(static_cast<int>(area.x * levelScale), static_cast<int>(area.y * levelScale),
+                                        cvCeil(area.width * levelScale), cvCeil(area.height * levelScale)) &
+                               cv::Rect(0, 0, level.cols, level.rows);
+
+    const cv::Mat search = level(levelArea);
+    cv::Mat detectImage;
+    if (remaining < kMinResample) {
+        const cv::Size detectSize(std::max(1, static_cast<int>(search.cols * remaining)),
+                                  std::max(1, static_cast<int>(search.rows * remaining)));
+        detectImage = m_detectBuffer(cv::Rect(cv::Point(), detectSize));
+        cv::resize(search, detectImage, detectSize, 0, 0, cv::INTER_AREA);
+        cv::equalizeHist(detectImage, detectImage);
+    } else {
+        detectImage = m_detectBuffer(cv::Rect(cv::Point(), search.size()));
+        cv::equalizeHist(search, detectImage);
+    }
+    const double detectScale = levelScale * detectImage.cols / std::max(1, search.cols);
+
+    // Cascade window is 24x24; never ask for less
+    const int minSize = std::max(24, static_cast<int>((minFace > 0 ? minFace : 80) * detectScale));
+    const int maxSize = maxFace > 0 ? std::max(minSize, static_cast<int>(maxFace * detectScale)) : 0;
+
+    // Detect faces, with the cascade's score for each; the profile
+    // detectors alongside the frontal one, so they add no latency
+    const int frameWidth = m_detectBuffer.cols;
+    const int frameHeight = m_detectBuffer.rows;
+    auto runCascade = [&](int detector) {
+        CascadeRun& run = m_runs[detector];
+        run.faces.clear();
+        run.rejectLevels.clear();
+        run.levelWeights.clear();
+
+        cv::Mat image = detectImage;
+        if (detector == 2) {
+            if (run.mirrored.cols < frameWidth || run.mirrored.rows < frameHeight) {
+                run.mirrored.create(frameHeight, frameWidth, CV_8UC1);
+            }
+            image = run.mirrored(cv::Rect(cv::Point(), detectImage.size()));
+            cv::flip(detectImage, image, 1);
+        }
+
+        cv::CascadeClassifier& cascade = detector == 0 ? m_faceCascade : m_profileCascades[detector - 1];
+        HTK_OPENCV_ALLOCATES();
+        cascade.detectMultiScale(
+            image,
+            run.faces,
+            run.rejectLevels,
+            run.levelWeights,
+            1.1,  // Scale factor
+            3,    // Min neighbors
+            0,    // Flags
+            cv::Size(minSize, minSize),  // Min size
+            cv::Size(maxSize, maxSize),  // Max size (0 = unlimited)
+            true  // Output reject levels and weights
+        );
+    };
+
+    const int detectors = ensemble ? kDetectorCount : 1;
+    m_workers.run(detectors, runCascade);
+    m_workerCpuUs += m_workers.lastBatchCpuUs();
+
+    // Largest face per detector. The frontal cascade wins whenever it finds
+    // one: its box is what the pose model expects, and its weights can't be
+    // compared with the profile cascade's. Otherwise the more confident
+    // profile side (same cascade both ways, so that comparison holds).
+    int bestDetector = -1;
+    size_t bestFace = 0;
+    float bestConfidence = 0.0f;
+    for (int detector = 0; detector < detectors; ++detector) {
+        const CascadeRun& run = m_runs[detector];
+        if (run.faces.empty()) {
+            continue;
+        }
+
+        size_t best = 0;
+        for (size_t i = 1; i < run.faces.size(); ++i) {
+            if (run.faces[i].area() > run.faces[best].area()) {
+                best = i;
+            }
+        }
+        const float confidence = best < run.levelWeights.size() ? confidenceFromWeight(run.levelWeights[best]) : 1.0f;
+        if (bestDetector < 0 || confidence > bestConfidence) {
+            bestDetector = detector;
+            bestFace = best;
+            bestConfidence = confidence;
+        }
+        if (detector == 0) {
+            break;
+        }
+    }
+    if (bestDetector < 0) {
+        return false;
+    }
+    m_faceConfidence = bestDetector == 0 ? bestConfidence : std::min(bestConfidence, kMaxProfileConfidence);
+
+    // Back to camera frame coordinates (and out of the mirror)
+    cv::Rect face = m_runs[bestDetector].faces[bestFace];
+    if (bestDetector == 2) {
+        face.x = detectImage.cols - face.x - face.width;
+    }
+    faceRect = cv::Rect(
+        static_cast<int>(levelArea.x / levelScale + face.x / detectScale),
+        static_cast<int>(levelArea.y / levelScale + face.y / detectScale),
+        static_cast<int>(face.width  / detectScale),
+        static_cast<int>(face.height / detectScale)
     );
+    return true;
+}
+
+cv::Rect2f WebcamTracker::refineFaceRect(const cv::Rect& detected) {
+    const cv::Rect2f raw(detected);
+    if (!m_detectionSettings.refine) {
+        return raw;
+    }
+    HTK_ZONE("refine");
+
+    cv::Rect2f refined;
+    if (m_hasTemplate && matchFaceTemplate(detected, refined)) {
+        return refined;
+    }
 
-    if (faces.empty()) {
+    // First detection, or the face changed too much: this one is the new anchor
+    captureFaceTemplate(raw);
+    return raw;
+}
+
+bool WebcamTracker::matchFaceTemplate(const cv::Rect& detected, cv::Rect2f& refined) {
+    const float detectedWidth = static_cast<float>(detected.width);
+    if (std::abs(detectedWidth / m_templateFaceWidth - 1.0f) > kRefineMaxScale) {
+        return false;
+    }
+
+    const cv::Mat& gray = m_pyramid.level(0);
+    if (gray.size() != m_templateBuffer.size()) {
+        return false;  // Captured at another resolution
+    }
+    const cv::Rect fullFrame(0, 0, gray.cols, gray.rows);
+    const cv::Point2f detectedCenter(detected.x + detected.width / 2.0f, detected.y + detected.height / 2.0f);
+    const int margin = std::max(2, static_cast<int>(detectedWidth * kRefineSearch));
+
+    // Best correlation at the template's own scale and one step either side
+    double scores[3] = {-1.0, -1.0, -1.0};
+    int bestStep = -1;
+    cv::Point2f bestCenter;
+    for (int step = 0; step < 3; ++step) {
+        const float scale = 1.0f + static_cast<float>(step - 1) * kRefineScaleStep;
+        const cv::Size size(cvRound(m_refineTemplate.cols * scale), cvRound(m_refineTemplate.rows * scale));
+        if (size.width > m_scaledBuffer.cols || size.height > m_scaledBuffer.rows) {
+            return false;
+        }
+        const cv::Mat scaledTemplate = m_scaledBuffer(cv::Rect(cv::Point(), size));
+        cv::resize(m_refineTemplate, scaledTemplate, size, 0, 0, cv::INTER_LINEAR);
+
+        // Where the detection puts the template, plus the search margin
+        const cv::Point2f corner = detectedCenter - m_templateOffset * scale;
+        const cv::Rect search = cv::Rect(cvRound(corner.x) - margin, cvRound(corner.y) - margin,
+                                         size.width + 2 * margin, size.height + 2 * margin) & fullFrame;
+        if (search.width < size.width + 2 || search.height < size.height + 2) {
+            return false;  // Face at the frame edge
+        }
+
+        const cv::Mat refineScores = m_scoresBuffer(cv::Rect(0, 0, search.width - size.width + 1,
+                                                             search.height - size.height + 1));
+        {
+            HTK_OPENCV_ALLOCATES();
+            cv::matchTemplate(gray(search), scaledTemplate, refineScores, cv::TM_CCOEFF_NORMED);
+        }
+        cv::Point peak;
+        cv::minMaxLoc(refineScores, nullptr, &scores[step], nullptr, &peak);
+        if (bestStep >= 0 && scores[step] <= scores[bestStep]) {
+            continue;
+        }
+        bestStep = step;
+
+        // Sub-pixel peak, each axis separately
+        cv::Point2f subpixel(static_cast<float>(peak.x), static_cast<float>(peak.y));
+        if (peak.x > 0 && peak.x + 1 < refineScores.cols) {
+            subpixel.x += parabolicPeak(refineScores.at<float>(peak.y, peak.x - 1),
+                                        refineScores.at<float>(peak.y, peak.x),
+                                        refineScores.at<float>(peak.y, peak.x + 1));
+        }
+        if (peak.y > 0 && peak.y + 1 < refineScores.rows) {
+            subpixel.y += parabolicPeak(refineScores.at<float>(peak.y - 1, peak.x),
+                                        refineScores.at<float>(peak.y, peak.x),
+                                        refineScores.at<float>(peak.y + 1, peak.x));
+        }
+        bestCenter = cv::Point2f(static_cast<float>(search.x), static_cast<float>(search.y)) +
+                     subpixel + m_templateOffset * scale;
+    }
+    if (scores[bestStep] < kRefineMinScore) {
+        return false;
+    }
+
+    // Scale between the steps from the three peak scores
+    float scale = 1.0f + static_cast<float>(bestStep - 1) * kRefineScaleStep;
+    if (bestStep == 1) {
+        scale += kRefineScaleStep * parabolicPeak(static_cast<float>(scores[0]), static_cast<float>(scores[1]),
+                                                  static_cast<float>(scores[2]));
+    }
+
+    // The cascade still has the final say on where the face is: a match
+    // that wandered off it is tracking something else
+    const float width = m_templateFaceWidth * scale;
+    const cv::Point2f shift = bestCenter - detectedCenter;
+    if (std::hypot(shift.x, shift.y) > kRefineMaxShift * width) {
         return false;
     }
 
-    // Use the largest face in view
-    faceRect = faces[0];
-    for (const auto& face : faces) {
-        if (face.area() > faceRect.area()) {
-            faceRect = face;
+    const float height = width * detected.height / std::max(1, detected.width);
+    refined = cv::Rect2f(bestCenter.x - width / 2.0f, bestCenter.y - height / 2.0f, width, height);
+    return true;
+}
+
+void WebcamTracker::captureFaceTemplate(const cv::Rect2f& face) {
+    const cv::Mat& gray = m_pyramid.level(0);
+    const cv::Point2f center(face.x + face.width / 2.0f, face.y + face.height / 2.0f);
+    const int side = static_cast<int>(face.width * kTemplateFraction);
+    const cv::Rect inner = cv::Rect(cvRound(center.x - side / 2.0f), cvRound(center.y - side / 2.0f), side, side) &
+                           cv::Rect(0, 0, gray.cols, gray.rows);
+
+    m_hasTemplate = inner.width >= kMinTemplateSize && inner.height >= kMinTemplateSize;
+    if (!m_hasTemplate) {
+        return;
+    }
+
+    // The template and everything matched against it are views of buffers
+    // sized for the frame, so a face changing size never reallocates (the
+    // scaled template is one step larger, the scores at most a margin wider)
+    if (m_templateBuffer.size() != gray.size()) {
+        m_templateBuffer.create(gray.size(), CV_8UC1);
+        m_scaledBuffer.create(cv::Size(cvCeil(gray.cols * (1.0f + kRefineScaleStep)) + 1,
+                                       cvCeil(gray.rows * (1.0f + kRefineScaleStep)) + 1), CV_8UC1);
+        m_scoresBuffer.create(gray.size(), CV_32FC1);
+    }
+    m_refineTemplate = m_templateBuffer(cv::Rect(cv::Point(), inner.size()));
+    gray(inner).copyTo(m_refineTemplate);
+    m_templateOffset = center - cv::Point2f(static_cast<float>(inner.x), static_cast<float>(inner.y));
+    m_templateFaceWidth = face.width;
+}
+
+void WebcamTracker::estimateRoll(const cv::Rect2f& face) {
+    if (m_eyeCascades[0].empty()) {
+        return;
+    }
+    HTK_ZONE("roll");
+
+    // Built here, not in the workers: levels are only read concurrently
+    const cv::Mat& gray = m_pyramid.level(0);
+
+    // Upper part of the face box, split down the middle: one eye per half
+    const cv::Rect fullFrame(0, 0, gray.cols, gray.rows);
+    const int left   = cvRound(face.x);
+    const int middle = cvRound(face.x + face.width / 2.0f);
+    const int right  = cvRound(face.x + face.width);
+    const int top    = cvRound(face.y + face.height * kEyeBandTop);
+    const int bottom = cvRound(face.y + face.height * kEyeBandBottom);
+    const cv::Rect halves[2] = {
+        cv::Rect(left, top, middle - left, bottom - top) & fullFrame,
+        cv::Rect(middle, top, right - middle, bottom - top) & fullFrame
+    };
+    const int minEye = std::max(kMinEyeSize, static_cast<int>(face.width * kMinEyeFraction));
+    const int maxEye = std::max(minEye, static_cast<int>(face.width * kMaxEyeFraction));
+
+    // The halves change size with the face; equalizing into a view of a
+    // buffer as big as the frame keeps that from reallocating
+    for (auto& image : m_eyeImages) {
+        if (image.cols < gray.cols || image.rows < gray.rows) {
+            image.create(gray.size(), CV_8UC1);
+        }
+    }
+
+    bool found[2] = {false, false};
+    cv::Point2f centers[2];
+    auto searchHalf = [&](int i) {
+        const cv::Rect& half = halves[i];
+        if (half.width < minEye || half.height < minEye) {
+            return;
+        }
+
+        cv::Mat image = m_eyeImages[i](cv::Rect(cv::Point(), half.size()));
+        cv::equalizeHist(gray(half), image);
+        m_eyes[i].clear();
+        HTK_OPENCV_ALLOCATES();
+        m_eyeCascades[i].detectMultiScale(image, m_eyes[i], 1.15, 3, 0,
+                                          cv::Size(minEye, minEye), cv::Size(maxEye, maxEye));
+        if (m_eyes[i].empty()) {
+            return;
+        }
+
+        // Largest candidate: eyebrows and nostrils come out smaller
+        const cv::Rect* eye = &m_eyes[i][0];
+        for (const auto& candidate : m_eyes[i]) {
+            if (candidate.area() > eye->area()) {
+                eye = &candidate;
+            }
         }
+        centers[i] = cv::Point2f(half.x + eye->x + eye->width / 2.0f, half.y + eye->y + eye->height / 2.0f);
+        found[i] = true;
+    };
+    m_workers.run(2, searchHalf);
+    m_workerCpuUs += m_workers.lastBatchCpuUs();
+
+    // Keep the last roll unless both eyes are found and plausibly placed
+    if (!found[0] || !found[1]) {
+        return;
+    }
+    const cv::Point2f between = centers[1] - centers[0];
+    const float spacing = std::hypot(between.x, between.y);
+    if (spacing < kMinEyeSpacing * face.width || spacing > kMaxEyeSpacing * face.width) {
+        return;
     }
+    const float angle = std::atan2(between.y, between.x) * kRadToDeg;
+    if (std::abs(angle) > kMaxRollDeg) {
+        return;
+    }
+
+    // Mirrored like yaw and pitch: the user's own tilt. Kept as the eye
+    // vector so the pose is built from it without trig.
+    m_roll = Eigen::Vector2f(between.x, -between.y);
+}
+
+void WebcamTracker::updateMotion(const cv::Rect& faceRect, uint64_t nowUs, bool afterMiss) {
+    const bool haveVelocity = !afterMiss && m_detectedUs != 0 && nowUs > m_detectedUs &&
+                              nowUs - m_detectedUs < kMaxVelocityGapUs;
+
+    if (haveVelocity) {
+        const float dt = static_cast<float>(nowUs - m_detectedUs) / 1e6f;
+        const float rectNow[3] = {
+            faceRect.x + faceRect.width / 2.0f, faceRect.y + faceRect.height / 2.0f,
+            static_cast<float>(faceRect.width)
+        };
+        const float rectBefore[3] = {
+            m_detectedRect.x + m_detectedRect.width / 2.0f, m_detectedRect.y + m_detectedRect.height / 2.0f,
+            static_cast<float>(m_detectedRect.width)
+        };
+
+        // Light smoothing: one noisy detection shouldn't fling the prediction
+        for (int i = 0; i < 3; ++i) {
+            m_rectVelocity[i] += 0.5f * ((rectNow[i] - rectBefore[i]) / dt - m_rectVelocity[i]);
+        }
+        const Eigen::Vector3f angular = htk::core::rotationBetween(m_detectedPose.rotation, m_pose.rotation) / dt;
+        const Eigen::Vector3f linear  = (m_pose.translation - m_detectedPose.translation) / dt;
+        m_angularVelocity += 0.5f * (angular - m_angularVelocity);
+        m_linearVelocity  += 0.5f * (linear  - m_linearVelocity);
+    } else {
+        std::fill(std::begin(m_rectVelocity), std::end(m_rectVelocity), 0.0f);
+        m_angularVelocity.setZero();
+        m_linearVelocity.setZero();
+    }
+
+    m_detectedRect = faceRect;
+    m_detectedPose = m_pose;
+    m_detectedUs = nowUs;
+}
+
+void WebcamTracker::coast(uint64_t nowUs) {
+    // Decaying velocity integrates to velocity * tau * (1 - e^(-t / tau))
+    const float elapsed = static_cast<float>(nowUs - m_detectedUs) / 1e6f;
+    const float travel = kCoastTau * (1.0f - std::exp(-elapsed / kCoastTau));
+
+    const Eigen::Quaternionf step = htk::core::rotationStep(m_angularVelocity * travel);
+    m_pose.rotation    = htk::core::multiply(step, m_detectedPose.rotation);
+    m_pose.translation = m_detectedPose.translation + m_linearVelocity * travel;
+
+    // Confidence fades to zero over the coast window
+    const float missing = static_cast<float>(nowUs - m_missStartUs) / 1e6f;
+    m_pose.confidence = m_detectedPose.confidence * std::max(0.0f, 1.0f - missing / m_coastTime);
+    m_pose.isValid = true;
+}
 
+cv::Rect WebcamTracker::predictFaceRect(uint64_t nowUs) const {
+    const float elapsed = nowUs > m_detectedUs ? static_cast<float>(nowUs - m_detectedUs) / 1e6f : 0.0f;
+    const float travel = kCoastTau * (1.0f - std::exp(-elapsed / kCoastTau));
+
+    const float width  = std::max(24.0f, m_detectedRect.width + m_rectVelocity[2] * travel);
+    const float height = width * m_detectedRect.height / std::max(1, m_detectedRect.width);
+    const float cx = m_detectedRect.x + m_detectedRect.width  / 2.0f + m_rectVelocity[0] * travel;
+    const float cy = m_detectedRect.y + m_detectedRect.height / 2.0f + m_rectVelocity[1] * travel;
+
+    return cv::Rect(static_cast<int>(cx - width / 2.0f), static_cast<int>(cy - height / 2.0f),
+                    static_cast<int>(width), static_cast<int>(height));
+}
+
+bool WebcamTracker::isFaceRegionStatic() {
+    const float threshold = m_detectionSettings.motionThreshold;
+    if (threshold <= 0.0f || m_motionReference.empty() || m_staticFrames >= kMaxStaticFrames) {
+        return false;
+    }
+    HTK_ZONE("motion gate");
+
+    faceThumbnail(m_lastFaceRect, m_motionThumb);
+    if (m_motionThumb.empty()) {
+        return false;
+    }
+
+    const double change = cv::norm(m_motionThumb, m_motionReference, cv::NORM_L1) /
+                          static_cast<double>(m_motionThumb.total());
+    if (change >= threshold) {
+        return false;
+    }
+
+    ++m_staticFrames;
     return true;
 }
 
-void WebcamTracker::estimatePose(const cv::Rect& faceRect) {
-    // Get frame dimensions
-    int frameWidth = m_currentFrame.cols;
-    int frameHeight = m_currentFrame.rows;
+void WebcamTracker::faceThumbnail(const cv::Rect& rect, cv::Mat& thumb) {
+    const cv::Rect region = rect & cv::Rect(0, 0, m_currentFrame.cols, m_currentFrame.rows);
+    if (region.area() == 0) {
+        thumb.release();
+        return;
+    }
 
-    // Calculate center of face
-    float faceCenterX = faceRect.x + faceRect.width / 2.0f;
-    float faceCenterY = faceRect.y + faceRect.height / 2.0f;
+    // From the smallest level with the face still twice the thumbnail size;
+    // area averaging down to a few hundred pixels also averages out sensor noise
+    const int index = m_pyramid.levelFor(2.0 * kThumbSize / region.width);
+    const cv::Mat& level = m_pyramid.level(index);
+    const double levelScale = m_pyramid.scaleOf(index);
+    const cv::Rect levelRegion = cv::Rect(static_cast<int>(region.x * levelScale), static_cast<int>(region.y * levelScale),
+                                          std::max(1, cvRound(region.width * levelScale)),
+                                          std::max(1, cvRound(region.height * levelScale))) &
+                                 cv::Rect(0, 0, level.cols, level.rows);
+    if (levelRegion.area() == 0) {
+        thumb.release();
+        return;
+    }
 
-    // Calculate center of frame
-    float frameCenterX = frameWidth / 2.0f;
-    float frameCenterY = frameHeight / 2.0f;
+    cv::resize(level(levelRegion), thumb, cv::Size(kThumbSize, kThumbSize), 0, 0, cv::INTER_AREA);
+}
 
-    // Calculate deltas from center (normalized -1 to 1)
-    float deltaX = (faceCenterX - frameCenterX) / frameCenterX;
-    float deltaY = (faceCenterY - frameCenterY) / frameCenterY;
+void WebcamTracker::estimatePose(const cv::Rect2f& faceRect) {
+    HTK_ZONE("pose");
 
-    // Estimate yaw (left/right) from horizontal position
-    float newYaw = -deltaX * 45.0f;
+    // Intrinsics for the current resolution
+    if (m_currentFrame.size() != m_intrinsicsSize) {
+        m_intrinsicsSize = m_currentFrame.size();
+        m_intrinsics = m_calibration.isCalibrated()
+            ? m_calibration.scaledTo(m_intrinsicsSize)
+            : CameraCalibration::nominal(m_intrinsicsSize);
+    }
 
-    // Estimate pitch (up/down) from vertical position
-    float newPitch = -deltaY * 30.0f;
+    // Undistort just the face center and its left/right edges into
+    // normalized camera rays; the frame itself is never remapped
+    const float centerY = faceRect.y + faceRect.height / 2.0f;
+    const cv::Point2f pixels[3] = {
+        cv::Point2f(faceRect.x + faceRect.width / 2.0f, centerY),
+        cv::Point2f(faceRect.x, centerY),
+        cv::Point2f(faceRect.x + faceRect.width, centerY)
+    };
+    cv::Point2f rays[3];
+    m_intrinsics.undistortPoints(pixels, rays, 3);
 
-    // Estimate Z (depth) from face size
-    // Larger face = closer to camera = negative Z
-    float referenceFaceWidth = 150.0f;
-    float faceSize = static_cast<float>(faceRect.width);
-    float newZ = (referenceFaceWidth - faceSize) * 2.0f;
+    // Distance from the face's known width, then position along the ray
+    const float rayWidth = std::max(rays[2].x - rays[1].x, 1e-3f);
+    const float newZ = kFaceWidthMm / rayWidth;
+    const float newX = rays[0].x * newZ;
+    const float newY = rays[0].y * newZ;
 
-    // Estimate X and Y translation from face position
-    float newX = deltaX * 100.0f;
-    float newY = deltaY * 100.0f;
+    // Direction of the head as seen from the camera (yaw = -atan(x),
+    // pitch = -atan(y)) and roll from the eye pair, straight into a
+    // quaternion: no Euler angles until the output
+    const Eigen::Quaternionf rotation = htk::core::rotationFromDirections(
+        Eigen::Vector2f(1.0f, -rays[0].x), Eigen::Vector2f(1.0f, -rays[0].y), m_roll);
+    const Eigen::Vector3f translation(newX, newY, newZ);
 
-    // Apply smoothing
-    if (m_trackingData.isValid && m_smoothingFactor > 0.0f) {
-        m_trackingData.yaw = m_trackingData.yaw * m_smoothingFactor + newYaw * (1.0f - m_smoothingFactor);
-        m_trackingData.pitch = m_trackingData.pitch * m_smoothingFactor + newPitch * (1.0f - m_smoothingFactor);
-        m_trackingData.x = m_trackingData.x * m_smoothingFactor + newX * (1.0f - m_smoothingFactor);
-        m_trackingData.y = m_trackingData.y * m_smoothingFactor + newY * (1.0f - m_smoothingFactor);
-        m_trackingData.z = m_trackingData.z * m_smoothingFactor + newZ * (1.0f - m_smoothingFactor);
+    // Apply smoothing (along the rotation, so it stays correct at any
+    // angle), weighted per sample: the factor is the lag at confidence 0.5,
+    // a clean detection gets its square, a doubtful one moves the pose only
+    // a little
+    if (m_pose.isValid && m_smoothingFactor > 0.0f) {
+        const float blend = 1.0f - std::pow(m_smoothingFactor, 2.0f * m_faceConfidence);
+        m_pose.rotation = htk::core::blendRotation(m_pose.rotation, rotation, blend);
+        m_pose.translation += blend * (translation - m_pose.translation);
     } else {
-        m_trackingData.yaw = newYaw;
-        m_trackingData.pitch = newPitch;
-        m_trackingData.x = newX;
-        m_trackingData.y = newY;
-        m_trackingData.z = newZ;
+        m_pose.rotation = rotation;
+        m_pose.translation = translation;
+    }
+}
+
+uint64_t WebcamTracker::frameSignature(const cv::Mat& frame) {
+    // FNV-1a over a sparse 8x8 grid of pixels: cheap, and sensor noise makes
+    // two genuinely new frames collide practically never
+    uint64_t hash = 1469598103934665603ull;
+    const size_t pixelBytes = frame.elemSize();
+
+    for (int gy = 0; gy < 8; ++gy) {
+        const uchar* row = frame.ptr<uchar>((frame.rows - 1) * gy / 7);
+        for (int gx = 0; gx < 8; ++gx) {
+            const uchar* px = row + static_cast<size_t>((frame.cols - 1) * gx / 7) * pixelBytes;
+            for (size_t b = 0; b < pixelBytes; ++b) {
+                hash = (hash ^ px[b]) * 1099511628211ull;
+            }
+        }
     }
-    m_trackingData.roll = 0.0f;
+    return hash;
 }
 
-    htk::core::TrackingData WebcamTracker::getTrackingData() const {
-    return m_trackingData;
+htk::core::TrackingData WebcamTracker::getTrackingData() const {
+    return m_pose.toTrackingData();
+}
+
+bool WebcamTracker::getCurrentFrame(cv::Mat& frame) const {
+    if (m_currentFrame.empty()) {
+        return false;
+    }
+
+    m_currentFrame.copyTo(frame);
+    return true;
 }
 
-cv::Mat WebcamTracker::getCurrentFrame() const {
-    return m_currentFrame.clone();
+void WebcamTracker::setCalibration(const CameraCalibration& calibration) {
+    m_calibration = calibration;
+    m_intrinsicsSize = cv::Size();  // Rescale on the next pose
 }
 
 void WebcamTracker::setSmoothing(float factor) {
@@ -190,8 +1021,8 @@ void WebcamTracker::setSmoothing(float factor) {
 }
 
 void WebcamTracker::shutdown() {
-    if (m_camera.isOpened()) {
-        m_camera.release();
+    if (m_source) {
+        m_source->close();
     }
     m_isInitialized = false;
     m_isTracking = false;
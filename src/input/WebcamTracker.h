@@ -3,9 +3,18 @@
 
 #include <opencv2/opencv.hpp>
 #include <opencv2/objdetect.hpp>
+#include <algorithm>
+#include <memory>
 #include <string>
 
+#include "FrameSource.h"
+#include "ImagePyramid.h"
+#include "ExposureController.h"
+#include "DetectionSettings.h"
+#include "CameraCalibration.h"
 #include "../core/TrackingData.h"
+#include "../core/Pose.h"
+#include "../core/WorkerPool.h"
 
 namespace htk::input {
 
@@ -14,43 +23,221 @@ namespace htk::input {
         WebcamTracker();
         ~WebcamTracker();
 
-        // Initialize camera and face detection
-        bool initialize(int cameraIndex = 0);
+        // Initialize camera and face detection; the camera's capture thread
+        // takes its priority and CPUs from captureRealtime when enabled
+        bool initialize(int cameraIndex = 0, const htk::core::RealtimeSettings& captureRealtime = {});
+
+        // Initialize from any frame source (video replay, tests, ...)
+        bool initialize(std::unique_ptr<FrameSource> source);
 
         // Update tracking (call each frame)
         bool update();
 
-        // Get current tracking data
+        // Warm standby: drain one frame without decoding or detecting so the
+        // driver queue stays fresh and the next update() sees a current frame
+        bool idle();
+
+        // Current pose (camera frame, uncentered)
+        const htk::core::Pose& getPose() const { return m_pose; }
+
+        // Same, converted to Euler angles
         htk::core::TrackingData getTrackingData() const;
 
-        // Get current camera frame for preview
-        cv::Mat getCurrentFrame() const;
+        // Copy the current camera frame into the caller's buffer, reusing
+        // its allocation when the size matches
+        bool getCurrentFrame(cv::Mat& frame) const;
+
+        // The frame of the last update() itself, no copy (only valid on the
+        // thread calling update(), until the next call)
+        const cv::Mat& getFrame() const { return m_currentFrame; }
+
+        // Stage costs and detection rect of the last update()
+        const htk::core::FrameTiming& getFrameTiming() const { return m_frameTiming; }
+        const cv::Rect& getLastFaceRect() const { return m_lastFaceRect; }
+
+        // Camera cadence of the last update(): arrival time (steady clock
+        // microseconds), whether the driver handed back the previous image
+        // again, and the frame rate the camera agreed to
+        uint64_t getFrameArrival() const { return m_frameArrivalUs; }
+        bool isDuplicateFrame() const { return m_isDuplicateFrame; }
+        float getNominalFps() const { return m_nominalFps; }
+
+        // Whether the last update() skipped detection because the face
+        // region hadn't changed
+        bool wasDetectionGated() const { return m_wasGated; }
+
+        // Whether the last update() extrapolated the pose because the face
+        // was missed, and on the frame the face came back, how long it had
+        // been missing (microseconds, 0 otherwise)
+        bool isCoasting() const { return m_isCoasting; }
+        uint32_t getReacquireTime() const { return m_reacquireUs; }
+
+        // Whether the last update() had no frame because the camera stalled
+        // (the pose coasted instead), and on the update a camera reconnect
+        // completed, how long the outage lasted (microseconds, 0 otherwise)
+        bool isStalled() const { return m_isStalled; }
+        uint32_t getReconnectTime() const { return m_reconnectUs; }
+
+        // What the source's capture thread got, once it has started (false
+        // for sources read on the caller's thread)
+        bool getCaptureRealtime(htk::core::RealtimeStatus& status) const {
+            return m_source && m_source->getCaptureRealtime(status);
+        }
 
         // Cleanup
         void shutdown();
 
-        // Settings
+        // Settings (smoothing is the per-frame lag at detection confidence
+        // 0.5; confident samples follow faster, doubtful ones slower)
         void setSmoothing(float factor);
+
+        // Lens intrinsics/distortion for metric pose (default: nominal
+        // 60 degree lens without distortion)
+        void setCalibration(const CameraCalibration& calibration);
+        void setDetectionSettings(const DetectionSettings& settings) { m_detectionSettings = settings; }
+
+        // Exposure capping for live cameras whose auto exposure drops the
+        // frame rate in low light (on by default)
+        void setExposureSettings(const ExposureSettings& settings) { m_exposure.setSettings(settings); }
+        bool isExposureCapped() const { return m_exposure.isEngaged(); }
+
+        // How long a missed face keeps producing extrapolated poses, with
+        // velocity and confidence decaying (0 = invalid on the first miss)
+        void setCoastTime(float seconds) { m_coastTime = std::max(0.0f, seconds); }
+
+        // Threads next to the calling one for the detector ensemble and the
+        // eye searches (default: one per extra detector); 0 keeps all of a
+        // frame's work on the calling thread
+        void setWorkerThreads(int threads) { m_workers.setThreadCount(threads); }
+        const DetectionSettings& getDetectionSettings() const { return m_detectionSettings; }
         bool isTracking() const { return m_isTracking; }
+        bool isInitialized() const { return m_isInitialized; }
+        int cameraIndex() const { return m_cameraIndex; }
 
     private:
-        cv::VideoCapture m_camera;
+        std::unique_ptr<FrameSource> m_source;
         cv::CascadeClassifier m_faceCascade;
 
         cv::Mat m_currentFrame;
         cv::Rect m_lastFaceRect;
 
-        htk::core::TrackingData m_trackingData;
-        htk::core::TrackingData m_centerPosition;
+        // Detection scratch, kept across frames so a tracked frame doesn't
+        // touch the heap once sizes have settled
+        ImagePyramid m_pyramid;  // Grayscale levels of m_currentFrame
+        cv::Mat m_detectBuffer;  // Full-frame sized; detection uses a view
+
+        // Detector ensemble: frontal, left profile and right profile (the
+        // left-profile cascade on the mirrored image). Each runs on its own
+        // thread with its own classifier and results.
+        static constexpr int kDetectorCount = 3;
+        struct CascadeRun {
+            cv::Mat mirrored;  // Right profile only; full-frame sized, used through a view
+            std::vector<cv::Rect> faces;
+            std::vector<int> rejectLevels;
+            std::vector<double> levelWeights;
+        };
+        cv::CascadeClassifier m_profileCascades[2];
+        CascadeRun m_runs[kDetectorCount];
+        int m_roiMisses = 0;          // Ensemble misses around the face in a row
+        int m_fullFrameSearches = 0;  // Whole-frame searches since the last detection
+
+        // Runs the ensemble and the eye searches next to the tracking thread;
+        // their CPU time this frame, charged to detection
+        htk::core::WorkerPool m_workers{kDetectorCount - 1};
+        uint64_t m_workerCpuUs = 0;
+
+        // Sub-pixel refinement: the face's inner region from an earlier
+        // detection, where the face center sits in it and how wide the face
+        // was; kept until the match degrades, so still heads don't drift
+        cv::Mat m_refineTemplate;  // View of m_templateBuffer
+        cv::Mat m_templateBuffer;
+        cv::Mat m_scaledBuffer;
+        cv::Mat m_scoresBuffer;
+        cv::Point2f m_templateOffset;
+        float m_templateFaceWidth = 0.0f;
+        bool m_hasTemplate = false;
+        cv::Rect2f m_faceEstimate;  // Refined face box the pose is computed from
+
+        // Roll from the eye pair: one eye cascade per half of the face, so
+        // both halves can be searched at once (a classifier isn't safe to
+        // share between threads)
+        cv::CascadeClassifier m_eyeCascades[2];
+        cv::Mat m_eyeImages[2];  // Full-frame sized, used through a view
+        std::vector<cv::Rect> m_eyes[2];
+        Eigen::Vector2f m_roll = Eigen::Vector2f::UnitX();  // (cos, sin) * eye spacing, held while the eyes aren't found
+
+        // Confidence of the last detection (0..1, from the cascade's level
+        // weight); reused on frames that skip detection
+        float m_faceConfidence = 1.0f;
+
+        // Motion gate: thumbnail of the face region when it was last detected
+        cv::Mat m_motionThumb;
+        cv::Mat m_motionReference;
+        int m_staticFrames = 0;
+        bool m_wasGated = false;
+
+        // Coasting: the last real detection and the motion at that point,
+        // extrapolated while the face is missing
+        cv::Rect m_detectedRect;
+        htk::core::Pose m_detectedPose;
+        uint64_t m_detectedUs = 0;
+        float m_rectVelocity[3] = {0, 0, 0};  // Center x, y and width, px/s
+        Eigen::Vector3f m_angularVelocity = Eigen::Vector3f::Zero();  // Rotation vector, rad/s
+        Eigen::Vector3f m_linearVelocity  = Eigen::Vector3f::Zero();  // mm/s
+        float m_coastTime = 0.5f;
+        bool m_isCoasting = false;
+        uint64_t m_missStartUs = 0;
+        uint32_t m_reacquireUs = 0;
+        bool m_isStalled = false;
+        uint32_t m_reconnectUs = 0;
+
+        htk::core::Pose m_pose;
+
+        // Calibration as configured, and scaled to the current frame size
+        CameraCalibration m_calibration;
+        CameraCalibration m_intrinsics;
+        cv::Size m_intrinsicsSize;
+        htk::core::FrameTiming m_frameTiming;
+        uint64_t m_frameArrivalUs = 0;
+        uint64_t m_frameTimeUs = 0;  // Media time if the source has one, else arrival
+        uint64_t m_frameSignature = 0;
+        bool m_isDuplicateFrame = false;
+        float m_nominalFps = 0.0f;
+
+        // Exposure: arrival of the previous frame read (0 after idle/stall)
+        ExposureController m_exposure;
+        uint64_t m_lastArrivalUs = 0;
 
         bool m_isInitialized;
         bool m_isTracking;
+        int m_cameraIndex;
         float m_smoothingFactor;
 
+        DetectionSettings m_detectionSettings;
+        int m_framesSinceDetection = 0;
+
         // Internal methods
-        bool detectFace(const cv::Mat& frame, cv::Rect& faceRect);
-        void estimatePose(const cv::Rect& faceRect);
+        bool openSource(std::unique_ptr<FrameSource> source, bool keepState);
+        bool loadCascade();
+        void loadEyeCascade();
+        void loadProfileCascade();
+        bool detectFace(cv::Rect& faceRect);
+        bool detectInArea(const cv::Rect& area, double scale, int minFace, int maxFace, bool ensemble,
+                          cv::Rect& faceRect);
+        bool isFaceRegionStatic();
+        void faceThumbnail(const cv::Rect& rect, cv::Mat& thumb);
+        void updateMotion(const cv::Rect& faceRect, uint64_t nowUs, bool afterMiss);
+        void coast(uint64_t nowUs);
+        void missFace();  // No face (or no frame) this update: coast or go invalid
+        cv::Rect predictFaceRect(uint64_t nowUs) const;
+        cv::Rect2f refineFaceRect(const cv::Rect& detected);
+        bool matchFaceTemplate(const cv::Rect& detected, cv::Rect2f& refined);
+        void captureFaceTemplate(const cv::Rect2f& face);
+        void estimateRoll(const cv::Rect2f& face);
+        void controlExposure(uint64_t waitUs);
+        void estimatePose(const cv::Rect2f& faceRect);
         void smoothData(htk::core::TrackingData& data);
+        static uint64_t frameSignature(const cv::Mat& frame);
     };
 
 } // namespace htk::input
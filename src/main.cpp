@@ -4,10 +4,85 @@
 #include <QPushButton>
 #include <QVBoxLayout>
 #include <QWidget>
+#include <QDateTime>
 
 #include "core/HeadTracker.h"
 #include "ui/PreviewWidget.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// "<source>[@yaw[,pitch[,x,y,z]]]" -> source part plus mounting angles
+// (degrees) and position (mm)
+htk::core::CameraSetup parseCameraArg(const std::string& arg, bool isVideo) {
+    htk::core::CameraSetup setup;
+
+    const size_t at = arg.rfind('@');
+    const std::string source = arg.substr(0, at);
+    if (isVideo) {
+        setup.videoPath = source;
+    } else {
+        setup.cameraIndex = std::atoi(source.c_str());
+    }
+
+    if (at != std::string::npos) {
+        float* const fields[5] = {
+            &setup.mountYaw, &setup.mountPitch, &setup.mountX, &setup.mountY, &setup.mountZ
+        };
+        const char* value = arg.c_str() + at + 1;
+        for (float* field : fields) {
+            *field = static_cast<float>(std::atof(value));
+            const char* comma = std::strchr(value, ',');
+            if (!comma) {
+                break;
+            }
+            value = comma + 1;
+        }
+    }
+    return setup;
+}
+
+// "<priority>[@cpu,cpu...]" -> real-time mode; camera threads one step below
+htk::core::RealtimeSettings parseRealtimeArg(const std::string& arg) {
+    htk::core::RealtimeSettings settings;
+    settings.enabled = true;
+
+    const size_t at = arg.find('@');
+    settings.trackingPriority = std::atoi(arg.substr(0, at).c_str());
+    settings.capturePriority  = std::max(1, settings.trackingPriority - 1);
+
+    if (at != std::string::npos) {
+        const char* cpu = arg.c_str() + at + 1;
+        while (*cpu != '\0') {
+            settings.trackingCpus.push_back(std::atoi(cpu));
+            const char* comma = std::strchr(cpu, ',');
+            if (!comma) {
+                break;
+            }
+            cpu = comma + 1;
+        }
+        settings.captureCpus = settings.trackingCpus;
+    }
+    return settings;
+}
+
+// "<every>,<length>[,disconnect]" (seconds) -> fault injection on a camera
+void parseStallArg(const std::string& arg, htk::core::CameraSetup& setup) {
+    setup.stallEvery = static_cast<float>(std::atof(arg.c_str()));
+    const size_t comma = arg.find(',');
+    if (comma != std::string::npos) {
+        setup.stallLength = static_cast<float>(std::atof(arg.c_str() + comma + 1));
+    }
+    setup.stallDisconnect = arg.find("disconnect") != std::string::npos;
+}
+
+} // namespace
+
 int main(int argc, char* argv[]) {
     QApplication app(argc, argv);
 
@@ -43,21 +118,86 @@ int main(int argc, char* argv[]) {
     recenterButton->setEnabled(false);
     layout->addWidget(recenterButton);
 
+    // Record button
+    QPushButton* recordButton = new QPushButton("Start Recording", centralWidget);
+    recordButton->setEnabled(false);
+    layout->addWidget(recordButton);
+
     window.setCentralWidget(centralWidget);
 
     // Create head tracker
     htk::core::HeadTracker tracker;
     preview->setHeadTracker(&tracker);
 
+    // Command line (Qt has already taken its own arguments out of argv)
+    //   --camera <index>[@yaw[,pitch[,x,y,z]]]  add a live camera (repeatable)
+    //   --video <path>[@yaw[,pitch[,x,y,z]]]    add a replayed video instead (repeatable)
+    //   --synthetic <w>x<h>@<fps>       add a rendered synthetic face instead (repeatable)
+    //   --calibration <file>            lens calibration for the camera/video before it
+    //   --inject-stalls <s>,<s>[,disconnect]  hang/unplug the camera/video before it (testing)
+    //   --exposure-cap <percent>|off    exposure cap in low light for the camera before it
+    //   --metrics-file <path>           rewrite Prometheus text metrics every second
+    //   --metrics-port <port>           serve them on http://127.0.0.1:<port>/metrics
+    //   --export-frames <socket>        share camera frames through a memfd ring (Linux)
+    //   --cpu-budget <percent>          cap detection at this share of one core
+    //   --realtime <prio>[@cpu,cpu...]  SCHED_FIFO tracking/camera threads (Linux)
+    std::vector<htk::core::CameraSetup> cameras;
+    float cpuBudgetPercent = 0.0f;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--camera") == 0) {
+            cameras.push_back(parseCameraArg(argv[++i], false));
+        } else if (std::strcmp(argv[i], "--video") == 0) {
+            cameras.push_back(parseCameraArg(argv[++i], true));
+        } else if (std::strcmp(argv[i], "--synthetic") == 0) {
+            htk::core::CameraSetup setup;
+            setup.syntheticMode = argv[++i];
+            cameras.push_back(setup);
+        } else if (std::strcmp(argv[i], "--calibration") == 0) {
+            if (cameras.empty()) {
+                cameras.push_back(htk::core::CameraSetup{});
+            }
+            cameras.back().calibrationPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--inject-stalls") == 0) {
+            if (cameras.empty()) {
+                cameras.push_back(htk::core::CameraSetup{});
+            }
+            parseStallArg(argv[++i], cameras.back());
+        } else if (std::strcmp(argv[i], "--exposure-cap") == 0) {
+            if (cameras.empty()) {
+                cameras.push_back(htk::core::CameraSetup{});
+            }
+            const char* cap = argv[++i];
+            cameras.back().exposureCap = std::strcmp(cap, "off") == 0
+                ? 0.0f
+                : static_cast<float>(std::atof(cap)) / 100.0f;
+        } else if (std::strcmp(argv[i], "--metrics-file") == 0) {
+            tracker.exportMetricsToFile(argv[++i]);
+        } else if (std::strcmp(argv[i], "--metrics-port") == 0) {
+            tracker.serveMetrics(static_cast<uint16_t>(std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--export-frames") == 0) {
+            tracker.startFrameExport(argv[++i]);
+        } else if (std::strcmp(argv[i], "--cpu-budget") == 0) {
+            cpuBudgetPercent = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--realtime") == 0) {
+            tracker.setRealtime(parseRealtimeArg(argv[++i]));
+        }
+    }
+    if (cameras.empty()) {
+        cameras.push_back(htk::core::CameraSetup{});
+    }
+
     // Connect buttons
     QObject::connect(startButton, &QPushButton::clicked, [&]() {
-        if (tracker.initialize(0)) {
+        if (tracker.initialize(cameras)) {
+            // Needs the camera's frame rate, so only after initialize
+            tracker.setCpuBudgetPercent(cpuBudgetPercent);
             if (tracker.start()) {
                 preview->startPreview();
                 statusLabel->setText("Status: Tracking active");
                 startButton->setEnabled(false);
                 stopButton->setEnabled(true);
                 recenterButton->setEnabled(true);
+                recordButton->setEnabled(true);
             } else {
                 statusLabel->setText("Status: Failed to start");
             }
@@ -67,14 +207,31 @@ int main(int argc, char* argv[]) {
     });
 
     QObject::connect(stopButton, &QPushButton::clicked, [&]() {
+        // Drops to warm standby; Start resumes without reopening the camera
         tracker.stop();
         preview->stopPreview();
-        statusLabel->setText("Status: Stopped");
+        statusLabel->setText("Status: Standby");
         startButton->setEnabled(true);
         stopButton->setEnabled(false);
         recenterButton->setEnabled(false);
     });
 
+    QObject::connect(recordButton, &QPushButton::clicked, [&]() {
+        if (tracker.isRecording()) {
+            tracker.stopRecording();
+            recordButton->setText("Start Recording");
+            return;
+        }
+
+        const QString path = QString("htk-session-%1.htks")
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"));
+        if (tracker.startRecording(path.toStdString())) {
+            recordButton->setText("Stop Recording");
+        } else {
+            statusLabel->setText("Status: Failed to start recording");
+        }
+    });
+
     QObject::connect(recenterButton, &QPushButton::clicked, [&]() {
         tracker.recenter();
         statusLabel->setText("Status: Recentered");
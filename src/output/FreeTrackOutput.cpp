@@ -1,8 +1,8 @@
 #include "FreeTrackOutput.h"
 
 #include <iostream>
-#include <cmath>
 
+#include "../core/Instrumentation.h"
 #include "../core/TrackingData.h"
 
 namespace htk::output {
@@ -29,7 +29,7 @@ bool FreeTrackOutput::initialize() {
         NULL,
         PAGE_READWRITE,
         0,
-        sizeof(FreeTrackData),
+        sizeof(freetrack::Packet),
         "FT_SharedMem"
     );
 
@@ -44,7 +44,7 @@ bool FreeTrackOutput::initialize() {
         FILE_MAP_ALL_ACCESS,
         0,
         0,
-        sizeof(FreeTrackData)
+        sizeof(freetrack::Packet)
     );
 
     if (m_pMemory == nullptr) {
@@ -56,7 +56,7 @@ bool FreeTrackOutput::initialize() {
     }
 
     // Initialize memory to zero
-    ZeroMemory(m_pMemory, sizeof(FreeTrackData));
+    ZeroMemory(m_pMemory, sizeof(freetrack::Packet));
 
     m_isInitialized = true;
     std::cout << "FreeTrack output initialized successfully" << std::endl;
@@ -77,39 +77,13 @@ bool FreeTrackOutput::sendData(const htk::core::TrackingData& data) {
         return false;
     }
 
-    auto* ftData = static_cast<FreeTrackData*>(m_pMemory);
-
-    // Convert degrees to radians
-    constexpr float degToRad = 3.14159265359f / 180.0f;
-
-    // Fill in the data
-    ftData->dataID = ++m_dataID;
-    ftData->camWidth = 640;
-    ftData->camHeight = 480;
-
-    // Orientation
-    ftData->yaw   = data.yaw   * degToRad;
-    ftData->pitch = data.pitch * degToRad;
-    ftData->roll  = data.roll  * degToRad;
-
-    // Translation
-    ftData->x = data.x;
-    ftData->y = data.y;
-    ftData->z = data.z;
-
-    // Raw values
-    ftData->rawyaw   = ftData->yaw;
-    ftData->rawpitch = ftData->pitch;
-    ftData->rawroll  = ftData->roll;
-    ftData->rawx     = ftData->x;
-    ftData->rawy     = ftData->y;
-    ftData->rawz     = ftData->z;
-
-    // Point data
-    ftData->x1 = ftData->y1 = 0.0f;
-    ftData->x2 = ftData->y2 = 0.0f;
-    ftData->x3 = ftData->y3 = 0.0f;
-    ftData->x4 = ftData->y4 = 0.0f;
+    HTK_ZONE("freetrack send");
+
+    // Encode locally, then one bracketed copy into the shared view
+    m_dataID = static_cast<uint32_t>(m_dataID + 2);
+    freetrack::Packet packet;
+    freetrack::encode(data, m_dataID, packet);
+    freetrack::publish(m_pMemory, packet);
 
     return true;
 #else
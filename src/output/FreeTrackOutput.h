@@ -2,6 +2,7 @@
 #define FREETRACKOUTPUT_H
 
 #include "../core/TrackingData.h"
+#include "ProtocolFormat.h"
 #include <string>
 
 #ifdef _WIN32
@@ -33,32 +34,7 @@ namespace htk::output {
         HANDLE m_hMapFile = nullptr;
         void* m_pMemory = nullptr;
 
-        // FreeTrack shared memory structure
-        struct FreeTrackData {
-            uint32_t dataID;
-            int32_t camWidth;
-            int32_t camHeight;
-
-            // 6DOF data
-            float yaw;      // Radians
-            float pitch;    // Radians
-            float roll;     // Radians
-            float x;        // Millimeters
-            float y;        // Millimeters
-            float z;        // Millimeters
-
-            // Raw data (unfiltered)
-            float rawyaw;
-            float rawpitch;
-            float rawroll;
-            float rawx;
-            float rawy;
-            float rawz;
-
-            // Additional data
-            float x1, y1, x2, y2, x3, y3, x4, y4;
-        };
-
+        // Last published sequence (steps by 2, odd while a copy is in flight)
         uint32_t m_dataID = 0;
 #endif
     };
@@ -0,0 +1,189 @@
+#ifndef PROTOCOLFORMAT_H
+#define PROTOCOLFORMAT_H
+
+#include "../core/TrackingData.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Shared-memory layouts of the game protocols, and their encoders. Plain
+// portable code: only mapping the memory is Windows-specific, so packets
+// can be built and checked on any platform.
+//
+// Each pose is encoded once into a local packet, then published with
+// publishPacket(): the sequence field goes odd, the rest is copied in one
+// go, and the sequence becomes the packet's (even) value. A reader that
+// reads the sequence before and after its copy, and keeps the copy only
+// when both match and are even, never sees a torn packet.
+//
+// Readers that only watch dataID / frame for a change are NOT protected:
+// the odd value is itself a change, so such a reader can copy the packet
+// while it is half written. The complete value follows within the same
+// copy (well under a microsecond), so it picks up the whole packet on its
+// next poll, but that one read can mix two poses. The games read these
+// protocols this way and there is no layout-compatible way to stop it;
+// the window is what the single local encode and copy keep small.
+
+namespace htk::output {
+
+    constexpr float kDegToRad = 3.14159265358979f / 180.0f;
+
+    // Copies a packet of size bytes into shared memory, bracketed by its
+    // Sequence field at sequenceOffset (see above)
+    template <typename Sequence>
+    inline void publishPacket(void* shared, const void* packet, size_t size, size_t sequenceOffset) {
+        static_assert(std::is_unsigned_v<Sequence>, "sequence must be an unsigned counter");
+
+        auto* dst = static_cast<uint8_t*>(shared);
+        const auto* src = static_cast<const uint8_t*>(packet);
+        volatile Sequence* sequence = reinterpret_cast<volatile Sequence*>(dst + sequenceOffset);
+
+        Sequence complete;
+        std::memcpy(&complete, src + sequenceOffset, sizeof(Sequence));
+
+        *sequence = static_cast<Sequence>(complete - 1);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const size_t tail = sequenceOffset + sizeof(Sequence);
+        std::memcpy(dst, src, sequenceOffset);
+        std::memcpy(dst + tail, src + tail, size - tail);
+
+        std::atomic_thread_fence(std::memory_order_release);
+        *sequence = complete;
+    }
+
+    namespace freetrack {
+
+        // "FT_SharedMem"
+        struct Packet {
+            uint32_t dataID;     // Sequence, even once complete
+            int32_t camWidth;
+            int32_t camHeight;
+
+            // 6DOF data
+            float yaw;      // Radians
+            float pitch;    // Radians
+            float roll;     // Radians
+            float x;        // Millimeters
+            float y;        // Millimeters
+            float z;        // Millimeters
+
+            // Raw data (unfiltered)
+            float rawyaw;
+            float rawpitch;
+            float rawroll;
+            float rawx;
+            float rawy;
+            float rawz;
+
+            // Point data
+            float x1, y1, x2, y2, x3, y3, x4, y4;
+        };
+
+        static_assert(std::is_trivially_copyable_v<Packet>, "FreeTrack packet is copied as bytes");
+        static_assert(sizeof(float) == 4, "FreeTrack uses 32-bit floats");
+        static_assert(sizeof(Packet) == 92, "FreeTrack shared memory layout changed");
+        static_assert(offsetof(Packet, dataID) == 0, "FreeTrack layout");
+        static_assert(offsetof(Packet, yaw) == 12, "FreeTrack layout");
+        static_assert(offsetof(Packet, rawyaw) == 36, "FreeTrack layout");
+        static_assert(offsetof(Packet, x1) == 60, "FreeTrack layout");
+        static_assert(offsetof(Packet, y4) == 88, "FreeTrack layout");
+
+        inline void encode(const htk::core::TrackingData& data, uint32_t sequence, Packet& packet) {
+            packet = Packet{};
+            packet.dataID = sequence;
+            packet.camWidth = 640;
+            packet.camHeight = 480;
+
+            packet.yaw   = data.yaw   * kDegToRad;
+            packet.pitch = data.pitch * kDegToRad;
+            packet.roll  = data.roll  * kDegToRad;
+            packet.x = data.x;
+            packet.y = data.y;
+            packet.z = data.z;
+
+            packet.rawyaw   = packet.yaw;
+            packet.rawpitch = packet.pitch;
+            packet.rawroll  = packet.roll;
+            packet.rawx     = packet.x;
+            packet.rawy     = packet.y;
+            packet.rawz     = packet.z;
+        }
+
+        inline void publish(void* shared, const Packet& packet) {
+            publishPacket<uint32_t>(shared, &packet, sizeof(Packet), offsetof(Packet, dataID));
+        }
+
+    } // namespace freetrack
+
+    namespace trackir {
+
+        // "TrackIR5"
+        struct Packet {
+            uint16_t status;    // 0 = stopped, 1 = running
+            uint16_t frame;     // Sequence, even once complete
+            uint32_t cksum;     // Checksum (not used)
+
+            // 6DOF data
+            float yaw;      // Radians
+            float pitch;    // Radians
+            float roll;     // Radians
+            float x;        // Millimeters
+            float y;        // Millimeters
+            float z;        // Millimeters
+
+            // Raw data (unfiltered)
+            float rawyaw;
+            float rawpitch;
+            float rawroll;
+            float rawx;
+            float rawy;
+            float rawz;
+
+            // Point data
+            float x1, y1;
+            float x2, y2;
+            float x3, y3;
+        };
+
+        static_assert(std::is_trivially_copyable_v<Packet>, "TrackIR packet is copied as bytes");
+        static_assert(sizeof(Packet) == 80, "TrackIR shared memory layout changed");
+        static_assert(offsetof(Packet, frame) == 2, "TrackIR layout");
+        static_assert(offsetof(Packet, cksum) == 4, "TrackIR layout");
+        static_assert(offsetof(Packet, yaw) == 8, "TrackIR layout");
+        static_assert(offsetof(Packet, rawyaw) == 32, "TrackIR layout");
+        static_assert(offsetof(Packet, x1) == 56, "TrackIR layout");
+        static_assert(offsetof(Packet, y3) == 76, "TrackIR layout");
+
+        inline void encode(const htk::core::TrackingData& data, uint16_t sequence, Packet& packet) {
+            packet = Packet{};
+            packet.status = data.isValid ? 1 : 0;
+            packet.frame = sequence;
+
+            packet.yaw   = data.yaw   * kDegToRad;
+            packet.pitch = data.pitch * kDegToRad;
+            packet.roll  = data.roll  * kDegToRad;
+            packet.x = data.x;
+            packet.y = data.y;
+            packet.z = data.z;
+
+            packet.rawyaw   = packet.yaw;
+            packet.rawpitch = packet.pitch;
+            packet.rawroll  = packet.roll;
+            packet.rawx     = packet.x;
+            packet.rawy     = packet.y;
+            packet.rawz     = packet.z;
+        }
+
+        inline void publish(void* shared, const Packet& packet) {
+            publishPacket<uint16_t>(shared, &packet, sizeof(Packet), offsetof(Packet, frame));
+        }
+
+    } // namespace trackir
+
+} // namespace htk::output
+
+#endif // PROTOCOLFORMAT_H
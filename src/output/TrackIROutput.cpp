@@ -1,8 +1,8 @@
 #include "TrackIROutput.h"
 
 #include <iostream>
-#include <cmath>
 
+#include "../core/Instrumentation.h"
 #include "../core/TrackingData.h"
 
 namespace htk::output {
@@ -29,7 +29,7 @@ bool TrackIROutput::initialize() {
         NULL,
         PAGE_READWRITE,
         0,
-        sizeof(TrackIRData),
+        sizeof(trackir::Packet),
         "TrackIR5"  // TrackIR 5 shared memory name
     );
 
@@ -44,7 +44,7 @@ bool TrackIROutput::initialize() {
         FILE_MAP_ALL_ACCESS,
         0,
         0,
-        sizeof(TrackIRData)
+        sizeof(trackir::Packet)
     );
 
     if (m_pMemory == nullptr) {
@@ -56,7 +56,7 @@ bool TrackIROutput::initialize() {
     }
 
     // Initialize memory to zero
-    ZeroMemory(m_pMemory, sizeof(TrackIRData));
+    ZeroMemory(m_pMemory, sizeof(trackir::Packet));
 
     m_isInitialized = true;
     std::cout << "TrackIR output initialized successfully" << std::endl;
@@ -77,36 +77,13 @@ bool TrackIROutput::sendData(const htk::core::TrackingData& data) {
         return false;
     }
 
-    auto* tirData = static_cast<TrackIRData*>(m_pMemory);
-
-    // Convert degrees to radians
-    constexpr float degToRad = 3.14159265359f / 180.0f;
-
-    // Fill in the data
-    tirData->status = data.isValid ? 1 : 0;
-    tirData->frame  = ++m_frameCounter;
-    tirData->cksum  = 0;  // Not used
-
-    // Convert tracking data (degrees to radians)
-    tirData->yaw   = data.yaw   * degToRad;
-    tirData->pitch = data.pitch * degToRad;
-    tirData->roll  = data.roll  * degToRad;
-    tirData->x     = data.x;
-    tirData->y     = data.y;
-    tirData->z     = data.z;
-
-    // Copy to raw data
-    tirData->rawyaw   = tirData->yaw;
-    tirData->rawpitch = tirData->pitch;
-    tirData->rawroll  = tirData->roll;
-    tirData->rawx     = tirData->x;
-    tirData->rawy     = tirData->y;
-    tirData->rawz     = tirData->z;
-
-    // Point data
-    tirData->x1 = tirData->y1 = 0.0f;
-    tirData->x2 = tirData->y2 = 0.0f;
-    tirData->x3 = tirData->y3 = 0.0f;
+    HTK_ZONE("trackir send");
+
+    // Encode locally, then one bracketed copy into the shared view
+    m_frameCounter = static_cast<uint16_t>(m_frameCounter + 2);
+    trackir::Packet packet;
+    trackir::encode(data, m_frameCounter, packet);
+    trackir::publish(m_pMemory, packet);
 
     return true;
 #else
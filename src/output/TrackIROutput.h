@@ -2,6 +2,7 @@
 #define TRACKIROUTPUT_H
 
 #include "../core/TrackingData.h"
+#include "ProtocolFormat.h"
 #include <string>
 
 #ifdef _WIN32
@@ -33,34 +34,7 @@ namespace htk::output {
         HANDLE m_hMapFile = nullptr;
         void* m_pMemory = nullptr;
 
-        // TrackIR shared memory structure
-        struct TrackIRData {
-            uint16_t status;    // 0 = stopped, 1 = running
-            uint16_t frame;     // Frame counter
-            uint32_t cksum;     // Checksum (not used)
-
-            // 6DOF data
-            float yaw;      // Radians
-            float pitch;    // Radians
-            float roll;     // Radians
-            float x;        // Millimeters
-            float y;        // Millimeters
-            float z;        // Millimeters
-
-            // Raw data (unfiltered)
-            float rawyaw;
-            float rawpitch;
-            float rawroll;
-            float rawx;
-            float rawy;
-            float rawz;
-
-            // Point data
-            float x1, y1;
-            float x2, y2;
-            float x3, y3;
-        };
-
+        // Last published sequence (steps by 2, odd while a copy is in flight)
         uint16_t m_frameCounter = 0;
 #endif
     };
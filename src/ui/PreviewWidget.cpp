@@ -4,6 +4,7 @@
 #include <QImage>
 
 #include "core/HeadTracker.h"
+#include "core/Instrumentation.h"
 #include "core/TrackingData.h"
 
 #include <cmath>
@@ -49,12 +50,17 @@ void PreviewWidget::updateFrame() {
         return;
     }
 
+    if (m_tracker->getPreviewFrame(m_frameBuffer)) {
+        cvMatToQImage(m_frameBuffer, m_currentImage);
+    }
+
     // Trigger repaint
     update();
 }
 
 void PreviewWidget::paintEvent(QPaintEvent* event) {
     Q_UNUSED(event);
+    HTK_ZONE("preview paint");
 
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing);
@@ -85,6 +91,10 @@ void PreviewWidget::drawTrackingInfo(QPainter& painter) {
     painter.setPen(data.isValid ? Qt::green : Qt::red);
     painter.setFont(QFont("Arial", 12, QFont::Bold));
     painter.drawText(10, 25, data.isValid ? "TRACKING" : "NO FACE DETECTED");
+    if (m_tracker->isDegraded()) {
+        painter.setPen(Qt::yellow);
+        painter.drawText(10, 45, "CAMERA STALLED - RECONNECTING");
+    }
 
     if (!data.isValid) {
         return;
@@ -149,32 +159,28 @@ void PreviewWidget::drawHeadIndicator(QPainter& painter) {
     painter.drawText(centerX - 30, height() - 20, "Head Pose");
 }
 
-QImage PreviewWidget::cvMatToQImage(const cv::Mat& mat) {
-    if (mat.empty()) {
-        return QImage();
+void PreviewWidget::cvMatToQImage(const cv::Mat& mat, QImage& image) {
+    QImage::Format format;
+    int dstType;
+    switch (mat.type()) {
+        case CV_8UC4: format = QImage::Format_ARGB32;      dstType = CV_8UC4; break;
+        case CV_8UC3: format = QImage::Format_RGB888;      dstType = CV_8UC3; break;
+        case CV_8UC1: format = QImage::Format_Grayscale8;  dstType = CV_8UC1; break;
+        default:
+            image = QImage();
+            return;
     }
 
-    switch (mat.type()) {
-        case CV_8UC4:
-            return QImage(mat.data, mat.cols, mat.rows,
-                          static_cast<int>(mat.step),
-                          QImage::Format_ARGB32).copy();
-
-        case CV_8UC3: {
-            cv::Mat rgb;
-            cv::cvtColor(mat, rgb, cv::COLOR_BGR2RGB);
-            return QImage(rgb.data, rgb.cols, rgb.rows,
-                          static_cast<int>(rgb.step),
-                          QImage::Format_RGB888).copy();
-        }
-
-        case CV_8UC1:
-            return QImage(mat.data, mat.cols, mat.rows,
-                          static_cast<int>(mat.step),
-                          QImage::Format_Grayscale8).copy();
+    if (image.width() != mat.cols || image.height() != mat.rows || image.format() != format) {
+        image = QImage(mat.cols, mat.rows, format);
+    }
 
-        default:
-            return QImage();
+    // Write straight into the image's pixels
+    cv::Mat dst(mat.rows, mat.cols, dstType, image.bits(), static_cast<size_t>(image.bytesPerLine()));
+    if (mat.type() == CV_8UC3) {
+        cv::cvtColor(mat, dst, cv::COLOR_BGR2RGB);
+    } else {
+        mat.copyTo(dst);
     }
 }
 
@@ -48,8 +48,12 @@ namespace htk::ui {
         // Current camera frame converted to QImage
         QImage m_currentImage;
 
-        // Convert OpenCV Mat to QImage
-        QImage cvMatToQImage(const cv::Mat& mat);
+        // Frame fetched from the tracker, reused every refresh
+        cv::Mat m_frameBuffer;
+
+        // Convert OpenCV Mat into image, reallocating only when the size or
+        // format changes
+        static void cvMatToQImage(const cv::Mat& mat, QImage& image);
 
         // Draw text and tracking info
         void drawTrackingInfo(QPainter& painter);
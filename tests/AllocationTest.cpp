@@ -0,0 +1,148 @@
+// Replays frames through WebcamTracker under a counting global allocator
+// and fails if a tracked frame allocates once buffers have settled.
+//
+// Frames are rendered by SyntheticSource up front (drawing allocates) and
+// replayed from memory. OpenCV calls that allocate internally whatever
+// they are given are marked with HTK_OPENCV_ALLOCATES() and left out;
+// OpenCV's thread pool is switched off so those calls stay on the thread
+// that marked them. cv::Mat buffers are counted: each one is a UMatData
+// taken with operator new.
+
+#include "Check.h"
+#include "ReplaySource.h"
+#include "core/Instrumentation.h"
+#include "input/SyntheticSource.h"
+#include "input/WebcamTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+
+namespace {
+
+std::atomic<bool> g_counting{false};
+std::atomic<long> g_allocations{0};
+
+void* countedAlloc(std::size_t size, std::size_t alignment = 0) {
+    if (g_counting.load(std::memory_order_relaxed) &&
+        htk::core::instrumentation::opencvAllocationDepth == 0) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (size == 0) {
+        size = 1;
+    }
+    void* p = nullptr;
+    if (alignment > alignof(std::max_align_t)) {
+        if (posix_memalign(&p, alignment, size) != 0) {
+            p = nullptr;
+        }
+    } else {
+        p = std::malloc(size);
+    }
+    return p;
+}
+
+constexpr int kFrames = 90;
+constexpr int kWarmupPasses = 2;
+
+using htk::input::DetectionSettings;
+
+// Tracks the sequence kWarmupPasses times, then once more counting;
+// every counted frame must come out at zero
+void checkSteadyState(const char* name, const std::vector<cv::Mat>& frames, const DetectionSettings& settings) {
+    htk::input::WebcamTracker tracker;
+    tracker.setDetectionSettings(settings);
+    CHECK(tracker.initialize(std::make_unique<htk::test::ReplaySource>(frames, 30.0f)));
+
+    for (int i = 0; i < kWarmupPasses * kFrames; ++i) {
+        tracker.update();
+    }
+
+    int tracked = 0;
+    int allocatingFrames = 0;
+    for (int i = 0; i < kFrames; ++i) {
+        g_allocations = 0;
+        g_counting = true;
+        const bool updated = tracker.update();
+        g_counting = false;
+
+        CHECK(updated);
+        tracked += tracker.isTracking() ? 1 : 0;
+        if (g_allocations != 0) {
+            if (++allocatingFrames <= 5) {
+                std::cerr << name << ": frame " << i << " allocated " << g_allocations.load()
+                          << " time(s)" << std::endl;
+            }
+        }
+    }
+
+    std::cout << name << ": " << tracked << "/" << kFrames << " frames tracked, "
+              << allocatingFrames << " allocating" << std::endl;
+    CHECK(allocatingFrames == 0);
+
+    // A face that is never found would pass trivially
+    CHECK(tracked > kFrames / 2);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (void* p = countedAlloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* p = countedAlloc(size, static_cast<std::size_t>(alignment))) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+int main() {
+    cv::setNumThreads(0);
+
+    htk::input::SyntheticSettings synthetic;
+    synthetic.paced = false;
+    synthetic.frames = kFrames;
+    htk::input::SyntheticSource source(synthetic);
+    CHECK(source.open());
+
+    std::vector<cv::Mat> frames;
+    cv::Mat frame;
+    while (source.read(frame)) {
+        frames.push_back(frame.clone());
+    }
+    CHECK(static_cast<int>(frames.size()) == kFrames);
+
+    // Every stage on every frame: detection (ensemble included), refinement, eyes
+    DetectionSettings everyFrame;
+    everyFrame.motionThreshold = 0.0f;
+    checkSteadyState("detect every frame", frames, everyFrame);
+
+    // The shipped defaults, motion gate on
+    checkSteadyState("defaults", frames, DetectionSettings());
+
+    // Around the face only, at reduced resolution (CPU governor's middle rungs)
+    DetectionSettings governed;
+    governed.scale = 0.5f;
+    governed.searchMargin = 0.5f;
+    governed.interval = 2;
+    checkSteadyState("governed", frames, governed);
+
+    return htk::test::result();
+}
@@ -0,0 +1,139 @@
+// Checks CameraCalibration: the nominal pinhole, rescaling to another
+// resolution, file round trip, and that undistortPoints inverts OpenCV's
+// own projection through a distorted lens.
+
+#include "Check.h"
+#include "input/CameraCalibration.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+using htk::input::CameraCalibration;
+
+constexpr double kTolerance = 1e-4;  // Normalized coordinates
+
+const char* const kPath = "calibration_test.yml";
+
+// Normalized points across a wide field of view, corners included
+std::vector<cv::Point3f> makeRays() {
+    std::vector<cv::Point3f> rays;
+    for (float y = -0.35f; y <= 0.36f; y += 0.175f) {
+        for (float x = -0.5f; x <= 0.51f; x += 0.25f) {
+            rays.emplace_back(x, y, 1.0f);
+        }
+    }
+    return rays;
+}
+
+void checkNominal() {
+    const CameraCalibration calibration = CameraCalibration::nominal(cv::Size(640, 480), 60.0f);
+    CHECK(!calibration.isCalibrated());
+
+    const cv::Point2f pixels[3] = {{320.0f, 240.0f}, {640.0f, 240.0f}, {320.0f, 0.0f}};
+    cv::Point2f normalized[3];
+    calibration.undistortPoints(pixels, normalized, 3);
+
+    // Image center straight ahead, the side edge at half the field of view
+    CHECK_NEAR(normalized[0].x, 0.0, kTolerance);
+    CHECK_NEAR(normalized[0].y, 0.0, kTolerance);
+    CHECK_NEAR(normalized[1].x, std::tan(30.0 * 3.14159265358979 / 180.0), kTolerance);
+    CHECK_NEAR(normalized[1].y, 0.0, kTolerance);
+    CHECK_NEAR(normalized[2].y, -240.0 / calibration.cameraMatrix()(1, 1), kTolerance);
+
+    // The same lens at twice the resolution sees the same rays
+    const CameraCalibration scaled = calibration.scaledTo(cv::Size(1280, 960));
+    CHECK(scaled.imageSize() == cv::Size(1280, 960));
+    CHECK_NEAR(scaled.cameraMatrix()(0, 0), 2.0 * calibration.cameraMatrix()(0, 0), 1e-9);
+    const cv::Point2f scaledPixel(1280.0f, 480.0f);
+    cv::Point2f scaledNormalized;
+    scaled.undistortPoints(&scaledPixel, &scaledNormalized, 1);
+    CHECK_NEAR(scaledNormalized.x, normalized[1].x, kTolerance);
+}
+
+void checkDistortion() {
+    // A calibration as htk-calibrate or any OpenCV tool writes it
+    const cv::Matx33d cameraMatrix(600.0, 0.0, 330.0,
+                                   0.0, 602.0, 236.0,
+                                   0.0, 0.0, 1.0);
+    const cv::Mat distortion = (cv::Mat_<double>(1, 5) << -0.28, 0.09, 0.001, -0.0005, 0.0);
+    {
+        cv::FileStorage fs(kPath, cv::FileStorage::WRITE);
+        fs << "image_width" << 640;
+        fs << "image_height" << 480;
+        fs << "camera_matrix" << cv::Mat(cameraMatrix);
+        fs << "distortion_coefficients" << distortion;
+        fs << "avg_reprojection_error" << 0.25;
+    }
+
+    CameraCalibration calibration;
+    CHECK(calibration.load(kPath));
+    CHECK(calibration.isCalibrated());
+    CHECK(calibration.imageSize() == cv::Size(640, 480));
+    CHECK_NEAR(calibration.cameraMatrix()(1, 2), 236.0, 1e-9);
+    CHECK_NEAR(calibration.reprojectionError(), 0.25, 1e-9);
+
+    // Through the distorted lens with OpenCV, and back
+    const std::vector<cv::Point3f> rays = makeRays();
+    std::vector<cv::Point2f> pixels;
+    cv::projectPoints(rays, cv::Vec3d(0, 0, 0), cv::Vec3d(0, 0, 0), cameraMatrix, distortion, pixels);
+
+    std::vector<cv::Point2f> normalized(rays.size());
+    calibration.undistortPoints(pixels.data(), normalized.data(), static_cast<int>(pixels.size()));
+    double worst = 0.0;
+    for (size_t i = 0; i < rays.size(); ++i) {
+        worst = std::max(worst, static_cast<double>(cv::norm(normalized[i] - cv::Point2f(rays[i].x, rays[i].y))));
+    }
+    CHECK_NEAR(worst, 0.0, kTolerance);
+
+    // Ignoring the distortion would be well off at the corners
+    const double pinholeX = (pixels[0].x - cameraMatrix(0, 2)) / cameraMatrix(0, 0);
+    CHECK(std::abs(pinholeX - rays[0].x) > 0.01);
+
+    // Saved and loaded again unchanged
+    CHECK(calibration.save(kPath));
+    CameraCalibration reloaded;
+    CHECK(reloaded.load(kPath));
+    CHECK(cv::norm(cv::Mat(reloaded.cameraMatrix()), cv::Mat(cameraMatrix), cv::NORM_INF) < 1e-9);
+    std::vector<cv::Point2f> again(rays.size());
+    reloaded.undistortPoints(pixels.data(), again.data(), static_cast<int>(pixels.size()));
+    for (size_t i = 0; i < rays.size(); ++i) {
+        CHECK_NEAR(cv::norm(again[i] - normalized[i]), 0.0, 1e-6);
+    }
+
+    // Distortion is in normalized coordinates, so it survives rescaling
+    const CameraCalibration scaled = calibration.scaledTo(cv::Size(1280, 960));
+    std::vector<cv::Point2f> scaledPixels(pixels.size());
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        scaledPixels[i] = pixels[i] * 2.0f;
+    }
+    scaled.undistortPoints(scaledPixels.data(), again.data(), static_cast<int>(pixels.size()));
+    for (size_t i = 0; i < rays.size(); ++i) {
+        CHECK_NEAR(again[i].x, rays[i].x, kTolerance);
+        CHECK_NEAR(again[i].y, rays[i].y, kTolerance);
+    }
+
+    std::remove(kPath);
+}
+
+void checkInvalidFile() {
+    {
+        cv::FileStorage fs(kPath, cv::FileStorage::WRITE);
+        fs << "image_width" << 640;
+    }
+    CameraCalibration calibration;
+    CHECK(!calibration.load(kPath));
+    CHECK(!calibration.isCalibrated());
+    CHECK(!calibration.load("does_not_exist.yml"));
+    std::remove(kPath);
+}
+
+} // namespace
+
+int main() {
+    checkNominal();
+    checkDistortion();
+    checkInvalidFile();
+    return htk::test::result();
+}
@@ -0,0 +1,46 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cmath>
+#include <iostream>
+
+// Minimal assertions for the test executables: a failed check prints
+// where and what, the test keeps going, and main returns htk::test::result()
+namespace htk::test {
+
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+
+    inline int result() {
+        if (failures() > 0) {
+            std::cerr << failures() << " check(s) failed" << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+} // namespace htk::test
+
+#define CHECK(condition)                                                                    \
+    do {                                                                                    \
+        if (!(condition)) {                                                                 \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed"    \
+                      << std::endl;                                                         \
+            ++htk::test::failures();                                                        \
+        }                                                                                   \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                             \
+    do {                                                                                    \
+        const double htkActual = static_cast<double>(actual);                               \
+        const double htkExpected = static_cast<double>(expected);                           \
+        if (!(std::abs(htkActual - htkExpected) <= (tolerance))) {                          \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " #actual " = " << htkActual     \
+                      << ", expected " << htkExpected << " +- " << (tolerance) << std::endl; \
+            ++htk::test::failures();                                                        \
+        }                                                                                   \
+    } while (0)
+
+#endif // CHECK_H
@@ -0,0 +1,101 @@
+// Checks CommandQueue: FIFO order, full and empty behaviour, wrap-around,
+// and that with several producers racing one consumer nothing is lost,
+// duplicated or reordered per producer.
+
+#include "Check.h"
+#include "core/CommandQueue.h"
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+using htk::core::CommandQueue;
+
+void checkSingleThread() {
+    CommandQueue<int, 4> queue;
+    int value = -1;
+    CHECK(!queue.pop(value));
+
+    for (int i = 0; i < 4; ++i) {
+        CHECK(queue.push(i));
+    }
+    CHECK(!queue.push(4));  // Full: refused, not blocked
+
+    for (int i = 0; i < 4; ++i) {
+        CHECK(queue.pop(value));
+        CHECK(value == i);
+    }
+    CHECK(!queue.pop(value));
+
+    // Many times round the ring, never more than three in flight
+    int next = 0;
+    for (int round = 0; round < 1000; ++round) {
+        CHECK(queue.push(3 * round));
+        CHECK(queue.push(3 * round + 1));
+        CHECK(queue.push(3 * round + 2));
+        for (int i = 0; i < 3; ++i) {
+            CHECK(queue.pop(value));
+            CHECK(value == next++);
+        }
+    }
+}
+
+void checkProducers() {
+    constexpr int kProducers = 4;
+    constexpr long kPerProducer = 100000;
+    constexpr long kStride = 10000000;
+
+    CommandQueue<long, 64> queue;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (long i = 0; i < kPerProducer;) {
+                if (queue.push(p * kStride + i)) {
+                    ++i;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    long last[kProducers];
+    for (long& l : last) {
+        l = -1;
+    }
+    long received = 0;
+    long outOfOrder = 0;
+    long value = 0;
+    while (received < kProducers * kPerProducer) {
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const long producer = value / kStride;
+        const long index = value % kStride;
+        if (producer < 0 || producer >= kProducers || index != last[producer] + 1) {
+            ++outOfOrder;
+        } else {
+            last[producer] = index;
+        }
+        ++received;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    CHECK(outOfOrder == 0);
+    CHECK(!queue.pop(value));
+    for (long l : last) {
+        CHECK(l == kPerProducer - 1);
+    }
+}
+
+} // namespace
+
+int main() {
+    checkSingleThread();
+    checkProducers();
+    return htk::test::result();
+}
@@ -0,0 +1,142 @@
+// Drives WebcamTracker with a FakeCamera whose auto exposure halves its
+// frame rate, and checks the exposure cap: it engages after the slow
+// frames, caps exposure below the frame period, steers gain to the target
+// brightness, stays out of the way of a camera already at its nominal
+// rate, and gives the camera back when capping doesn't restore the rate.
+
+#include "Check.h"
+#include "FakeCamera.h"
+#include "input/WebcamTracker.h"
+
+#include <memory>
+
+namespace {
+
+using htk::input::ExposureSettings;
+using htk::input::WebcamTracker;
+using htk::test::FakeCamera;
+
+constexpr float kFps = 100.0f;
+constexpr uint64_t kPeriodUs = 10000;
+constexpr uint64_t kAutoIntervalUs = 25000;  // Auto exposure at 40 FPS
+
+// The controller needs 10 slow frames in a row to engage and gives up 60
+// frames after; allow some slack for a busy machine
+constexpr int kEngageWithin = 30;
+constexpr int kGiveUpWithin = 100;
+
+// Frames until the tracker takes over exposure, or -1
+int runUntilEngaged(WebcamTracker& tracker) {
+    for (int frame = 1; frame <= kEngageWithin; ++frame) {
+        CHECK(tracker.update());
+        if (tracker.isExposureCapped()) {
+            return frame;
+        }
+    }
+    return -1;
+}
+
+void checkEngageAndSteer() {
+    auto source = std::make_unique<FakeCamera>(kFps, kAutoIntervalUs);
+    FakeCamera* camera = source.get();
+    WebcamTracker tracker;
+    CHECK(tracker.initialize(std::move(source)));
+
+    const int engagedAt = runUntilEngaged(tracker);
+    std::cout << "engaged after " << engagedAt << " frames" << std::endl;
+    CHECK(engagedAt >= 10);
+    CHECK(camera->isManual());
+
+    // Capped at the headroom share of the nominal period
+    const ExposureSettings settings;
+    CHECK(camera->exposureSeconds() > 0.0);
+    CHECK(camera->exposureSeconds() <= settings.headroom * kPeriodUs * 1e-6 + 1e-9);
+    CHECK(camera->frameIntervalUs() == kPeriodUs);
+
+    // Too dark at the cap with the starting gain: gain comes up until the
+    // frame is within the deadband of the target, exposure stays capped
+    const double startGain = camera->gain();
+    CHECK(camera->greyLevel() < settings.targetBrightness * 0.8f);
+    for (int frame = 0; frame < 60; ++frame) {
+        CHECK(tracker.update());
+    }
+    std::cout << "gain " << startGain << " -> " << camera->gain() << ", grey level "
+              << camera->greyLevel() << std::endl;
+    CHECK(tracker.isExposureCapped());
+    CHECK(camera->gain() > startGain);
+    CHECK(camera->exposureSeconds() <= settings.headroom * kPeriodUs * 1e-6 + 1e-9);
+    CHECK_NEAR(camera->greyLevel(), settings.targetBrightness, settings.targetBrightness * 0.12);
+    CHECK(camera->autoRequests() == 0);
+
+    // Brighter scene: gain goes back down before exposure does
+    camera->setSceneLevel(6.0f);
+    for (int frame = 0; frame < 60; ++frame) {
+        CHECK(tracker.update());
+    }
+    std::cout << "brighter scene: gain " << camera->gain() << ", exposure "
+              << camera->exposureSeconds() * 1000.0 << " ms, grey level " << camera->greyLevel() << std::endl;
+    CHECK_NEAR(camera->greyLevel(), settings.targetBrightness, settings.targetBrightness * 0.12);
+}
+
+void checkStaysOutAtNominalRate() {
+    auto source = std::make_unique<FakeCamera>(kFps, kPeriodUs);
+    FakeCamera* camera = source.get();
+    WebcamTracker tracker;
+    CHECK(tracker.initialize(std::move(source)));
+
+    CHECK(runUntilEngaged(tracker) == -1);
+    CHECK(camera->manualRequests() == 0);
+    CHECK(camera->autoRequests() == 0);
+}
+
+void checkDisabled() {
+    auto source = std::make_unique<FakeCamera>(kFps, kAutoIntervalUs);
+    FakeCamera* camera = source.get();
+    WebcamTracker tracker;
+    ExposureSettings settings;
+    settings.enabled = false;
+    tracker.setExposureSettings(settings);
+    CHECK(tracker.initialize(std::move(source)));
+
+    CHECK(runUntilEngaged(tracker) == -1);
+    CHECK(camera->manualRequests() == 0);
+}
+
+void checkGiveUp() {
+    auto source = std::make_unique<FakeCamera>(kFps, kAutoIntervalUs);
+    FakeCamera* camera = source.get();
+    camera->setIgnoresManual(true);
+    WebcamTracker tracker;
+    CHECK(tracker.initialize(std::move(source)));
+
+    CHECK(runUntilEngaged(tracker) > 0);
+
+    // Still slow with the cap in place: handed back after 60 frames
+    int gaveUpAfter = -1;
+    for (int frame = 1; frame <= kGiveUpWithin; ++frame) {
+        CHECK(tracker.update());
+        if (!tracker.isExposureCapped()) {
+            gaveUpAfter = frame;
+            break;
+        }
+    }
+    std::cout << "gave up after " << gaveUpAfter << " frames" << std::endl;
+    CHECK(gaveUpAfter >= 60);
+    CHECK(!camera->isManual());
+    CHECK(camera->autoRequests() == 1);
+
+    // And doesn't try again on the same camera
+    const int requests = camera->manualRequests();
+    CHECK(runUntilEngaged(tracker) == -1);
+    CHECK(camera->manualRequests() == requests);
+}
+
+} // namespace
+
+int main() {
+    checkEngageAndSteer();
+    checkStaysOutAtNominalRate();
+    checkDisabled();
+    checkGiveUp();
+    return htk::test::result();
+}
@@ -0,0 +1,127 @@
+#ifndef FAKECAMERA_H
+#define FAKECAMERA_H
+
+#include "core/TrackingData.h"
+#include "input/FrameSource.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <thread>
+
+namespace htk::test {
+
+    // A live camera with exposure control, paced by the wall clock. In auto
+    // exposure it delivers a properly exposed grey frame at autoIntervalUs
+    // (slower than nominal, as auto exposure does in a dim room). Under
+    // manual exposure the frame takes max(period, exposure) and its grey
+    // level is sceneLevel per millisecond of exposure, doubled every
+    // 1/gainStops of gain. A camera that ignores manual settings keeps
+    // behaving as in auto exposure.
+    class FakeCamera : public htk::input::FrameSource {
+    public:
+        FakeCamera(float nominalFps, uint64_t autoIntervalUs)
+            : m_fps(nominalFps), m_autoIntervalUs(autoIntervalUs) {}
+
+        // Test knobs
+        void setAutoInterval(uint64_t intervalUs) { m_autoIntervalUs = intervalUs; }
+        void setIgnoresManual(bool ignores) { m_ignoresManual = ignores; }
+        void setSceneLevel(float levelPerMs) { m_sceneLevel = levelPerMs; }
+
+        // What the tracker asked for
+        bool isManual() const { return m_isManual; }
+        double exposureSeconds() const { return m_exposureSeconds; }
+        double gain() const { return m_gain; }
+        int manualRequests() const { return m_manualRequests; }
+        int autoRequests() const { return m_autoRequests; }
+
+        uint64_t frameIntervalUs() const {
+            if (!m_isManual || m_ignoresManual) {
+                return m_autoIntervalUs;
+            }
+            const double periodUs = 1e6 / m_fps;
+            return static_cast<uint64_t>(std::max(periodUs, m_exposureSeconds * 1e6));
+        }
+
+        float greyLevel() const {
+            if (!m_isManual || m_ignoresManual) {
+                return kAutoLevel;
+            }
+            const double level = m_sceneLevel * m_exposureSeconds * 1e3 * std::exp2(m_gain * kGainStops);
+            return static_cast<float>(std::min(255.0, level));
+        }
+
+        bool open() override {
+            m_isOpen = true;
+            m_nextUs = htk::core::FrameTiming::steadyMicros();
+            return true;
+        }
+
+        bool read(cv::Mat& frame) override {
+            if (!grab()) {
+                return false;
+            }
+            frame.create(kHeight, kWidth, CV_8UC3);
+            frame.setTo(cv::Scalar::all(std::round(greyLevel())));
+            return true;
+        }
+
+        // Waits for the next frame time, as a camera's driver does
+        bool grab() override {
+            if (!m_isOpen) {
+                return false;
+            }
+            m_nextUs += frameIntervalUs();
+            const uint64_t now = htk::core::FrameTiming::steadyMicros();
+            if (m_nextUs > now) {
+                std::this_thread::sleep_for(std::chrono::microseconds(m_nextUs - now));
+            } else {
+                m_nextUs = now;  // Fell behind: the next frame starts now
+            }
+            return true;
+        }
+
+        void close() override { m_isOpen = false; }
+        bool isOpened() const override { return m_isOpen; }
+        float nominalFps() const override { return m_fps; }
+
+        bool hasExposureControl() const override { return true; }
+
+        void setManualExposure(double seconds, double gain) override {
+            m_isManual = true;
+            m_exposureSeconds = seconds;
+            m_gain = gain;
+            ++m_manualRequests;
+        }
+
+        void restoreAutoExposure() override {
+            m_isManual = false;
+            ++m_autoRequests;
+        }
+
+        std::string describe() const override { return "fake camera"; }
+
+    private:
+        static constexpr int kWidth = 160;
+        static constexpr int kHeight = 120;
+        static constexpr float kAutoLevel = 110.0f;
+        static constexpr double kGainStops = 6.0;  // Full gain range
+
+        float m_fps;
+        uint64_t m_autoIntervalUs;
+        bool m_ignoresManual = false;
+        float m_sceneLevel = 2.5f;
+
+        bool m_isOpen = false;
+        uint64_t m_nextUs = 0;
+
+        bool m_isManual = false;
+        double m_exposureSeconds = 0.0;
+        double m_gain = 0.0;
+        int m_manualRequests = 0;
+        int m_autoRequests = 0;
+    };
+
+} // namespace htk::test
+
+#endif // FAKECAMERA_H
@@ -0,0 +1,93 @@
+// Checks ImagePyramid against OpenCV's own conversions: level sizes for
+// odd frame sizes, level choice by scale, levels built on demand from the
+// one above, and buffers kept across frames of the same size.
+
+#include "Check.h"
+#include "input/ImagePyramid.h"
+
+namespace {
+
+using htk::input::ImagePyramid;
+
+bool same(const cv::Mat& a, const cv::Mat& b) {
+    return a.size() == b.size() && a.type() == b.type() && cv::norm(a, b, cv::NORM_INF) == 0.0;
+}
+
+cv::Mat makeFrame(int width, int height, int seed) {
+    cv::Mat frame(height, width, CV_8UC3);
+    cv::RNG rng(seed);
+    rng.fill(frame, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+    return frame;
+}
+
+void checkLevels() {
+    const cv::Mat frame = makeFrame(641, 479, 1);
+    ImagePyramid pyramid;
+    pyramid.reset(frame);
+
+    // Sizes are known before anything is built, rounded up like pyrDown
+    CHECK(pyramid.levelSize(0) == cv::Size(641, 479));
+    CHECK(pyramid.levelSize(1) == cv::Size(321, 240));
+    CHECK(pyramid.levelSize(2) == cv::Size(161, 120));
+    CHECK(pyramid.levelSize(4) == cv::Size(41, 30));
+    CHECK_NEAR(pyramid.scaleOf(0), 1.0, 1e-12);
+    CHECK_NEAR(pyramid.scaleOf(2), 161.0 / 641.0, 1e-12);
+
+    // Deepest level at least the requested scale
+    CHECK(pyramid.levelFor(1.0) == 0);
+    CHECK(pyramid.levelFor(0.5) == 1);
+    CHECK(pyramid.levelFor(0.25) == 2);
+    CHECK(pyramid.levelFor(0.2) == 2);
+    CHECK(pyramid.levelFor(0.0) == ImagePyramid::kMaxLevels - 1);
+
+    // Asking for a deep level first builds the chain down to it
+    cv::Mat gray;
+    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+    cv::Mat expected[3] = {gray, cv::Mat(), cv::Mat()};
+    cv::pyrDown(expected[0], expected[1], pyramid.levelSize(1));
+    cv::pyrDown(expected[1], expected[2], pyramid.levelSize(2));
+
+    CHECK(same(pyramid.level(2), expected[2]));
+    CHECK(same(pyramid.level(0), expected[0]));
+    CHECK(same(pyramid.level(1), expected[1]));
+
+    // Out of range indices are clamped
+    CHECK(pyramid.level(ImagePyramid::kMaxLevels + 3).size() == pyramid.levelSize(ImagePyramid::kMaxLevels - 1));
+    CHECK(pyramid.level(-1).data == pyramid.level(0).data);
+}
+
+void checkReuse() {
+    const cv::Mat first = makeFrame(320, 240, 2);
+    const cv::Mat second = makeFrame(320, 240, 3);
+    ImagePyramid pyramid;
+
+    pyramid.reset(first);
+    const uchar* buffers[3] = {pyramid.level(0).data, pyramid.level(1).data, pyramid.level(2).data};
+
+    // A new frame replaces the levels in the same buffers, only once asked for
+    pyramid.reset(second);
+    cv::Mat gray;
+    cv::cvtColor(second, gray, cv::COLOR_BGR2GRAY);
+    CHECK(same(pyramid.level(0), gray));
+    for (int i = 0; i < 3; ++i) {
+        CHECK(pyramid.level(i).data == buffers[i]);
+    }
+
+    // A grayscale frame is taken as level 0 unchanged
+    pyramid.reset(gray);
+    CHECK(same(pyramid.level(0), gray));
+    CHECK(pyramid.level(0).data != gray.data);
+
+    // A new size gets new levels
+    const cv::Mat small = makeFrame(160, 120, 4);
+    pyramid.reset(small);
+    CHECK(pyramid.level(1).size() == cv::Size(80, 60));
+}
+
+} // namespace
+
+int main() {
+    checkLevels();
+    checkReuse();
+    return htk::test::result();
+}
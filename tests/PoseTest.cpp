@@ -0,0 +1,165 @@
+// Checks the quaternion pose pipeline where per-axis Euler arithmetic
+// goes wrong: conversions round trip at large angles, centering composes
+// rotations, and fusion brings mounted cameras into one frame.
+
+#include "Check.h"
+#include "core/Pose.h"
+#include "core/PoseFusion.h"
+
+namespace {
+
+using htk::core::CameraEstimate;
+using htk::core::Pose;
+using htk::core::PoseFusion;
+
+constexpr double kAngleTolerance = 0.01;  // Degrees
+
+void checkRoundTrip() {
+    for (float yaw = -170.0f; yaw <= 170.0f; yaw += 17.0f) {
+        for (float pitch = -80.0f; pitch <= 80.0f; pitch += 16.0f) {
+            for (float roll = -170.0f; roll <= 170.0f; roll += 34.0f) {
+                const Eigen::Quaternionf q = htk::core::rotationFromEuler(yaw, pitch, roll);
+                CHECK_NEAR(q.norm(), 1.0, 1e-5);
+
+                // Same convention as composing the three axis rotations
+                const float toRad = 3.14159265f / 180.0f;
+                const Eigen::Quaternionf expected =
+                    Eigen::AngleAxisf(yaw * toRad, Eigen::Vector3f::UnitY()) *
+                    Eigen::AngleAxisf(pitch * toRad, Eigen::Vector3f::UnitX()) *
+                    Eigen::AngleAxisf(roll * toRad, Eigen::Vector3f::UnitZ());
+                CHECK_NEAR(std::abs(q.dot(expected)), 1.0, 1e-5);
+
+                float y = 0.0f, p = 0.0f, r = 0.0f;
+                htk::core::rotationToEuler(q, y, p, r);
+                CHECK_NEAR(y, yaw, kAngleTolerance);
+                CHECK_NEAR(p, pitch, kAngleTolerance);
+                CHECK_NEAR(r, roll, kAngleTolerance);
+            }
+        }
+    }
+}
+
+void checkDirections() {
+    // Yaw and pitch from ray slopes as the tracker has them, roll from an
+    // eye vector of any length
+    for (float yaw = -80.0f; yaw <= 80.0f; yaw += 20.0f) {
+        for (float pitch = -80.0f; pitch <= 80.0f; pitch += 20.0f) {
+            for (float roll = -170.0f; roll <= 170.0f; roll += 34.0f) {
+                const float toRad = 3.14159265f / 180.0f;
+                const Eigen::Quaternionf q = htk::core::rotationFromDirections(
+                    Eigen::Vector2f(1.0f, std::tan(yaw * toRad)),
+                    Eigen::Vector2f(1.0f, std::tan(pitch * toRad)),
+                    40.0f * Eigen::Vector2f(std::cos(roll * toRad), std::sin(roll * toRad)));
+                CHECK_NEAR(q.norm(), 1.0, 1e-5);
+                CHECK_NEAR(std::abs(q.dot(htk::core::rotationFromEuler(yaw, pitch, roll))), 1.0, 1e-5);
+            }
+        }
+    }
+}
+
+void checkBlend() {
+    // The per-frame blend stays on the way between the two, the short way
+    // round even across the sign flip, and lands on both ends
+    const Eigen::Quaternionf from = htk::core::rotationFromEuler(-20.0f, 10.0f, 0.0f);
+    Eigen::Quaternionf to = htk::core::rotationFromEuler(40.0f, -5.0f, 15.0f);
+    to.coeffs() = -to.coeffs();
+
+    CHECK_NEAR(std::abs(htk::core::blendRotation(from, to, 0.0f).dot(from)), 1.0, 1e-6);
+    CHECK_NEAR(std::abs(htk::core::blendRotation(from, to, 1.0f).dot(to)), 1.0, 1e-6);
+    const Eigen::Quaternionf half = htk::core::blendRotation(from, to, 0.5f);
+    CHECK_NEAR(std::abs(half.dot(from.slerp(0.5f, to))), 1.0, 1e-6);
+    for (float t = 0.1f; t < 1.0f; t += 0.2f) {
+        const Eigen::Quaternionf q = htk::core::blendRotation(from, to, t);
+        CHECK_NEAR(q.norm(), 1.0, 1e-5);
+        CHECK_NEAR(q.angularDistance(from) + q.angularDistance(to), from.angularDistance(to), 1e-4);
+    }
+}
+
+void checkCentering() {
+    // Centered while looking 60 degrees left and 30 down: turning the head
+    // a further 20 degrees about its own vertical axis must read as pure yaw,
+    // which subtracting Euler angles per axis does not give
+    const Eigen::Quaternionf center = htk::core::rotationFromEuler(60.0f, -30.0f, 0.0f);
+    const Eigen::Quaternionf turned = center * htk::core::rotationFromEuler(20.0f, 0.0f, 0.0f);
+
+    Pose pose;
+    pose.rotation = center.conjugate() * turned;
+    pose.isValid = true;
+    const htk::core::TrackingData data = pose.toTrackingData();
+    CHECK_NEAR(data.yaw, 20.0, kAngleTolerance);
+    CHECK_NEAR(data.pitch, 0.0, kAngleTolerance);
+    CHECK_NEAR(data.roll, 0.0, kAngleTolerance);
+}
+
+void checkRotationVector() {
+    const Eigen::Quaternionf from = htk::core::rotationFromEuler(10.0f, 5.0f, -3.0f);
+    const Eigen::Quaternionf to = htk::core::rotationFromEuler(70.0f, -40.0f, 25.0f);
+    const Eigen::Vector3f step = htk::core::rotationBetween(from, to);
+    const Eigen::Quaternionf back = htk::core::rotationFromVector(step) * from;
+    CHECK_NEAR(std::abs(back.dot(to)), 1.0, 1e-5);
+    CHECK(htk::core::rotationFromVector(Eigen::Vector3f::Zero()).isApprox(Eigen::Quaternionf::Identity()));
+
+    // The coasting step matches the exact rotation for a frame's worth of
+    // turn, and is still within a few percent at half a radian
+    const Eigen::Vector3f small(0.02f, -0.01f, 0.005f);
+    CHECK_NEAR(std::abs(htk::core::rotationStep(small).dot(htk::core::rotationFromVector(small))), 1.0, 1e-6);
+    const Eigen::Vector3f large(0.3f, -0.3f, 0.2f);
+    const float angle = htk::core::rotationStep(large).angularDistance(Eigen::Quaternionf::Identity());
+    CHECK_NEAR(angle, large.norm(), 0.03 * large.norm());
+}
+
+void checkFusion() {
+    // The head as the primary camera sees it
+    Pose truth;
+    truth.rotation = htk::core::rotationFromEuler(25.0f, 10.0f, 5.0f);
+    truth.translation = Eigen::Vector3f(30.0f, -20.0f, 600.0f);
+
+    // A second camera 300 mm to the right and 50 mm forward, turned 40
+    // degrees and tilted 15, sees it in its own frame
+    CameraEstimate estimates[2];
+    estimates[0].pose = truth;
+    estimates[1].setMount(40.0f, -15.0f, Eigen::Vector3f(300.0f, 0.0f, 50.0f));
+    estimates[1].pose.rotation = estimates[1].mount.conjugate() * truth.rotation;
+    estimates[1].pose.translation =
+        estimates[1].mount.conjugate() * (truth.translation - estimates[1].mountOffset);
+
+    for (CameraEstimate& estimate : estimates) {
+        estimate.pose.timestamp = 1000;
+        estimate.pose.confidence = 0.8f;
+        estimate.pose.isValid = true;
+    }
+    // The flipped sign of the same rotation must not cancel it out
+    estimates[1].pose.rotation.coeffs() = -estimates[1].pose.rotation.coeffs();
+
+    const Pose fused = PoseFusion().fuse(estimates, 2);
+    CHECK(fused.isValid);
+    CHECK_NEAR(std::abs(fused.rotation.dot(truth.rotation)), 1.0, 1e-5);
+    CHECK_NEAR((fused.translation - truth.translation).norm(), 0.0, 1e-3);
+    CHECK_NEAR(fused.confidence, 0.8, 1e-6);
+
+    // A stale estimate is left out
+    estimates[1].pose.timestamp = 1000 + 1000000;
+    estimates[1].pose.translation += Eigen::Vector3f(100.0f, 0.0f, 0.0f);
+    const Pose newest = PoseFusion().fuse(estimates, 2);
+    CHECK(newest.isValid);
+    CHECK_NEAR((newest.translation - PoseFusion::toPrimaryFrame(estimates[1]).translation).norm(), 0.0, 1e-3);
+
+    // Without the offset the two cameras would disagree by about the
+    // distance between them
+    estimates[1].pose.timestamp = 1000;
+    estimates[1].pose.translation -= Eigen::Vector3f(100.0f, 0.0f, 0.0f);
+    estimates[1].setMount(40.0f, -15.0f);
+    CHECK((PoseFusion::toPrimaryFrame(estimates[1]).translation - truth.translation).norm() > 250.0f);
+}
+
+} // namespace
+
+int main() {
+    checkRoundTrip();
+    checkDirections();
+    checkBlend();
+    checkCentering();
+    checkRotationVector();
+    checkFusion();
+    return htk::test::result();
+}
@@ -0,0 +1,154 @@
+// Checks the FreeTrack and TrackIR encoders and publishPacket(): field
+// values and units, bytes in shared memory, and that a reader following
+// the sequence protocol never keeps a torn packet while a writer publishes.
+
+#include "Check.h"
+#include "output/ProtocolFormat.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+using htk::core::TrackingData;
+using namespace htk::output;
+
+constexpr double kTolerance = 1e-6;
+
+TrackingData makePose() {
+    TrackingData data;
+    data.yaw = 90.0f;
+    data.pitch = -45.0f;
+    data.roll = 180.0f;
+    data.x = 12.5f;
+    data.y = -7.0f;
+    data.z = 640.0f;
+    data.confidence = 0.9f;
+    data.isValid = true;
+    return data;
+}
+
+void checkFreeTrackEncode() {
+    freetrack::Packet packet;
+    std::memset(&packet, 0xff, sizeof(packet));
+    freetrack::encode(makePose(), 42, packet);
+
+    CHECK(packet.dataID == 42);
+    CHECK(packet.camWidth == 640);
+    CHECK(packet.camHeight == 480);
+    CHECK_NEAR(packet.yaw, 3.14159265 / 2.0, kTolerance);
+    CHECK_NEAR(packet.pitch, -3.14159265 / 4.0, kTolerance);
+    CHECK_NEAR(packet.roll, 3.14159265, kTolerance);
+    CHECK_NEAR(packet.x, 12.5, kTolerance);
+    CHECK_NEAR(packet.y, -7.0, kTolerance);
+    CHECK_NEAR(packet.z, 640.0, kTolerance);
+    CHECK(packet.rawyaw == packet.yaw && packet.rawpitch == packet.pitch && packet.rawroll == packet.roll);
+    CHECK(packet.rawx == packet.x && packet.rawy == packet.y && packet.rawz == packet.z);
+
+    // Nothing left over from before: the point data is cleared
+    CHECK(packet.x1 == 0.0f && packet.y4 == 0.0f);
+}
+
+void checkTrackIREncode() {
+    trackir::Packet packet;
+    std::memset(&packet, 0xff, sizeof(packet));
+    trackir::encode(makePose(), 7, packet);
+
+    CHECK(packet.status == 1);
+    CHECK(packet.frame == 7);
+    CHECK(packet.cksum == 0);
+    CHECK_NEAR(packet.yaw, 3.14159265 / 2.0, kTolerance);
+    CHECK_NEAR(packet.z, 640.0, kTolerance);
+    CHECK(packet.rawroll == packet.roll && packet.rawz == packet.z);
+    CHECK(packet.x3 == 0.0f && packet.y3 == 0.0f);
+
+    TrackingData lost = makePose();
+    lost.isValid = false;
+    trackir::encode(lost, 9, packet);
+    CHECK(packet.status == 0);
+}
+
+void checkPublish() {
+    freetrack::Packet freeTrack;
+    freetrack::encode(makePose(), 100, freeTrack);
+    freetrack::Packet freeTrackShared{};
+    freetrack::publish(&freeTrackShared, freeTrack);
+    CHECK(std::memcmp(&freeTrackShared, &freeTrack, sizeof(freeTrack)) == 0);
+
+    trackir::Packet trackIR;
+    trackir::encode(makePose(), 100, trackIR);
+    trackir::Packet trackIRShared{};
+    trackir::publish(&trackIRShared, trackIR);
+    CHECK(std::memcmp(&trackIRShared, &trackIR, sizeof(trackIR)) == 0);
+
+    // Sequence wrap-around: 0 is published through the odd 0xffff
+    trackir::encode(makePose(), 0, trackIR);
+    trackir::publish(&trackIRShared, trackIR);
+    CHECK(trackIRShared.frame == 0);
+}
+
+// One thread publishes packets whose every float is the sequence number,
+// another copies them the way a careful game would
+void checkNoTornReads() {
+    constexpr uint32_t kPackets = 100000;
+
+    alignas(64) freetrack::Packet shared{};
+    std::atomic<bool> done{false};
+
+    std::thread writer([&] {
+        for (uint32_t sequence = 2; sequence <= 2 * kPackets; sequence += 2) {
+            freetrack::Packet packet;
+            TrackingData data;
+            data.x = data.y = data.z = static_cast<float>(sequence);
+            freetrack::encode(data, sequence, packet);
+            packet.x1 = packet.y4 = static_cast<float>(sequence);
+            freetrack::publish(&shared, packet);
+            std::this_thread::yield();
+        }
+        done.store(true);
+    });
+
+    long accepted = 0;
+    long rejected = 0;
+    long torn = 0;
+    const volatile uint32_t* dataID = &shared.dataID;
+    while (!done.load()) {
+        const uint32_t before = *dataID;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        freetrack::Packet copy;
+        std::memcpy(&copy, const_cast<const freetrack::Packet*>(&shared), sizeof(copy));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint32_t after = *dataID;
+
+        if (before != after || (before & 1) != 0) {
+            ++rejected;
+            std::this_thread::yield();
+            continue;
+        }
+        ++accepted;
+
+        const float expected = static_cast<float>(before);
+        if (before != 0 && (copy.x != expected || copy.z != expected || copy.x1 != expected ||
+                            copy.y4 != expected || copy.dataID != before)) {
+            ++torn;
+        }
+        std::this_thread::yield();
+    }
+    writer.join();
+
+    CHECK(torn == 0);
+    CHECK(accepted > 0);
+    std::cout << "reader: " << accepted << " packets kept, " << rejected << " rejected, " << torn << " torn"
+              << std::endl;
+}
+
+} // namespace
+
+int main() {
+    checkFreeTrackEncode();
+    checkTrackIREncode();
+    checkPublish();
+    checkNoTornReads();
+    return htk::test::result();
+}
@@ -0,0 +1,58 @@
+#ifndef REPLAYSOURCE_H
+#define REPLAYSOURCE_H
+
+#include "input/FrameSource.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace htk::test {
+
+    // Frames held in memory, handed out in a loop with media timestamps at
+    // the given rate. read() copies into the caller's buffer, so a steady
+    // frame size costs no allocation.
+    class ReplaySource : public htk::input::FrameSource {
+    public:
+        ReplaySource(std::vector<cv::Mat> frames, float fps)
+            : m_frames(std::move(frames)), m_fps(fps) {}
+
+        bool open() override {
+            m_isOpen = !m_frames.empty();
+            m_index = -1;
+            return m_isOpen;
+        }
+
+        bool read(cv::Mat& frame) override {
+            if (!grab()) {
+                return false;
+            }
+            m_frames[static_cast<size_t>(m_index) % m_frames.size()].copyTo(frame);
+            return true;
+        }
+
+        bool grab() override {
+            ++m_index;
+            return m_isOpen;
+        }
+
+        void close() override { m_isOpen = false; }
+        bool isOpened() const override { return m_isOpen; }
+        float nominalFps() const override { return m_fps; }
+
+        uint64_t mediaTimeUs() const override {
+            return m_index < 0 ? 0 : 1000000 + static_cast<uint64_t>(m_index * 1e6 / m_fps);
+        }
+
+        std::string describe() const override { return "replay"; }
+
+    private:
+        std::vector<cv::Mat> m_frames;
+        float m_fps;
+        bool m_isOpen = false;
+        long m_index = -1;
+    };
+
+} // namespace htk::test
+
+#endif // REPLAYSOURCE_H
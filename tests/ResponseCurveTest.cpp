@@ -0,0 +1,74 @@
+// Checks the per-axis response tables: unconfigured axes pass any value
+// through (an uncentered Z is the camera distance), configured ones shape
+// and clamp to their range.
+
+#include "Check.h"
+#include "core/ResponseCurve.h"
+
+namespace {
+
+using htk::core::PoseAxis;
+using htk::core::ResponseCurve;
+using htk::core::ResponseMapper;
+using htk::core::TrackingData;
+
+void checkUnconfiguredPassesThrough() {
+    ResponseMapper mapper;
+
+    TrackingData data;
+    data.isValid = true;
+    data.yaw = 170.0f;
+    data.pitch = -45.0f;
+    data.roll = 12.5f;
+    data.x = -30.0f;
+    data.y = 820.0f;
+    data.z = 600.0f;  // Uncentered: the face at 60 cm
+
+    const TrackingData output = mapper.apply(data);
+    CHECK_NEAR(output.yaw, 170.0, 1e-6);
+    CHECK_NEAR(output.pitch, -45.0, 1e-6);
+    CHECK_NEAR(output.roll, 12.5, 1e-6);
+    CHECK_NEAR(output.x, -30.0, 1e-6);
+    CHECK_NEAR(output.y, 820.0, 1e-6);
+    CHECK_NEAR(output.z, 600.0, 1e-6);
+}
+
+void checkConfiguredCurve() {
+    ResponseMapper mapper;
+
+    ResponseCurve curve;
+    curve.sensitivity = 2.0f;
+    curve.deadzone = 10.0f;
+    mapper.setCurve(PoseAxis::Z, curve);
+    mapper.applyPending();
+
+    TrackingData data;
+    data.isValid = true;
+    data.z = 5.0f;
+    CHECK_NEAR(mapper.apply(data).z, 0.0, 1e-3);  // Inside the deadzone
+
+    // Past the deadzone the rest of the range is rescaled, then doubled
+    data.z = 255.0f;
+    CHECK_NEAR(mapper.apply(data).z, 2.0 * (255.0 - 10.0) * 500.0 / 490.0, 1.0);
+
+    // A configured table still stops at its range
+    data.z = 600.0f;
+    CHECK_NEAR(mapper.apply(data).z, 1000.0, 1.0);
+
+    // The other axes stay untouched
+    data.yaw = 33.0f;
+    CHECK_NEAR(mapper.apply(data).yaw, 33.0, 1e-6);
+
+    // Back to the default curve: pass-through again
+    mapper.setCurve(PoseAxis::Z, ResponseCurve());
+    mapper.applyPending();
+    CHECK_NEAR(mapper.apply(data).z, 600.0, 1e-6);
+}
+
+} // namespace
+
+int main() {
+    checkUnconfiguredPassesThrough();
+    checkConfiguredCurve();
+    return htk::test::result();
+}
@@ -0,0 +1,123 @@
+// Records sessions through SessionRecorder with small chunks, so the file
+// grows many times, and reads them back with SessionReader: every sample
+// must survive the chunk seams, whether the next chunk was mapped ahead by
+// the recorder's own thread or by append() when it fell behind. On Linux
+// also checks that appending into chunks mapped ahead takes no page faults.
+
+#include "Check.h"
+#include "core/SessionReader.h"
+#include "core/SessionRecorder.h"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+using htk::core::SessionReader;
+using htk::core::SessionRecorder;
+using htk::core::SessionSample;
+
+const char* const kPath = "session_recorder_test.htks";
+constexpr size_t kChunkSize = 64 * 1024;
+
+SessionSample makeSample(int i) {
+    SessionSample sample;
+    sample.data.yaw = static_cast<float>(i % 3600) * 0.05f - 90.0f;
+    sample.data.pitch = static_cast<float>(i % 700) * 0.1f - 35.0f;
+    sample.data.roll = static_cast<float>(i % 50);
+    sample.data.x = static_cast<float>(i % 400) - 200.0f;
+    sample.data.y = static_cast<float>(i % 90);
+    sample.data.z = 600.0f + static_cast<float>(i % 20);
+    sample.data.timestamp = 1000000 + static_cast<uint64_t>(i) * 16667;
+    sample.data.confidence = 1.0f;
+    sample.data.isValid = (i % 17) != 0;
+    sample.timing.captureUs = static_cast<uint32_t>(i % 5000);
+    sample.timing.detectUs = 4000;
+    sample.rectX = 100 + (i / 10) % 50;
+    sample.rectW = 120;
+    return sample;
+}
+
+long minorFaults() {
+#ifdef __linux__
+    rusage usage{};
+    getrusage(RUSAGE_THREAD, &usage);
+    return usage.ru_minflt;
+#else
+    return 0;
+#endif
+}
+
+void checkReadBack(int count) {
+    SessionReader reader;
+    CHECK(reader.open(kPath));
+
+    SessionSample sample;
+    int read = 0;
+    int mismatches = 0;
+    while (reader.next(sample)) {
+        const SessionSample expected = makeSample(read);
+        if (std::abs(sample.data.yaw - expected.data.yaw) > 0.01f ||
+            std::abs(sample.data.x - expected.data.x) > 0.1f ||
+            sample.data.timestamp != expected.data.timestamp ||
+            sample.data.isValid != expected.data.isValid ||
+            sample.timing.captureUs != expected.timing.captureUs || sample.rectX != expected.rectX) {
+            if (++mismatches <= 3) {
+                std::cerr << "sample " << read << " differs" << std::endl;
+            }
+        }
+        ++read;
+    }
+    CHECK(read == count);
+    CHECK(mismatches == 0);
+}
+
+// Flat out: the writer outruns the background mapping and extends itself
+void checkFastWriter() {
+    constexpr int kSamples = 200000;
+    SessionRecorder recorder;
+    CHECK(recorder.open(kPath, kChunkSize));
+    for (int i = 0; i < kSamples; ++i) {
+        CHECK(recorder.append(makeSample(i)));
+    }
+    CHECK(recorder.bytesWritten() > 20 * kChunkSize);
+    recorder.close();
+    checkReadBack(kSamples);
+}
+
+// At a tracking-like pace the next chunk is always ready before it's needed
+void checkPacedWriter() {
+    constexpr int kSamples = 30000;
+    constexpr int kBurst = 1000;  // About a quarter chunk between pauses
+    SessionRecorder recorder;
+    CHECK(recorder.open(kPath, kChunkSize));
+
+    long faults = 0;
+    for (int i = 0; i < kSamples; i += kBurst) {
+        const long before = minorFaults();
+        for (int j = i; j < i + kBurst; ++j) {
+            recorder.append(makeSample(j));
+        }
+        faults += minorFaults() - before;
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    }
+    std::cout << "paced writer: " << recorder.bytesWritten() / kChunkSize << " chunks, "
+              << faults << " page faults while appending" << std::endl;
+    CHECK(faults == 0);
+    recorder.close();
+    checkReadBack(kSamples);
+}
+
+} // namespace
+
+int main() {
+    checkFastWriter();
+    checkPacedWriter();
+    std::remove(kPath);
+    return htk::test::result();
+}
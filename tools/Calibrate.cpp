@@ -0,0 +1,73 @@
+// htk-calibrate: compute camera intrinsics and lens distortion from
+// checkerboard photos and write them in the format --calibration reads.
+
+#include "input/CameraCalibration.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using htk::input::CameraCalibration;
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: htk-calibrate <out.yml> --board <cols>x<rows> --square <mm> <image>...\n"
+              << "  cols/rows count inner corners. Use 10+ photos covering the whole frame\n"
+              << "  at the resolution you track at.\n";
+}
+
+bool parseBoard(const char* text, cv::Size& board) {
+    return std::sscanf(text, "%dx%d", &board.width, &board.height) == 2 &&
+           board.width > 1 && board.height > 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    const std::string outputPath = argv[1];
+    cv::Size board(9, 6);
+    float squareSize = 25.0f;
+    std::vector<std::string> images;
+
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--board") == 0 && i + 1 < argc) {
+            if (!parseBoard(argv[++i], board)) {
+                printUsage();
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--square") == 0 && i + 1 < argc) {
+            squareSize = static_cast<float>(std::atof(argv[++i]));
+        } else {
+            images.emplace_back(argv[i]);
+        }
+    }
+
+    if (images.empty() || squareSize <= 0.0f) {
+        printUsage();
+        return 1;
+    }
+
+    CameraCalibration calibration;
+    if (!CameraCalibration::calibrate(images, board, squareSize, calibration)) {
+        return 1;
+    }
+
+    const cv::Matx33d& k = calibration.cameraMatrix();
+    std::printf("%dx%d: fx %.1f fy %.1f cx %.1f cy %.1f, RMS reprojection error %.3f px\n",
+                calibration.imageSize().width, calibration.imageSize().height,
+                k(0, 0), k(1, 1), k(0, 2), k(1, 2), calibration.reprojectionError());
+    if (calibration.reprojectionError() > 1.0) {
+        std::cerr << "Warning: high reprojection error, check the board size and photos" << std::endl;
+    }
+
+    return calibration.save(outputPath) ? 0 : 1;
+}
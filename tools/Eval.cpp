@@ -0,0 +1,525 @@
+// htk-eval: run the tracking pipeline over a directory of annotated videos,
+// one pipeline per core, and report accuracy and speed per file and overall.
+// Can also synthesize a small annotated dataset for CI, or evaluate synthetic
+// sequences rendered in memory at any resolution and frame rate.
+//
+// Annotations sit next to each video as <name>.pose.csv with the header
+// frame,yaw,pitch,roll,x,y,z (degrees and mm, camera frame as in Pose.h).
+
+#include "core/Pose.h"
+#include "input/SyntheticSource.h"
+#include "input/VideoFileSource.h"
+#include "input/WebcamTracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace fs = std::filesystem;
+
+using htk::core::Pose;
+using htk::input::FrameSource;
+using htk::input::SyntheticSettings;
+using htk::input::SyntheticSource;
+using htk::input::VideoFileSource;
+using htk::input::WebcamTracker;
+
+namespace {
+
+constexpr float kRadToDeg = 180.0f / 3.14159265358979f;
+
+struct TruthFrame {
+    bool isValid = false;
+    float yaw = 0.0f, pitch = 0.0f, roll = 0.0f;
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+};
+
+// One evaluated sequence: an annotated video, or a synthetic source with
+// exact ground truth
+struct Sequence {
+    std::string name;
+    fs::path video;
+    std::vector<TruthFrame> truth;
+    bool isSynthetic = false;
+    SyntheticSettings synthetic;
+};
+
+struct FileResult {
+    std::string name;
+    bool ok = false;
+    uint64_t frames = 0;
+    uint64_t valid = 0;
+    std::vector<float> angularError;   // Degrees, valid frames with truth
+    std::vector<float> positionError;  // mm
+    std::vector<float> angularJitter;  // Frame-to-frame change of the error, degrees
+    std::vector<float> positionJitter; // mm
+    std::vector<uint64_t> latencyUs;   // Whole update(): decode, detect, pose
+    double wallSeconds = 0.0;
+    double cpuSeconds = 0.0;
+};
+
+void printUsage() {
+    std::cerr << "Usage: htk-eval <dataset-dir> [--jobs N] [--csv <out.csv>] [--smoothing F] [--no-refine] [--no-ensemble]\n"
+              << "                [--min-valid F]\n"
+              << "       htk-eval --synthetic <width>x<height>@<fps> [--files N] [--frames N] [--face <image>]\n"
+              << "                [--jobs N] [--csv <out.csv>] [--smoothing F] [--no-refine] [--no-ensemble]\n"
+              << "                [--min-valid F]\n"
+              << "       htk-eval --synthesize <dataset-dir> [--files N] [--frames N] [--face <image>]\n"
+              << "  Evaluates every video with a <name>.pose.csv next to it, or synthetic\n"
+              << "  sequences rendered in memory against their exact trajectory.\n"
+              << "  --min-valid fails the run when fewer than that fraction of frames were tracked.\n";
+}
+
+double threadCpuSeconds() {
+#ifdef _WIN32
+    FILETIME created, exited, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user)) {
+        return 0.0;
+    }
+    const auto ticks = [](const FILETIME& t) {
+        return (static_cast<uint64_t>(t.dwHighDateTime) << 32) | t.dwLowDateTime;
+    };
+    return static_cast<double>(ticks(kernel) + ticks(user)) / 1e7;
+#else
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+#endif
+}
+
+// Percentile of an unsorted sample set (sorts in place)
+template <typename T>
+T percentile(std::vector<T>& values, double p) {
+    if (values.empty()) {
+        return T{};
+    }
+    const size_t idx = static_cast<size_t>(p * static_cast<double>(values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + idx, values.end());
+    return values[idx];
+}
+
+float mean(const std::vector<float>& values) {
+    double sum = 0.0;
+    for (float v : values) {
+        sum += v;
+    }
+    return values.empty() ? 0.0f : static_cast<float>(sum / static_cast<double>(values.size()));
+}
+
+std::string truthPathFor(const fs::path& video) {
+    fs::path truth = video;
+    truth.replace_extension(".pose.csv");
+    return truth.string();
+}
+
+bool loadTruth(const std::string& path, std::vector<TruthFrame>& truth) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+
+    std::string line;
+    std::getline(in, line);  // Header
+    while (std::getline(in, line)) {
+        int frame = -1;
+        TruthFrame t;
+        if (std::sscanf(line.c_str(), "%d,%f,%f,%f,%f,%f,%f", &frame,
+                        &t.yaw, &t.pitch, &t.roll, &t.x, &t.y, &t.z) != 7 || frame < 0) {
+            continue;
+        }
+        t.isValid = true;
+        if (static_cast<size_t>(frame) >= truth.size()) {
+            truth.resize(static_cast<size_t>(frame) + 1);
+        }
+        truth[static_cast<size_t>(frame)] = t;
+    }
+    return !truth.empty();
+}
+
+TruthFrame truthFromPose(const Pose& pose) {
+    TruthFrame t;
+    htk::core::rotationToEuler(pose.rotation, t.yaw, t.pitch, t.roll);
+    t.x = pose.translation.x();
+    t.y = pose.translation.y();
+    t.z = pose.translation.z();
+    t.isValid = true;
+    return t;
+}
+
+// Single-threaded pipeline over one sequence, timed on the calling thread
+FileResult evaluate(const Sequence& sequence, float smoothing, const htk::input::DetectionSettings& detection) {
+    FileResult result;
+    result.name = sequence.name;
+
+    // Truth for the frame the tracker just processed
+    std::unique_ptr<FrameSource> source;
+    std::function<bool(TruthFrame&)> truthNow;
+    if (sequence.isSynthetic) {
+        auto synthetic = std::make_unique<SyntheticSource>(sequence.synthetic);
+        const SyntheticSource* render = synthetic.get();
+        truthNow = [render](TruthFrame& t) {
+            t = truthFromPose(render->groundTruth(render->frameIndex()));
+            return true;
+        };
+        source = std::move(synthetic);
+    } else {
+        auto replay = std::make_unique<VideoFileSource>(sequence.video.string(), false, false);
+        const VideoFileSource* video = replay.get();
+        const std::vector<TruthFrame>& truth = sequence.truth;
+        truthNow = [video, &truth](TruthFrame& t) {
+            const size_t index = static_cast<size_t>(video->frameIndex());
+            if (index >= truth.size() || !truth[index].isValid) {
+                return false;
+            }
+            t = truth[index];
+            return true;
+        };
+        source = std::move(replay);
+    }
+
+    WebcamTracker tracker;
+    if (!tracker.initialize(std::move(source))) {
+        return result;
+    }
+    tracker.setSmoothing(smoothing);
+    tracker.setDetectionSettings(detection);
+
+    // One thread per pipeline: the ensemble and eye searches run serially,
+    // so --jobs maps to cores and cpu_s (this thread's clock) covers it all
+    tracker.setWorkerThreads(0);
+
+    // Jitter: how much the error moves between consecutive scored frames,
+    // which the truth's own motion doesn't contribute to
+    bool havePrevious = false;
+    Eigen::Vector3f previousAngular = Eigen::Vector3f::Zero();
+    Eigen::Vector3f previousPosition = Eigen::Vector3f::Zero();
+
+    using Clock = std::chrono::steady_clock;
+    const double cpuStart = threadCpuSeconds();
+    const auto wallStart = Clock::now();
+
+    for (;;) {
+        const auto frameStart = Clock::now();
+        if (!tracker.update()) {
+            break;
+        }
+        result.latencyUs.push_back(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - frameStart).count()));
+        ++result.frames;
+
+        const Pose& pose = tracker.getPose();
+        if (!pose.isValid) {
+            continue;
+        }
+        ++result.valid;
+
+        TruthFrame t;
+        if (!truthNow(t)) {
+            havePrevious = false;
+            continue;
+        }
+        const Eigen::Quaternionf expected = htk::core::rotationFromEuler(t.yaw, t.pitch, t.roll);
+        const Eigen::Vector3f angular = htk::core::rotationBetween(expected, pose.rotation) * kRadToDeg;
+        const Eigen::Vector3f position = pose.translation - Eigen::Vector3f(t.x, t.y, t.z);
+        result.angularError.push_back(angular.norm());
+        result.positionError.push_back(position.norm());
+
+        if (havePrevious) {
+            result.angularJitter.push_back((angular - previousAngular).norm());
+            result.positionJitter.push_back((position - previousPosition).norm());
+        }
+        previousAngular = angular;
+        previousPosition = position;
+        havePrevious = true;
+    }
+
+    result.wallSeconds = std::chrono::duration<double>(Clock::now() - wallStart).count();
+    result.cpuSeconds = threadCpuSeconds() - cpuStart;
+    result.ok = result.frames > 0;
+    tracker.shutdown();
+    return result;
+}
+
+void printHeader() {
+    std::printf("%-28s %7s %6s %8s %8s %8s %7s %7s %8s %8s %7s %7s\n", "file", "frames", "valid%",
+                "ang_mean", "ang_p95", "pos_mean", "jit_deg", "jit_mm", "lat_p50", "lat_p95", "fps", "cpu_s");
+}
+
+void printRow(const std::string& name, const FileResult& r) {
+    std::vector<float> angular = r.angularError;
+    std::vector<uint64_t> latency = r.latencyUs;
+    std::printf("%-28s %7llu %6.1f %8.2f %8.2f %8.1f %7.3f %7.2f %8llu %8llu %7.1f %7.2f\n", name.c_str(),
+                static_cast<unsigned long long>(r.frames),
+                r.frames ? 100.0 * static_cast<double>(r.valid) / static_cast<double>(r.frames) : 0.0,
+                mean(r.angularError), percentile(angular, 0.95), mean(r.positionError),
+                mean(r.angularJitter), mean(r.positionJitter),
+                static_cast<unsigned long long>(percentile(latency, 0.50)),
+                static_cast<unsigned long long>(percentile(latency, 0.95)),
+                r.wallSeconds > 0.0 ? static_cast<double>(r.frames) / r.wallSeconds : 0.0,
+                r.cpuSeconds);
+}
+
+void writeCsv(std::ostream& out, const std::vector<FileResult>& results) {
+    out << "file,frames,valid,angular_mean_deg,angular_p95_deg,position_mean_mm,"
+           "angular_jitter_deg,position_jitter_mm,latency_p50_us,latency_p95_us,wall_s,cpu_s\n";
+    for (const auto& r : results) {
+        std::vector<float> angular = r.angularError;
+        std::vector<uint64_t> latency = r.latencyUs;
+        char line[320];
+        std::snprintf(line, sizeof(line), "%s,%llu,%llu,%.3f,%.3f,%.2f,%.4f,%.3f,%llu,%llu,%.3f,%.3f\n",
+                      r.name.c_str(), static_cast<unsigned long long>(r.frames),
+                      static_cast<unsigned long long>(r.valid),
+                      mean(r.angularError), percentile(angular, 0.95), mean(r.positionError),
+                      mean(r.angularJitter), mean(r.positionJitter),
+                      static_cast<unsigned long long>(percentile(latency, 0.50)),
+                      static_cast<unsigned long long>(percentile(latency, 0.95)),
+                      r.wallSeconds, r.cpuSeconds);
+        out << line;
+    }
+}
+
+bool loadDataset(const std::string& directory, std::vector<Sequence>& sequences) {
+    // Dataset in a stable order so reports diff cleanly
+    std::vector<fs::path> videos;
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(directory, error)) {
+        const std::string ext = entry.path().extension().string();
+        if (ext == ".avi" || ext == ".mp4" || ext == ".mkv" || ext == ".mov") {
+            videos.push_back(entry.path());
+        }
+    }
+    if (error) {
+        std::cerr << "Failed to read " << directory << ": " << error.message() << std::endl;
+        return false;
+    }
+    std::sort(videos.begin(), videos.end());
+
+    for (const auto& video : videos) {
+        Sequence sequence;
+        if (!loadTruth(truthPathFor(video), sequence.truth)) {
+            std::cerr << "Skipping " << video.filename().string() << " (no annotations)" << std::endl;
+            continue;
+        }
+        sequence.name = video.filename().string();
+        sequence.video = video;
+        sequences.push_back(std::move(sequence));
+    }
+    if (sequences.empty()) {
+        std::cerr << "No annotated videos in " << directory << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Synthetic sequences, one trajectory seed each, rendered while evaluated
+std::vector<Sequence> syntheticDataset(const SyntheticSettings& settings, int files) {
+    std::vector<Sequence> sequences;
+    for (int file = 0; file < files; ++file) {
+        Sequence sequence;
+        char name[64];
+        std::snprintf(name, sizeof(name), "synthetic_%03d", file);
+        sequence.name = name;
+        sequence.isSynthetic = true;
+        sequence.synthetic = settings;
+        sequence.synthetic.seed = static_cast<uint32_t>(file + 1);
+        sequences.push_back(std::move(sequence));
+    }
+    return sequences;
+}
+
+int runEvaluation(const std::vector<Sequence>& sequences, unsigned jobs, const std::string& csvPath,
+                  float smoothing, const htk::input::DetectionSettings& detection, double minValid) {
+    // One single-threaded pipeline per core: OpenCV's own pool would make
+    // timings depend on what the other pipelines are doing
+    cv::setNumThreads(1);
+    jobs = std::max(1u, std::min(jobs, static_cast<unsigned>(sequences.size())));
+
+    std::vector<FileResult> results(sequences.size());
+    std::atomic<size_t> next{0};
+    std::mutex logMutex;
+
+    const auto wallStart = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned j = 0; j < jobs; ++j) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < sequences.size(); i = next++) {
+                results[i] = evaluate(sequences[i], smoothing, detection);
+                std::lock_guard<std::mutex> lock(logMutex);
+                std::cerr << "[" << i + 1 << "/" << sequences.size() << "] "
+                          << results[i].name << (results[i].ok ? "" : " FAILED") << std::endl;
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    // Per file, then everything pooled
+    FileResult total;
+    int failed = 0;
+    printHeader();
+    for (const auto& r : results) {
+        printRow(r.name, r);
+        if (!r.ok) {
+            ++failed;
+        }
+        total.frames += r.frames;
+        total.valid += r.valid;
+        total.angularError.insert(total.angularError.end(), r.angularError.begin(), r.angularError.end());
+        total.positionError.insert(total.positionError.end(), r.positionError.begin(), r.positionError.end());
+        total.angularJitter.insert(total.angularJitter.end(), r.angularJitter.begin(), r.angularJitter.end());
+        total.positionJitter.insert(total.positionJitter.end(), r.positionJitter.begin(), r.positionJitter.end());
+        total.latencyUs.insert(total.latencyUs.end(), r.latencyUs.begin(), r.latencyUs.end());
+        total.wallSeconds += r.wallSeconds;
+        total.cpuSeconds += r.cpuSeconds;
+    }
+    printRow("ALL (per pipeline)", total);
+
+    // Sum of pipeline wall times over elapsed time: ~jobs when scaling is linear
+    std::printf("%zu files on %u threads in %.2f s: %.1f frames/s overall, speedup %.2fx\n",
+                results.size(), jobs, elapsed,
+                elapsed > 0.0 ? static_cast<double>(total.frames) / elapsed : 0.0,
+                elapsed > 0.0 ? total.wallSeconds / elapsed : 0.0);
+
+    if (!csvPath.empty()) {
+        std::ofstream csv(csvPath);
+        if (!csv) {
+            std::cerr << "Failed to open " << csvPath << std::endl;
+            return 1;
+        }
+        writeCsv(csv, results);
+    }
+
+    const double validShare = total.frames ? static_cast<double>(total.valid) / static_cast<double>(total.frames) : 0.0;
+    if (validShare < minValid) {
+        std::printf("FAILED: %.1f%% of frames tracked, below the required %.1f%%\n", 100.0 * validShare, 100.0 * minValid);
+        return 1;
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+// Renders synthetic sequences to MJPEG videos with their annotations
+int synthesize(const std::string& directory, SyntheticSettings settings, int files) {
+    std::error_code error;
+    fs::create_directories(directory, error);
+
+    settings.paced = false;
+    cv::Mat frame;
+    for (const Sequence& sequence : syntheticDataset(settings, files)) {
+        SyntheticSource source(sequence.synthetic);
+        if (!source.open()) {
+            return 1;
+        }
+
+        const fs::path videoPath = fs::path(directory) / (sequence.name + ".avi");
+        cv::VideoWriter writer(videoPath.string(), cv::VideoWriter::fourcc('M', 'J', 'P', 'G'),
+                               settings.fps, settings.resolution);
+        std::ofstream truth(truthPathFor(videoPath));
+        if (!writer.isOpened() || !truth) {
+            std::cerr << "Failed to write " << videoPath.string() << std::endl;
+            return 1;
+        }
+        truth << "frame,yaw,pitch,roll,x,y,z\n";
+
+        while (source.read(frame)) {
+            writer.write(frame);
+
+            const TruthFrame t = truthFromPose(source.groundTruth(source.frameIndex()));
+            char line[160];
+            std::snprintf(line, sizeof(line), "%d,%.3f,%.3f,%.3f,%.2f,%.2f,%.2f\n", source.frameIndex(),
+                          t.yaw, t.pitch, t.roll, t.x, t.y, t.z);
+            truth << line;
+        }
+        std::cout << "Wrote " << videoPath.string() << std::endl;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    // --synthesize <dir> writes a dataset, --synthetic <mode> evaluates one
+    // in memory, anything else is a dataset directory
+    const bool writeDataset = std::strcmp(argv[1], "--synthesize") == 0;
+    const bool inMemory = std::strcmp(argv[1], "--synthetic") == 0;
+    if ((writeDataset || inMemory) && argc < 3) {
+        printUsage();
+        return 1;
+    }
+
+    SyntheticSettings synthetic;
+    synthetic.paced = false;
+    synthetic.frames = 300;
+    if (inMemory && !htk::input::parseSyntheticMode(argv[2], synthetic)) {
+        return 1;
+    }
+    int files = 4;
+
+    unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+    std::string csvPath;
+    float smoothing = 0.5f;
+    double minValid = 0.0;
+    htk::input::DetectionSettings detection;
+
+    for (int i = (writeDataset || inMemory) ? 3 : 2; i < argc; ++i) {
+        const bool synthesizing = writeDataset || inMemory;
+        if (synthesizing && std::strcmp(argv[i], "--files") == 0 && i + 1 < argc) {
+            files = std::max(1, std::atoi(argv[++i]));
+        } else if (synthesizing && std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            synthetic.frames = std::max(1, std::atoi(argv[++i]));
+        } else if (synthesizing && std::strcmp(argv[i], "--face") == 0 && i + 1 < argc) {
+            synthetic.facePath = argv[++i];
+        } else if (!writeDataset && std::strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            jobs = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        } else if (!writeDataset && std::strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else if (!writeDataset && std::strcmp(argv[i], "--smoothing") == 0 && i + 1 < argc) {
+            smoothing = static_cast<float>(std::atof(argv[++i]));
+        } else if (!writeDataset && std::strcmp(argv[i], "--no-refine") == 0) {
+            detection.refine = false;
+        } else if (!writeDataset && std::strcmp(argv[i], "--no-ensemble") == 0) {
+            detection.ensemble = false;
+        } else if (!writeDataset && std::strcmp(argv[i], "--min-valid") == 0 && i + 1 < argc) {
+            minValid = std::atof(argv[++i]);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (writeDataset) {
+        return synthesize(argv[2], synthetic, files);
+    }
+
+    std::vector<Sequence> sequences;
+    if (inMemory) {
+        sequences = syntheticDataset(synthetic, files);
+    } else if (!loadDataset(argv[1], sequences)) {
+        return 1;
+    }
+    return runEvaluation(sequences, jobs, csvPath, smoothing, detection, minValid);
+}
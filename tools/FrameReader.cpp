@@ -0,0 +1,274 @@
+// htk-frame-reader: connect to htk-core's frame export socket, map the
+// shared frame ring read-only and report delivery latency and drops.
+// Also serves as a reference consumer of the FrameRingFormat.h protocol.
+
+#include "core/FrameRingFormat.h"
+
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace htk::core::framering;
+
+namespace {
+
+struct Ring {
+    const uint8_t* map = nullptr;
+    size_t size = 0;
+    ReaderControl* control = nullptr;
+    size_t controlSize = 0;
+
+    const RingHeader* header() const { return reinterpret_cast<const RingHeader*>(map); }
+};
+
+void printUsage() {
+    std::cerr << "Usage: htk-frame-reader <socket> [--seconds N] [--save <frame.ppm>]\n"
+              << "  Reads frames until N seconds have passed (default 10) and prints\n"
+              << "  capture-to-read and publish-to-read latency percentiles.\n";
+}
+
+uint64_t monotonicMicros() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000ull + static_cast<uint64_t>(ts.tv_nsec) / 1000;
+}
+
+void disconnectRing(Ring& ring) {
+    if (ring.map) {
+        munmap(const_cast<uint8_t*>(ring.map), ring.size);
+    }
+    if (ring.control) {
+        munmap(ring.control, ring.controlSize);
+    }
+    ring = Ring{};
+}
+
+// Receive the ring fd and map it read-only, and the control page
+bool connectRing(const std::string& socketPath, Ring& ring) {
+    const int sock = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        return false;
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    if (::connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(sock);
+        return false;
+    }
+
+    HandshakeMessage message{};
+    iovec iov{&message, sizeof(message)};
+    int fds[2] = {-1, -1};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    const ssize_t received = ::recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    ::close(sock);
+
+    const cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+        std::memcpy(fds, CMSG_DATA(cmsg), std::min(sizeof(fds), cmsg->cmsg_len - CMSG_LEN(0)));
+    }
+    if (received != static_cast<ssize_t>(sizeof(message)) || fds[0] < 0 || fds[1] < 0 ||
+        std::memcmp(message.magic, kMagic, sizeof(kMagic)) != 0) {
+        for (const int fd : fds) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+        return false;  // No ring yet (the tracker hasn't seen a frame), or an older tracker
+    }
+
+    void* map = mmap(nullptr, message.mapSize, PROT_READ, MAP_SHARED, fds[0], 0);
+    void* controlMap = mmap(nullptr, message.controlSize, PROT_READ | PROT_WRITE, MAP_SHARED, fds[1], 0);
+    ::close(fds[0]);  // The mappings keep the memfds alive
+    ::close(fds[1]);
+    if (map == MAP_FAILED || controlMap == MAP_FAILED) {
+        std::cerr << "Failed to map frame ring: " << std::strerror(errno) << std::endl;
+        if (map != MAP_FAILED) {
+            munmap(map, message.mapSize);
+        }
+        if (controlMap != MAP_FAILED) {
+            munmap(controlMap, message.controlSize);
+        }
+        return false;
+    }
+
+    ring.map = static_cast<const uint8_t*>(map);
+    ring.size = message.mapSize;
+    ring.control = static_cast<ReaderControl*>(controlMap);
+    ring.controlSize = message.controlSize;
+    if (ring.header()->version != kVersion || ring.header()->pixelFormat != kPixelFormatBgr8) {
+        std::cerr << "Unsupported frame ring version/format" << std::endl;
+        disconnectRing(ring);
+        return false;
+    }
+    return true;
+}
+
+// The exporter only wakes the futex while someone is counted in waiters
+void waitForFrame(const Ring& ring, uint32_t seen, int timeoutMs) {
+    timespec timeout{timeoutMs / 1000, (timeoutMs % 1000) * 1000000L};
+    ring.control->waiters.fetch_add(1, std::memory_order_seq_cst);
+    syscall(SYS_futex, const_cast<uint32_t*>(reinterpret_cast<const uint32_t*>(&ring.header()->wakeup)),
+            FUTEX_WAIT, seen, &timeout, nullptr, 0);
+    ring.control->waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool savePpm(const std::string& path, const RingHeader* header, const uint8_t* pixels) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    out << "P6\n" << header->width << " " << header->height << "\n255\n";
+    std::vector<uint8_t> row(header->width * 3);
+    for (uint32_t y = 0; y < header->height; ++y) {
+        const uint8_t* bgr = pixels + static_cast<size_t>(y) * header->rowStride;
+        for (uint32_t x = 0; x < header->width; ++x) {
+            row[x * 3 + 0] = bgr[x * 3 + 2];
+            row[x * 3 + 1] = bgr[x * 3 + 1];
+            row[x * 3 + 2] = bgr[x * 3 + 0];
+        }
+        out.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+    }
+    return true;
+}
+
+// Percentile of an unsorted sample set (sorts in place)
+uint64_t percentile(std::vector<uint64_t>& values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    const size_t idx = static_cast<size_t>(p * static_cast<double>(values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + idx, values.end());
+    return values[idx];
+}
+
+void printStat(const char* name, std::vector<uint64_t> values) {
+    std::printf("  %-16s p50 %7llu  p95 %7llu  p99 %7llu  max %7llu us\n", name,
+                static_cast<unsigned long long>(percentile(values, 0.50)),
+                static_cast<unsigned long long>(percentile(values, 0.95)),
+                static_cast<unsigned long long>(percentile(values, 0.99)),
+                static_cast<unsigned long long>(percentile(values, 1.00)));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    const std::string socketPath = argv[1];
+    double seconds = 10.0;
+    std::string savePath;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+            savePath = argv[++i];
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::vector<uint64_t> captureLatency, publishLatency;
+    uint64_t frames = 0, skipped = 0, overwritten = 0, reconnects = 0;
+
+    const uint64_t endUs = monotonicMicros() + static_cast<uint64_t>(seconds * 1e6);
+    Ring ring;
+    uint64_t seen = 0;
+
+    while (monotonicMicros() < endUs) {
+        if (!ring.map) {
+            if (!connectRing(socketPath, ring)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+            seen = ring.header()->published.load(std::memory_order_acquire);
+            std::cout << "Mapped " << ring.header()->width << "x" << ring.header()->height
+                      << " ring, " << ring.header()->slotCount << " slots" << std::endl;
+        }
+
+        const RingHeader* header = ring.header();
+        const uint32_t wakeup = header->wakeup.load(std::memory_order_acquire);
+        if (header->state.load(std::memory_order_acquire) == kStateClosed) {
+            disconnectRing(ring);
+            ++reconnects;
+            continue;
+        }
+
+        const uint64_t published = header->published.load(std::memory_order_acquire);
+        if (published == seen) {
+            waitForFrame(ring, wakeup, 100);
+            continue;
+        }
+
+        // Always the newest frame; anything in between is skipped, not queued
+        const uint64_t n = published - 1;
+        skipped += n - seen;
+        seen = published;
+
+        const uint8_t* slotBase = ring.map + header->slotOffset + (n % header->slotCount) * header->slotStride;
+        const SlotHeader* slot = reinterpret_cast<const SlotHeader*>(slotBase);
+
+        const uint64_t before = slot->sequence.load(std::memory_order_acquire);
+        if (before != 2 * n + 2) {
+            ++overwritten;
+            continue;
+        }
+
+        // The frame is used in place: header fields and pixels straight
+        // from the mapping
+        const uint64_t captureUs = slot->captureUs;
+        const uint64_t publishUs = slot->publishUs;
+        const uint8_t* pixels = slotBase + header->slotHeaderSize;
+        if (!savePath.empty() && savePpm(savePath, header, pixels)) {
+            std::cout << "Saved frame " << n << " to " << savePath << std::endl;
+            savePath.clear();
+        }
+        const uint64_t nowUs = monotonicMicros();
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) != before) {
+            ++overwritten;  // Lapped by the writer while we were reading
+            continue;
+        }
+
+        ++frames;
+        captureLatency.push_back(nowUs - captureUs);
+        publishLatency.push_back(nowUs - publishUs);
+    }
+    disconnectRing(ring);
+
+    std::printf("%llu frames read, %llu skipped (newer frame already published), "
+                "%llu overwritten while reading, %llu reconnects\n",
+                static_cast<unsigned long long>(frames), static_cast<unsigned long long>(skipped),
+                static_cast<unsigned long long>(overwritten), static_cast<unsigned long long>(reconnects));
+    printStat("capture->read", captureLatency);
+    printStat("publish->read", publishLatency);
+    return frames > 0 ? 0 : 1;
+}
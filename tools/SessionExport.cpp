@@ -0,0 +1,151 @@
+// htk-session-export: decode a recorded .htks session to CSV and/or
+// print a latency/jitter summary for offline analysis.
+
+#include "core/SessionReader.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using htk::core::SessionReader;
+using htk::core::SessionSample;
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: htk-session-export <session.htks> [--csv <out.csv>] [--summary]\n"
+              << "  Without options, CSV is written to stdout.\n";
+}
+
+void writeCsvHeader(std::ostream& out) {
+    out << "timestamp_us,dt_us,valid,confidence,yaw,pitch,roll,x,y,z,"
+           "capture_us,detect_us,pose_us,output_us,rect_x,rect_y,rect_w,rect_h\n";
+}
+
+void writeCsvRow(std::ostream& out, const SessionSample& s, uint64_t dt) {
+    char line[320];
+    std::snprintf(line, sizeof(line),
+                  "%llu,%llu,%d,%.3f,%.2f,%.2f,%.2f,%.1f,%.1f,%.1f,%u,%u,%u,%u,%d,%d,%d,%d\n",
+                  static_cast<unsigned long long>(s.data.timestamp),
+                  static_cast<unsigned long long>(dt),
+                  s.data.isValid ? 1 : 0, s.data.confidence,
+                  s.data.yaw, s.data.pitch, s.data.roll,
+                  s.data.x, s.data.y, s.data.z,
+                  s.timing.captureUs, s.timing.detectUs, s.timing.poseUs, s.timing.outputUs,
+                  s.rectX, s.rectY, s.rectW, s.rectH);
+    out << line;
+}
+
+// Percentile of an unsorted sample set (sorts in place)
+uint64_t percentile(std::vector<uint64_t>& values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    const size_t idx = static_cast<size_t>(p * static_cast<double>(values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + idx, values.end());
+    return values[idx];
+}
+
+void printStat(const char* name, std::vector<uint64_t> values) {
+    std::printf("  %-16s p50 %7llu  p95 %7llu  p99 %7llu  max %7llu us\n", name,
+                static_cast<unsigned long long>(percentile(values, 0.50)),
+                static_cast<unsigned long long>(percentile(values, 0.95)),
+                static_cast<unsigned long long>(percentile(values, 0.99)),
+                static_cast<unsigned long long>(percentile(values, 1.00)));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    std::string inputPath = argv[1];
+    std::string csvPath;
+    bool summary = false;
+
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--summary") == 0) {
+            summary = true;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    SessionReader reader;
+    if (!reader.open(inputPath)) {
+        return 1;
+    }
+
+    // CSV goes to stdout unless a file was given or only a summary was asked for
+    std::ofstream csvFile;
+    std::ostream* csv = nullptr;
+    if (!csvPath.empty()) {
+        csvFile.open(csvPath);
+        if (!csvFile) {
+            std::cerr << "Failed to open " << csvPath << std::endl;
+            return 1;
+        }
+        csv = &csvFile;
+    } else if (!summary) {
+        csv = &std::cout;
+    }
+
+    if (csv) {
+        writeCsvHeader(*csv);
+    }
+
+    std::vector<uint64_t> intervals, capture, detect, pose, output;
+    uint64_t samples = 0, valid = 0, first = 0, last = 0;
+
+    SessionSample sample;
+    while (reader.next(sample)) {
+        const uint64_t dt = samples > 0 ? sample.data.timestamp - last : 0;
+        if (samples == 0) {
+            first = sample.data.timestamp;
+        } else {
+            intervals.push_back(dt);
+        }
+        last = sample.data.timestamp;
+        ++samples;
+        valid += sample.data.isValid ? 1 : 0;
+
+        if (csv) {
+            writeCsvRow(*csv, sample, dt);
+        }
+
+        if (summary) {
+            capture.push_back(sample.timing.captureUs);
+            detect.push_back(sample.timing.detectUs);
+            pose.push_back(sample.timing.poseUs);
+            output.push_back(sample.timing.outputUs);
+        }
+    }
+
+    if (summary) {
+        const double seconds = static_cast<double>(last - first) / 1e6;
+        std::printf("%s: %llu samples, %.1f s, %zu bytes (%.1f bytes/sample)\n",
+                    inputPath.c_str(), static_cast<unsigned long long>(samples), seconds,
+                    reader.fileSize(),
+                    samples ? static_cast<double>(reader.fileSize()) / static_cast<double>(samples) : 0.0);
+        std::printf("  valid %.1f%%, mean rate %.1f Hz\n",
+                    samples ? 100.0 * static_cast<double>(valid) / static_cast<double>(samples) : 0.0,
+                    seconds > 0.0 ? static_cast<double>(samples - 1) / seconds : 0.0);
+        printStat("frame interval", intervals);
+        printStat("capture", capture);
+        printStat("detect", detect);
+        printStat("pose", pose);
+        printStat("output", output);
+    }
+
+    return 0;
+}